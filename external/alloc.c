@@ -0,0 +1,151 @@
+/** Arena and pool allocators. */
+
+#include "alloc.h"
+
+//every allocation is aligned for the strictest basic type (max_align_t is C11 only)
+typedef union { long long l; long double d; void* p; void (*f)(); } align_t;
+#define ALIGN 16
+#define ALIGN_UP(n) (((n) + ALIGN-1) & ~(ALIGN-1))
+
+struct ArenaBlock {
+	ArenaBlock* next;
+	size_t size;
+	size_t used;
+	align_t data[];
+};
+
+
+// -------
+// ARENA
+// -------
+
+static ArenaBlock* new_block(size_t n) {
+	ArenaBlock* b = malloc(sizeof(ArenaBlock) + n);
+	if(b == NULL) return NULL;
+	b->next = NULL;
+	b->size = n;
+	b->used = 0;
+	return b;
+}
+
+static void* arena_resize(Allocator* al, void* p, size_t old, size_t n) {
+	Arena* a = (Arena*)al;
+	ArenaBlock* b = a->blocks;
+	//the last allocation can grow/shrink in place
+	if(p != NULL && p == a->last && b != NULL) {
+		size_t start = (char*)p - (char*)b->data;
+		if(n == 0) {
+			b->used = start;
+			a->last = NULL;
+			return NULL;
+		}
+		if(start + ALIGN_UP(n) <= b->size) {
+			b->used = start + ALIGN_UP(n);
+			return p;
+		}
+	}
+	if(n == 0) return NULL;
+
+	void* q = arena_alloc(a, n);
+	if(q != NULL && p != NULL) memcpy(q, p, old < n ? old : n);
+	return q;
+}
+
+void arena_create(Arena* a, size_t blockSize) {
+	*a = (Arena){0};
+	a->allocator.resize = arena_resize;
+	a->blockSize = ALIGN_UP(blockSize > 0 ? blockSize : 64*1024);
+}
+
+void arena_destroy(Arena* a) {
+	for(ArenaBlock* b = a->blocks; b != NULL;) {
+		ArenaBlock* next = b->next;
+		free(b);
+		b = next;
+	}
+	a->blocks = NULL;
+	a->last = NULL;
+}
+
+void arena_reset(Arena* a) {
+	a->last = NULL;
+	if(a->blocks == NULL) return;
+	if(a->blocks->next == NULL) {
+		a->blocks->used = 0;
+		return;
+	}
+	//replace the blocks with one that fits all of them so the next round needs no new blocks
+	size_t total = 0;
+	for(ArenaBlock* b = a->blocks; b != NULL; b = b->next) total += b->size;
+	arena_destroy(a);
+	a->blocks = new_block(total);
+}
+
+void* arena_alloc(Arena* a, size_t n) {
+	n = ALIGN_UP(n > 0 ? n : 1);
+	ArenaBlock* b = a->blocks;
+	if(b == NULL || b->size - b->used < n) {
+		b = new_block(n > a->blockSize ? n : a->blockSize);
+		if(b == NULL) return NULL;
+		b->next = a->blocks;
+		a->blocks = b;
+	}
+	void* p = (char*)b->data + b->used;
+	b->used += n;
+	a->last = p;
+	return p;
+}
+
+
+// -------
+// POOL
+// -------
+
+//size class for a block of `n` bytes (n <= POOL_MAX_SIZE)
+static inline int size_class(size_t n) {
+	int c = 0;
+	for(size_t s = POOL_MIN_SIZE; s < n; s <<= 1) ++c;
+	return c;
+}
+
+static void* pool_resize(Allocator* al, void* p, size_t old, size_t n) {
+	Pool* pool = (Pool*)al;
+	bool pooledOld = p != NULL && old <= POOL_MAX_SIZE, pooledNew = n != 0 && n <= POOL_MAX_SIZE;
+	if(p != NULL && !pooledOld && n > POOL_MAX_SIZE) return realloc(p, n);
+	if(pooledOld && pooledNew && size_class(old) == size_class(n)) return p;
+
+	void* q = NULL;
+	if(pooledNew) {
+		int c = size_class(n);
+		q = pool->free[c];
+		if(q != NULL) pool->free[c] = *(void**)q;
+		else q = arena_alloc(&pool->slabs, (size_t)POOL_MIN_SIZE << c);
+	} else if(n != 0) {
+		q = malloc(n);
+	}
+	if(n != 0 && q == NULL) return NULL;
+
+	if(p != NULL) {
+		if(q != NULL) memcpy(q, p, old < n ? old : n);
+		if(pooledOld) {
+			//freed blocks keep the free list link in their first bytes
+			int c = size_class(old);
+			*(void**)p = pool->free[c];
+			pool->free[c] = p;
+		} else {
+			free(p);
+		}
+	}
+	return q;
+}
+
+void pool_create(Pool* p) {
+	*p = (Pool){0};
+	p->allocator.resize = pool_resize;
+	arena_create(&p->slabs, 256*1024);
+}
+
+void pool_destroy(Pool* p) {
+	arena_destroy(&p->slabs);
+	for(int i=0; i<POOL_CLASS_COUNT; ++i) p->free[i] = NULL;
+}
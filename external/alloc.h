@@ -0,0 +1,64 @@
+/** Allocators that can back the `Array(T)` container. */
+
+#ifndef VEE_ALLOC_H
+#define VEE_ALLOC_H
+
+#include "util.h"
+
+/** Allocator interface. `resize` gets the block `p` of `old` bytes (NULL/0 for a new block)
+ * and returns a block of `n` bytes with the first min(old, n) bytes preserved, or NULL on failure.
+ * A `n` of 0 frees `p`. Unlike the default allocator the memory is not cleared. */
+typedef struct Allocator {
+	void* (*resize)(struct Allocator* a, void* p, size_t old, size_t n);
+} Allocator;
+
+
+// -------
+// ARENA
+// -------
+
+typedef struct ArenaBlock ArenaBlock;
+
+/** Bump allocator for scratch data that is thrown away all at once (e.g. every frame).
+ * Freeing is a no-op except for the last allocation which can also grow in place. */
+typedef struct {
+	Allocator allocator;  //must stay first, pass `&arena.allocator` to Array_create_with()
+	ArenaBlock* blocks;   //newest first
+	size_t blockSize;
+	void* last;           //last allocation, the only one that can be resized in place
+} Arena;
+
+extern void arena_create(Arena* a, size_t blockSize);
+extern void arena_destroy(Arena* a);
+/** Releases everything allocated from the arena. Memory is kept for reuse, spread over
+ * a single block large enough for everything that was allocated before the reset. */
+extern void arena_reset(Arena* a);
+extern void* arena_alloc(Arena* a, size_t n);
+
+
+// -------
+// POOL
+// -------
+
+//blocks are handed out in power of 2 sizes from POOL_MIN_SIZE to POOL_MAX_SIZE bytes
+#define POOL_MIN_SIZE 16
+#define POOL_MAX_SIZE (1024*1024)
+#define POOL_CLASS_COUNT 17
+
+/** Allocator for long lived data. Freed blocks are kept on a free list per size class and
+ * handed out again, so arrays growing and shrinking don't go back to the system allocator.
+ * Blocks larger than POOL_MAX_SIZE come straight from malloc(). It pays off with many small
+ * arrays that come and go, a single big array grows faster with realloc() which can often
+ * extend it in place. */
+typedef struct {
+	Allocator allocator;  //must stay first
+	void* free[POOL_CLASS_COUNT];
+	Arena slabs;          //where the blocks are carved from
+} Pool;
+
+extern void pool_create(Pool* p);
+/** Releases all the memory of the pool. Arrays using it must not be used afterwards,
+ * except arrays holding more than POOL_MAX_SIZE bytes which still need Array_destroy(). */
+extern void pool_destroy(Pool* p);
+
+#endif
@@ -5,11 +5,20 @@
 #include <string.h> //for memmove()
 #include <stdlib.h> //for realloc()/calloc()
 
-int array_reserve__(Array* a, size_t t, size_t n) {
+//Resize the memory of `a` to hold `n` items of size `t` (frees it when `n` is 0).
+static void* resize(Array* a, size_t t, size_t n) {
+	if(a->allocator != NULL) return a->allocator->resize(a->allocator, a->data, a->capacity*t, n*t);
+	if(n == 0) { 
+		free(a->data); 
+		return NULL; 
+	}
+	return (a->data != NULL)?realloc(a->data, t*n):calloc(n, t);
+}
+
+int array_reserve_exact__(Array* a, size_t t, size_t n) {
 	if(a == NULL) return VEE_BAD_ARG;
 	if(n > a->capacity) {
-		n = roundup(n);
-		void* data = (a->data != NULL)?realloc(a->data, t*n):calloc(n, t);
+		void* data = resize(a, t, n);
 		if(data == NULL) return VEE_OUT_OF_MEMORY;
 		a->data = data;
 		a->capacity = n;
@@ -17,6 +26,25 @@ int array_reserve__(Array* a, size_t t, size_t n) {
 	return VEE_OK;
 }
 
+int array_reserve__(Array* a, size_t t, size_t n) {
+	if(a == NULL) return VEE_BAD_ARG;
+	return (n > a->capacity) ? array_reserve_exact__(a, t, roundup(n)) : VEE_OK;
+}
+
+void array_destroy__(Array* a, size_t t) {
+	if(a->data != NULL) resize(a, t, 0);
+	*a = (Array){ .allocator = a->allocator };
+}
+
+void array_compact__(Array* a, size_t t) {
+	if(a->capacity != 0 && a->size != 0 && a->size != a->capacity) {
+		void* data = resize(a, t, a->size);
+		if(data != NULL) { 
+			a->data = data; a->capacity = a->size; 
+		}
+	}
+}
+
 int array_insert__(Array* a, ArrayIt i, size_t t, size_t n) {
 	if(n == 0 || a == NULL) return VEE_BAD_ARG;
 	
@@ -4,12 +4,14 @@
 #define VEE_ARRAY_H
 
 #include "util.h"
+#include "alloc.h"
 
-/** Generic array of type `T` */
+/** Generic array of type `T`. Memory comes from `allocator` or from realloc()/calloc() when NULL. */
 #define Array(T) struct { \
 	T* data; \
 	size_t size; \
 	size_t capacity; \
+	Allocator* allocator; \
 }
 
 
@@ -20,15 +22,23 @@ typedef size_t ArrayIt;
  * Returns VEE_OK[0] on success. */
 #define Array_create(A, N) ({ \
 	int R__ = VEE_OK; \
-	*((Array*)(A)) = (Array){0}; \
+	*(A) = (typeof(*(A))){0}; \
 	R__ = Array_reserve((A), N); \
 	R__; \
 })
 
+/** Same as Array_create() but the memory of array `A` comes from allocator `L`.
+ * Returns VEE_OK[0] on success. */
+#define Array_create_with(A, N, L) ({ \
+	*(A) = (typeof(*(A))){0}; \
+	(A)->allocator = (L); \
+	Array_reserve((A), N); \
+})
+
+extern void array_destroy__(Array*, size_t);
+/** Frees the memory of array `A`. The array keeps its allocator and can be used again. */
 #define Array_destroy(A) ({ \
-	if((A) != NULL) { \
-		free((A)->data); *((Array*)(A)) = (Array){0}; \
-	} \
+	if((A) != NULL) array_destroy__((Array*)(A), sizeof(*(A)->data)); \
 })
 
 extern int array_reserve__(Array*, size_t, size_t);
@@ -36,6 +46,12 @@ extern int array_reserve__(Array*, size_t, size_t);
  * Returns VEE_OK[0] on success. */
 #define Array_reserve(A, N) ( array_reserve__((Array*)(A), sizeof(*(A)->data), N) )
 
+extern int array_reserve_exact__(Array*, size_t, size_t);
+/** Same as Array_reserve() but doesn't round the capacity up to a power of 2. Use it when
+ * the final size is known (e.g. bulk loads) to not waste up to half of the memory.
+ * Returns VEE_OK[0] on success. */
+#define Array_reserve_exact(A, N) ( array_reserve_exact__((Array*)(A), sizeof(*(A)->data), N) )
+
 
 /** Adds the value `V` at the end of the array `A`. 
  * Returns VEE_OK[0] on success. */
@@ -82,14 +98,8 @@ extern size_t array_remove__(Array* , ArrayIt, size_t, size_t);
 
 /** Compact the array `A` so that its size and capacity become the same. This is usefull to 
  * conserve memory when the array is not expected to grow anymore. */
-#define Array_compact(A) ({ \
-	if((A)->capacity != 0 && (A)->size != 0) { \
-		void* T__ = realloc((A)->data, (A)->size*sizeof(*(A)->data)); \
-		if(T__ != NULL) { \
-			(A)->data = T__; (A)->capacity = (A)->size; \
-		} \
-	} \
-})
+extern void array_compact__(Array*, size_t);
+#define Array_compact(A) (array_compact__((Array*)(A), sizeof(*(A)->data)))
 
 /** Returns how many items are in array. */
 #define Array_size(A) ({ \
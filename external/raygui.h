@@ -56,6 +56,12 @@
 *       internally in the library and input management and drawing functions must be provided by
 *       the user (check library implementation for further details).
 *
+*   #define RAYGUI_TEXT_CACHE
+*       Measure and draw the text of the controls with TextCacheWidth() and TextCacheDraw(),
+*       provided by the user, instead of MeasureTextEx() and DrawTextEx(). The element lists
+*       of ToggleGroup, ComboBox and DropdownBox are split by TextCacheSplit() instead of
+*       TextSplitEx(), without its length and element count limits.
+*
 *   VERSIONS HISTORY:
 *       2.0 (xx-Dec-2018) Complete review of new controls, redesigned style system
 *       1.9 (01-May-2018) Lot of rework and redesign! Lots of new controls!
@@ -122,6 +128,12 @@
     #endif
 #elif defined(RAYGUI_STATIC)
     #define RAYGUIDEF static                // Functions just visible to module including this file
+#else
+    #ifdef __cplusplus
+        #define RAYGUIDEF extern "C"        // Only the declarations are needed (implementation lives in another module)
+    #else
+        #define RAYGUIDEF extern
+    #endif
 #endif
 
 #include <stdlib.h>                         // Required for: atoi()
@@ -354,9 +366,14 @@ RAYGUIDEF bool GuiListView(Rectangle bounds, const char **text, int count, int *
 RAYGUIDEF bool GuiListViewEx(Rectangle bounds, const char **text, int *enabledElements, int count, int *scrollIndex, int *active, int *focus, bool editMode); // with List View extended parameters
 RAYGUIDEF Color GuiColorPicker(Rectangle bounds, Color color);                                          // Color Picker control
 RAYGUIDEF bool GuiMessageBox(Rectangle bounds, const char *windowTitle, const char *message);           // Message Box control, displays a message
+RAYGUIDEF Color GuiColorPanel(Rectangle bounds, Color color);                                           // Color Panel control
+RAYGUIDEF float GuiColorBarAlpha(Rectangle bounds, float alpha);                                        // Color Bar Alpha control
+RAYGUIDEF float GuiColorBarHue(Rectangle bounds, float hue);                                            // Color Bar Hue control
+RAYGUIDEF Vector2 GuiGrid(Rectangle bounds, int spacing, int subdivs);                                  // Grid control
 
 // Styles loading functions
 RAYGUIDEF void GuiLoadStyle(const char *fileName);              // Load style file (.rgs)
+RAYGUIDEF bool GuiLoadStyleFromMemory(const unsigned char *data, int size); // Load style from the contents of a style file (.rgs)
 RAYGUIDEF void GuiLoadStyleProps(const int *props, int count);  // Load style from a color palette array (14 values required)
 RAYGUIDEF void GuiLoadStyleDefault(void);                       // Load style default over global style
 RAYGUIDEF void GuiUpdateStyleComplete(void);                    // Updates full style properties set with default values
@@ -380,6 +397,7 @@ RAYGUIDEF void UnloadGuiStyle(GuiStyle style);                  // Unload style
 
 #include <stdio.h>          // Required for: FILE, fopen(), fclose(), fprintf(), feof(), fscanf(), vsprintf()
 #include <string.h>         // Required for: strlen() on GuiTextBox()
+#include <limits.h>         // Required for: INT_MAX on GuiLoadStyle()
 
 #if defined(RAYGUI_STANDALONE)
     #include <stdarg.h>     // Required for: va_list, va_start(), vfprintf(), va_end()
@@ -401,6 +419,8 @@ RAYGUIDEF void UnloadGuiStyle(GuiStyle style);                  // Unload style
 static GuiControlState guiState = GUI_STATE_NORMAL;
 
 static Font guiFont = { 0 };            // NOTE: Highly coupled to raylib
+static bool guiFontOwned = false;       // guiFont was loaded by a style and is unloaded by the next one
+static bool guiFontShapes = false;      // ...and shapes are drawn with its texture
 static bool guiLocked = false;
 static float guiAlpha = 1.0f;
 
@@ -479,12 +499,40 @@ static bool GuiListElement(Rectangle bounds, const char *text, bool active, bool
 static Vector3 ConvertHSVtoRGB(Vector3 hsv);        // Convert color data from HSV to RGB
 static Vector3 ConvertRGBtoHSV(Vector3 rgb);        // Convert color data from RGB to HSV
 
+#if defined(RAYGUI_TEXT_CACHE)
+// Text measuring and drawing with the widths and glyph layouts cached (provided by the application)
+int TextCacheWidth(Font font, const char *text, float fontSize, float spacing);
+void TextCacheDraw(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint);
+#endif
+
+// Elements of a text separated by delimiter, declares elementsCount and the elements for GUI_TEXT_ELEMENT()
+#if defined(RAYGUI_TEXT_CACHE)
+// Split text cached by the application, every element is its own string and there's no limit on their number
+const char **TextCacheSplit(const char *text, char delimiter, int *count);
+
+#define GUI_TEXT_SPLIT(text, delimiter, maxElements) \
+    int elementsCount = 0; \
+    const char **elementsText = TextCacheSplit(text, delimiter, &elementsCount)
+#define GUI_TEXT_ELEMENT(i) (elementsText[i])
+#else
+#define GUI_TEXT_SPLIT(text, delimiter, maxElements) \
+    const char *elementsPtrs[maxElements] = { NULL }; \
+    int elementsLen[maxElements] = { 0 }; \
+    int elementsCount = 0; \
+    TextSplitEx(text, delimiter, &elementsCount, elementsPtrs, elementsLen)
+#define GUI_TEXT_ELEMENT(i) TextSubtext(elementsPtrs[i], 0, elementsLen[i])
+#endif
+
 // Gui draw text using default font
 static void GuiDrawText(const char *text, int posX, int posY, Color tint)
 {
     if (guiFont.texture.id == 0) guiFont = GetFontDefault();
 
+#if defined(RAYGUI_TEXT_CACHE)
+    TextCacheDraw(guiFont, text, (Vector2){ posX, posY }, GuiGetStyle(DEFAULT, TEXT_SIZE), GuiGetStyle(DEFAULT, TEXT_SPACING), tint);
+#else
     DrawTextEx(guiFont, text, (Vector2){ posX, posY }, GuiGetStyle(DEFAULT, TEXT_SIZE), GuiGetStyle(DEFAULT, TEXT_SPACING), tint);
+#endif
 }
 
 // Gui get text width using default font
@@ -492,9 +540,13 @@ static int GuiTextWidth(const char *text)
 {
     if (guiFont.texture.id == 0) guiFont = GetFontDefault();
 
+#if defined(RAYGUI_TEXT_CACHE)
+    return TextCacheWidth(guiFont, text, GuiGetStyle(DEFAULT, TEXT_SIZE), GuiGetStyle(DEFAULT, TEXT_SPACING));
+#else
     Vector2 size = MeasureTextEx(guiFont, text, GuiGetStyle(DEFAULT, TEXT_SIZE), GuiGetStyle(DEFAULT, TEXT_SPACING));
 
     return (int)size.x;
+#endif
 }
 
 //----------------------------------------------------------------------------------
@@ -1111,15 +1163,12 @@ RAYGUIDEF int GuiToggleGroupEx(Rectangle bounds, const char *text, int active, i
     int currentColumn = 0;
 
     // Get substrings elements from text (elements pointers, lengths and count)
-    const char *elementsPtrs[TOGGLEGROUP_MAX_ELEMENTS] = { NULL };
-    int elementsLen[TOGGLEGROUP_MAX_ELEMENTS] = { 0 };
-    int elementsCount = 0;
-    TextSplitEx(text, TOGGLEGROUP_ELEMENTS_DELIMITER, &elementsCount, elementsPtrs, elementsLen);
+    GUI_TEXT_SPLIT(text, TOGGLEGROUP_ELEMENTS_DELIMITER, TOGGLEGROUP_MAX_ELEMENTS);
 
     for (int i = 0; i < elementsCount; i++)
     {
-        if (i == active) GuiToggle(bounds, TextSubtext(elementsPtrs[i], 0, elementsLen[i]), true);
-        else if (GuiToggle(bounds, TextSubtext(elementsPtrs[i], 0, elementsLen[i]), false) == true) active = i;
+        if (i == active) GuiToggle(bounds, GUI_TEXT_ELEMENT(i), true);
+        else if (GuiToggle(bounds, GUI_TEXT_ELEMENT(i), false) == true) active = i;
 
         bounds.x += (bounds.width + padding);
         currentColumn++;
@@ -1227,15 +1276,12 @@ RAYGUIDEF int GuiComboBox(Rectangle bounds, const char *text, int active)
                            bounds.y, GuiGetStyle(COMBOBOX, SELECTOR_WIDTH), bounds.height };
 
     // Get substrings elements from text (elements pointers, lengths and count)
-    const char *elementsPtrs[COMBOBOX_MAX_ELEMENTS] = { NULL };
-    int elementsLen[COMBOBOX_MAX_ELEMENTS] = { 0 };
-    int elementsCount = 0;
-    TextSplitEx(text, COMBOBOX_ELEMENTS_DELIMITER, &elementsCount, elementsPtrs, elementsLen);
+    GUI_TEXT_SPLIT(text, COMBOBOX_ELEMENTS_DELIMITER, COMBOBOX_MAX_ELEMENTS);
 
     if (active < 0) active = 0;
     else if (active > elementsCount - 1) active = elementsCount - 1;
 
-    int textWidth = GuiTextWidth(TextSubtext(elementsPtrs[active], 0, elementsLen[active]));
+    int textWidth = GuiTextWidth(GUI_TEXT_ELEMENT(active));
     int textHeight = GuiGetStyle(DEFAULT, TEXT_SIZE);
 
     if (bounds.width < textWidth) bounds.width = textWidth;
@@ -1276,7 +1322,7 @@ RAYGUIDEF int GuiComboBox(Rectangle bounds, const char *text, int active)
             DrawRectangleLinesEx(selector, GuiGetStyle(COMBOBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(COMBOBOX, BORDER_COLOR_NORMAL)), guiAlpha));
             DrawRectangle(selector.x + GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.y + GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.width - 2*GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.height - 2*GuiGetStyle(COMBOBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(COMBOBOX, BASE_COLOR_NORMAL)), guiAlpha));
 
-            GuiDrawText(TextSubtext(elementsPtrs[active], 0, elementsLen[active]), bounds.x + bounds.width/2 - textWidth/2, bounds.y + bounds.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_NORMAL)), guiAlpha));
+            GuiDrawText(GUI_TEXT_ELEMENT(active), bounds.x + bounds.width/2 - textWidth/2, bounds.y + bounds.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_NORMAL)), guiAlpha));
             GuiDrawText(TextFormat("%i/%i", active + 1, elementsCount), selector.x + selector.width/2 - GuiTextWidth(TextFormat("%i/%i", active + 1, elementsCount))/2, selector.y + selector.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_NORMAL)), guiAlpha));
         } break;
         case GUI_STATE_FOCUSED:
@@ -1287,7 +1333,7 @@ RAYGUIDEF int GuiComboBox(Rectangle bounds, const char *text, int active)
             DrawRectangleLinesEx(selector, GuiGetStyle(COMBOBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(COMBOBOX, BORDER_COLOR_FOCUSED)), guiAlpha));
             DrawRectangle(selector.x + GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.y + GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.width - 2*GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.height - 2*GuiGetStyle(COMBOBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(COMBOBOX, BASE_COLOR_FOCUSED)), guiAlpha));
 
-            GuiDrawText(TextSubtext(elementsPtrs[active], 0, elementsLen[active]), bounds.x + bounds.width/2 - textWidth/2, bounds.y + bounds.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_FOCUSED)), guiAlpha));
+            GuiDrawText(GUI_TEXT_ELEMENT(active), bounds.x + bounds.width/2 - textWidth/2, bounds.y + bounds.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_FOCUSED)), guiAlpha));
             GuiDrawText(TextFormat("%i/%i", active + 1, elementsCount), selector.x + selector.width/2 - GuiTextWidth(TextFormat("%i/%i", active + 1, elementsCount))/2, selector.y + selector.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_FOCUSED)), guiAlpha));
         } break;
         case GUI_STATE_PRESSED:
@@ -1298,7 +1344,7 @@ RAYGUIDEF int GuiComboBox(Rectangle bounds, const char *text, int active)
             DrawRectangleLinesEx(selector, GuiGetStyle(COMBOBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(COMBOBOX, BORDER_COLOR_PRESSED)), guiAlpha));
             DrawRectangle(selector.x + GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.y + GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.width - 2*GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.height - 2*GuiGetStyle(COMBOBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(COMBOBOX, BASE_COLOR_PRESSED)), guiAlpha));
 
-            GuiDrawText(TextSubtext(elementsPtrs[active], 0, elementsLen[active]), bounds.x + bounds.width/2 - textWidth/2, bounds.y + bounds.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_PRESSED)), guiAlpha));
+            GuiDrawText(GUI_TEXT_ELEMENT(active), bounds.x + bounds.width/2 - textWidth/2, bounds.y + bounds.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_PRESSED)), guiAlpha));
             GuiDrawText(TextFormat("%i/%i", active + 1, elementsCount), selector.x + selector.width/2 - GuiTextWidth(TextFormat("%i/%i", active + 1, elementsCount))/2, selector.y + selector.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_PRESSED)), guiAlpha));
         } break;
         case GUI_STATE_DISABLED:
@@ -1309,7 +1355,7 @@ RAYGUIDEF int GuiComboBox(Rectangle bounds, const char *text, int active)
             DrawRectangleLinesEx(selector, GuiGetStyle(COMBOBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(COMBOBOX, BORDER_COLOR_DISABLED)), guiAlpha));
             DrawRectangle(selector.x + GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.y + GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.width - 2*GuiGetStyle(COMBOBOX, BORDER_WIDTH), selector.height - 2*GuiGetStyle(COMBOBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(COMBOBOX, BASE_COLOR_DISABLED)), guiAlpha));
 
-            GuiDrawText(TextSubtext(elementsPtrs[active], 0, elementsLen[active]), bounds.x + bounds.width/2 - textWidth/2, bounds.y + bounds.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_DISABLED)), guiAlpha));
+            GuiDrawText(GUI_TEXT_ELEMENT(active), bounds.x + bounds.width/2 - textWidth/2, bounds.y + bounds.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_DISABLED)), guiAlpha));
             GuiDrawText(TextFormat("%i/%i", active + 1, elementsCount), selector.x + selector.width/2 - GuiTextWidth(TextFormat("%i/%i", active + 1, elementsCount))/2, selector.y + selector.height/2 - GuiGetStyle(DEFAULT, TEXT_SIZE)/2 + VALIGN_OFFSET(bounds.height), Fade(GetColor(GuiGetStyle(COMBOBOX, TEXT_COLOR_DISABLED)), guiAlpha));
         } break;
         default: break;
@@ -1328,14 +1374,11 @@ RAYGUIDEF bool GuiDropdownBox(Rectangle bounds, const char *text, int *active, b
     GuiControlState state = guiState;
 
     // Get substrings elements from text (elements pointers, lengths and count)
-    const char *elementsPtrs[DROPDOWNBOX_MAX_ELEMENTS] = { NULL };
-    int elementsLen[DROPDOWNBOX_MAX_ELEMENTS] = { 0 };
-    int elementsCount = 0;
-    TextSplitEx(text, DROPDOWNBOX_ELEMENTS_DELIMITER, &elementsCount, elementsPtrs, elementsLen);
+    GUI_TEXT_SPLIT(text, DROPDOWNBOX_ELEMENTS_DELIMITER, DROPDOWNBOX_MAX_ELEMENTS);
 
     bool pressed = false;
     int auxActive = *active;
-    int textWidth = GuiTextWidth(TextSubtext(elementsPtrs[auxActive], 0, elementsLen[auxActive]));
+    int textWidth = GuiTextWidth(GUI_TEXT_ELEMENT(auxActive));
     int textHeight = GuiGetStyle(DEFAULT, TEXT_SIZE);
 
     if (bounds.width < textWidth) bounds.width = textWidth;
@@ -1388,7 +1431,7 @@ RAYGUIDEF bool GuiDropdownBox(Rectangle bounds, const char *text, int *active, b
         {
             DrawRectangle(bounds.x, bounds.y, bounds.width, bounds.height, Fade(GetColor(GuiGetStyle(DEFAULT, BASE_COLOR_NORMAL)), guiAlpha));
             DrawRectangleLinesEx(bounds, GuiGetStyle(DROPDOWNBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(LISTVIEW, BORDER_COLOR_NORMAL)), guiAlpha));
-            GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, TextSubtext(elementsPtrs[auxActive], 0, elementsLen[auxActive]), false, false);
+            GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, GUI_TEXT_ELEMENT(auxActive), false, false);
 
             DrawTriangle((Vector2){ bounds.x + bounds.width - GuiGetStyle(DROPDOWNBOX, ARROW_RIGHT_PADDING), bounds.y + bounds.height/2 - 2 },
                          (Vector2){ bounds.x + bounds.width - GuiGetStyle(DROPDOWNBOX, ARROW_RIGHT_PADDING) + 5, bounds.y + bounds.height/2 - 2 + 5 },
@@ -1396,7 +1439,7 @@ RAYGUIDEF bool GuiDropdownBox(Rectangle bounds, const char *text, int *active, b
         } break;
         case GUI_STATE_FOCUSED:
         {
-            GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, TextSubtext(elementsPtrs[auxActive], 0, elementsLen[auxActive]), false, editMode);
+            GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, GUI_TEXT_ELEMENT(auxActive), false, editMode);
 
             DrawTriangle((Vector2){ bounds.x + bounds.width - GuiGetStyle(DROPDOWNBOX, ARROW_RIGHT_PADDING), bounds.y + bounds.height/2 - 2 },
                          (Vector2){ bounds.x + bounds.width - GuiGetStyle(DROPDOWNBOX, ARROW_RIGHT_PADDING) + 5, bounds.y + bounds.height/2 - 2 + 5 },
@@ -1405,22 +1448,22 @@ RAYGUIDEF bool GuiDropdownBox(Rectangle bounds, const char *text, int *active, b
         case GUI_STATE_PRESSED:
         {
 
-            if (!editMode) GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, TextSubtext(elementsPtrs[auxActive], 0, elementsLen[auxActive]), true, true);
+            if (!editMode) GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, GUI_TEXT_ELEMENT(auxActive), true, true);
             if (editMode)
             {
                 GuiPanel(openBounds);
 
-                GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, TextSubtext(elementsPtrs[auxActive], 0, elementsLen[auxActive]), true, true);
+                GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, GUI_TEXT_ELEMENT(auxActive), true, true);
 
                 for (int i = 0; i < elementsCount; i++)
                 {
                     if (i == auxActive && editMode)
                     {
-                        if (GuiListElement((Rectangle){ bounds.x, bounds.y + bounds.height*(i+1) + GuiGetStyle(DROPDOWNBOX, INNER_PADDING), bounds.width, bounds.height - GuiGetStyle(DROPDOWNBOX, INNER_PADDING) }, TextSubtext(elementsPtrs[i], 0, elementsLen[i]), true, true) == false) pressed = true; //auxActive = i;
+                        if (GuiListElement((Rectangle){ bounds.x, bounds.y + bounds.height*(i+1) + GuiGetStyle(DROPDOWNBOX, INNER_PADDING), bounds.width, bounds.height - GuiGetStyle(DROPDOWNBOX, INNER_PADDING) }, GUI_TEXT_ELEMENT(i), true, true) == false) pressed = true; //auxActive = i;
                     }
                     else
                     {
-                        if (GuiListElement((Rectangle){ bounds.x, bounds.y + bounds.height*(i+1) + GuiGetStyle(DROPDOWNBOX, INNER_PADDING), bounds.width, bounds.height - GuiGetStyle(DROPDOWNBOX, INNER_PADDING) }, TextSubtext(elementsPtrs[i], 0, elementsLen[i]), false, true))
+                        if (GuiListElement((Rectangle){ bounds.x, bounds.y + bounds.height*(i+1) + GuiGetStyle(DROPDOWNBOX, INNER_PADDING), bounds.width, bounds.height - GuiGetStyle(DROPDOWNBOX, INNER_PADDING) }, GUI_TEXT_ELEMENT(i), false, true))
                         {
                             auxActive = i;
                             pressed = true;
@@ -1437,7 +1480,7 @@ RAYGUIDEF bool GuiDropdownBox(Rectangle bounds, const char *text, int *active, b
         {
             DrawRectangle(bounds.x, bounds.y, bounds.width, bounds.height, Fade(GetColor(GuiGetStyle(DEFAULT, BASE_COLOR_DISABLED)), guiAlpha));
             DrawRectangleLinesEx(bounds, GuiGetStyle(DROPDOWNBOX, BORDER_WIDTH), Fade(GetColor(GuiGetStyle(LISTVIEW, BORDER_COLOR_DISABLED)), guiAlpha));
-            GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, TextSubtext(elementsPtrs[auxActive], 0, elementsLen[auxActive]), false, false);
+            GuiListElement((Rectangle){ bounds.x, bounds.y, bounds.width, bounds.height }, GUI_TEXT_ELEMENT(auxActive), false, false);
 
             DrawTriangle((Vector2){ bounds.x + bounds.width - GuiGetStyle(DROPDOWNBOX, ARROW_RIGHT_PADDING), bounds.y + bounds.height/2 - 2 },
                          (Vector2){ bounds.x + bounds.width - GuiGetStyle(DROPDOWNBOX, ARROW_RIGHT_PADDING) + 5, bounds.y + bounds.height/2 - 2 + 5 },
@@ -1784,7 +1827,7 @@ RAYGUIDEF bool GuiTextBoxMulti(Rectangle bounds, char *text, int textSize, bool
                         textHasChange = true;
                     }
                 }
-                else if (GuiTextWidth(strrchr(text, '\n')) < (maxWidth - GuiGetStyle(DEFAULT, TEXT_SIZE)))
+                else if (GuiTextWidth((strrchr(text, '\n') != NULL) ? strrchr(text, '\n') : text) < (maxWidth - GuiGetStyle(DEFAULT, TEXT_SIZE)))
                 {
                     if (((key >= 32) && (key <= 125)) ||
                         ((key >= 128) && (key < 255)))
@@ -2881,97 +2924,167 @@ RAYGUIDEF Vector2 GuiGrid(Rectangle bounds, int spacing, int subdivs)
     return currentCell;
 }
 
-// Load raygui style file (.rgs)
+// Load raygui style file (.rgs), the whole file is read at once
 RAYGUIDEF void GuiLoadStyle(const char *fileName)
 {
     FILE *rgsFile = fopen(fileName, "rb");
 
     if (rgsFile != NULL)
     {
-        unsigned int value = 0;
+        fseek(rgsFile, 0, SEEK_END);
+        long size = ftell(rgsFile);
+        fseek(rgsFile, 0, SEEK_SET);
 
-        char signature[5] = "";
-        short version = 0;
-        short numControls = 0;
-        short numPropsDefault = 0;
-        short numPropsExtended = 0;
+        unsigned char *data = ((size > 0) && (size <= INT_MAX))? (unsigned char *)malloc(size) : NULL;
 
-        fread(signature, 1, 4, rgsFile);
-        fread(&version, 1, sizeof(short), rgsFile);
-        fread(&numControls, 1, sizeof(short), rgsFile);
-        fread(&numPropsDefault, 1, sizeof(short), rgsFile);
-        fread(&numPropsExtended, 1, sizeof(short), rgsFile);
+        if ((data != NULL) && (fread(data, 1, size, rgsFile) == (size_t)size)) GuiLoadStyleFromMemory(data, (int)size);
+        else TraceLog(LOG_WARNING, "[raygui] Failed to read style properties file");
 
-        if ((signature[0] == 'r') &&
-            (signature[1] == 'G') &&
-            (signature[2] == 'S') &&
-            (signature[3] == ' '))
-        {
-            for (int i = 0; i < NUM_CONTROLS; i++)
-            {
-                for (int j = 0; j < NUM_PROPS_DEFAULT + NUM_PROPS_EXTENDED; j++)
-                {
-                    fread(&value, 1, sizeof(unsigned int), rgsFile);
-                    GuiSetStyle(i, j, value);
-                }
-            }
+        free(data);
+        fclose(rgsFile);
+    }
+}
 
-            // Load custom font if available
-            int fontDataSize = 0;
-            fwrite(&fontDataSize, 1, sizeof(int), rgsFile);
+// Take the next `size` bytes of style data, false when there are not that many left
+static bool GuiStyleData(const unsigned char **data, int *remaining, void *out, int size)
+{
+    if ((size < 0) || (*remaining < size)) return false;
 
-            if (fontDataSize > 0)
-            {
-                Font font = { 0 };
-                int fontType = 0;   // 0-Normal, 1-SDF
-                Rectangle whiteRec = { 0 };
+    if (out != NULL) memcpy(out, *data, size);
+    *data += size;
+    *remaining -= size;
 
-                fread(&font.baseSize, 1, sizeof(int), rgsFile);
-                fread(&font.charsCount, 1, sizeof(int), rgsFile);
-                fread(&fontType, 1, sizeof(int), rgsFile);
+    return true;
+}
 
-                // Load font white rectangle
-                fread(&whiteRec, 1, sizeof(Rectangle), rgsFile);
+// Load style from the contents of a style file (.rgs), nothing is changed when it is not valid
+// NOTE: Properties are copied over the global style at once, a custom font replaces the one
+// loaded by the previous style
+RAYGUIDEF bool GuiLoadStyleFromMemory(const unsigned char *data, int size)
+{
+    const int propsSize = NUM_CONTROLS*(NUM_PROPS_DEFAULT + NUM_PROPS_EXTENDED)*sizeof(unsigned int);
 
-                // Load font image parameters
-                int fontImageSize = 0;
-                fread(&fontImageSize, 1, sizeof(int), rgsFile);
+    const unsigned char *at = data;
+    int remaining = (data != NULL)? size : 0;
 
-                if (fontImageSize > 0)
-                {
-                    Image imFont = { 0 };
-                    imFont.mipmaps = 1;
-                    fread(&imFont.width, 1, sizeof(int), rgsFile);
-                    fread(&imFont.height, 1, sizeof(int), rgsFile);
-                    fread(&imFont.format, 1, sizeof(int), rgsFile);
-                    fread(&imFont.data, 1, fontImageSize, rgsFile);
-
-                    font.texture = LoadTextureFromImage(imFont);
-                    UnloadImage(imFont);
-                }
+    char signature[4] = { 0 };
+    short header[4] = { 0 };        // version, controls, default and extended properties
+    const unsigned char *props = NULL;
 
-                // Load font chars data
-                font.chars = (CharInfo *)calloc(font.charsCount, sizeof(CharInfo));
-                for (int i = 0; i < font.charsCount; i++)
-                {
-                    fread(&font.chars[i].rec, 1, sizeof(Rectangle), rgsFile);
-                    fread(&font.chars[i].value, 1, sizeof(int), rgsFile);
-                    fread(&font.chars[i].offsetX, 1, sizeof(int), rgsFile);
-                    fread(&font.chars[i].offsetY, 1, sizeof(int), rgsFile);
-                    fread(&font.chars[i].advanceX, 1, sizeof(int), rgsFile);
-                }
+    bool valid = GuiStyleData(&at, &remaining, signature, 4) && (memcmp(signature, "rGS ", 4) == 0) &&
+        GuiStyleData(&at, &remaining, header, sizeof(header)) &&
+        (header[1] == NUM_CONTROLS) && (header[2] == NUM_PROPS_DEFAULT) && (header[3] == NUM_PROPS_EXTENDED);
+
+    if (valid)
+    {
+        props = at;
+        valid = GuiStyleData(&at, &remaining, NULL, propsSize);
+    }
 
-                GuiFont(font);
+    // Custom font, checked completely before anything is loaded
+    int fontDataSize = 0;
+    Font font = { 0 };
+    int fontType = 0;   // 0-Normal, 1-SDF
+    Rectangle whiteRec = { 0 };
+    int fontImageSize = 0;
+    Image imFont = { 0 };
+    const unsigned char *imData = NULL;
+    const unsigned char *chars = NULL;
+    const int charSize = sizeof(Rectangle) + 4*sizeof(int);
 
-                // Set font texture source rectangle to be used as white texture to draw shapes
-                // NOTE: This way, all gui can be draw using a single draw call
-                if ((whiteRec.width != 0) && (whiteRec.height != 0)) SetShapesTexture(font.texture, whiteRec);
+    if (valid && (remaining > 0)) valid = GuiStyleData(&at, &remaining, &fontDataSize, sizeof(int));
+
+    if (valid && (fontDataSize > 0))
+    {
+        valid = GuiStyleData(&at, &remaining, &font.baseSize, sizeof(int)) &&
+            GuiStyleData(&at, &remaining, &font.charsCount, sizeof(int)) &&
+            GuiStyleData(&at, &remaining, &fontType, sizeof(int)) &&
+            GuiStyleData(&at, &remaining, &whiteRec, sizeof(Rectangle)) &&
+            GuiStyleData(&at, &remaining, &fontImageSize, sizeof(int));
+
+        if (valid && (fontImageSize > 0))
+        {
+            imFont.mipmaps = 1;
+            valid = GuiStyleData(&at, &remaining, &imFont.width, sizeof(int)) &&
+                GuiStyleData(&at, &remaining, &imFont.height, sizeof(int)) &&
+                GuiStyleData(&at, &remaining, &imFont.format, sizeof(int));
+
+            imData = at;
+            valid = valid && GuiStyleData(&at, &remaining, NULL, fontImageSize);
+        }
+
+        chars = at;
+        valid = valid && (font.charsCount > 0) && (font.charsCount <= remaining/charSize);
+    }
+
+    if (!valid)
+    {
+        TraceLog(LOG_WARNING, "[raygui] Invalid style properties file");
+        return false;
+    }
+
+    memcpy(guiStyle, props, propsSize);
+    guiStyleLoaded = true;
+
+    // The font of the previous style (if any) and the shapes texture that was taken from it go away
+    if (guiFontOwned)
+    {
+        if (guiFontShapes) SetShapesTexture(GetTextureDefault(), (Rectangle){ 0, 0, 1, 1 });
+        UnloadTexture(guiFont.texture);
+        free(guiFont.chars);
+        guiFont = GetFontDefault();
+        guiFontOwned = false;
+        guiFontShapes = false;
+    }
+
+    if (fontDataSize > 0)
+    {
+        if (imData != NULL)
+        {
+            imFont.data = malloc(fontImageSize);
+
+            if (imFont.data != NULL)
+            {
+                memcpy(imFont.data, imData, fontImageSize);
+                font.texture = LoadTextureFromImage(imFont);
+                UnloadImage(imFont);
             }
         }
-        else TraceLog(LOG_WARNING, "[raygui] Invalid style properties file");
 
-        fclose(rgsFile);
+        // Load font chars data
+        font.chars = (CharInfo *)calloc(font.charsCount, sizeof(CharInfo));
+
+        if ((font.chars != NULL) && (font.texture.id != 0))
+        {
+            for (int i = 0; i < font.charsCount; i++, chars += charSize)
+            {
+                memcpy(&font.chars[i].rec, chars, sizeof(Rectangle));
+                memcpy(&font.chars[i].value, chars + sizeof(Rectangle), sizeof(int));
+                memcpy(&font.chars[i].offsetX, chars + sizeof(Rectangle) + sizeof(int), sizeof(int));
+                memcpy(&font.chars[i].offsetY, chars + sizeof(Rectangle) + 2*sizeof(int), sizeof(int));
+                memcpy(&font.chars[i].advanceX, chars + sizeof(Rectangle) + 3*sizeof(int), sizeof(int));
+            }
+
+            GuiFont(font);
+            guiFontOwned = true;
+
+            // Set font texture source rectangle to be used as white texture to draw shapes
+            // NOTE: This way, all gui can be draw using a single draw call
+            if ((whiteRec.width != 0) && (whiteRec.height != 0))
+            {
+                SetShapesTexture(font.texture, whiteRec);
+                guiFontShapes = true;
+            }
+        }
+        else
+        {
+            TraceLog(LOG_WARNING, "[raygui] Failed to load style font");
+            if (font.texture.id != 0) UnloadTexture(font.texture);
+            free(font.chars);
+        }
     }
+
+    return true;
 }
 
 // Load style from a palette values array
@@ -28,7 +28,7 @@ void print_backtrace() { }
 inline uint32_t fnv32_1a(char* p, size_t sz) {
     uint32_t hash = FNV32_OFFSET;
     for(const char* end = &p[sz]; end != p; ++p)
-        hash = (*p ^ hash) * FNV32_PRIME;
+        hash = ((uint8_t)*p ^ hash) * FNV32_PRIME;
     return hash;
 }
 
@@ -36,7 +36,7 @@ inline uint32_t fnv32_1a(char* p, size_t sz) {
 inline uint64_t fnv64_1a(char* p, size_t sz) {
     uint64_t hash = FNV64_OFFSET;
     for(const char* end = &p[sz]; end != p; ++p)
-        hash = (*p ^ hash) * FNV64_PRIME;
+        hash = ((uint8_t)*p ^ hash) * FNV64_PRIME;
     return hash;
 }
 
@@ -92,6 +92,8 @@ enum {
 	VEE_NOT_FOUND,
 	VEE_OUT_OF_BOUNDS,
 	VEE_BAD_ARG,
+	VEE_IO_ERROR,
+	VEE_BAD_FORMAT,
 };
 
 // Macros used when generating names for generic constructs
@@ -129,6 +131,41 @@ enum {
 extern uint32_t fnv32_1a(char*, size_t);
 extern uint64_t fnv64_1a(char*, size_t);
 
+
+// -------
+// BYTE ORDER
+// -------
+
+/* Little-endian encoding/decoding, works the same on any host byte order. */
+static inline void put_u16le(uint8_t* p, uint16_t v) {
+	p[0] = v; p[1] = v >> 8;
+}
+
+static inline void put_u32le(uint8_t* p, uint32_t v) {
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static inline void put_f32le(uint8_t* p, float f) {
+	uint32_t v;
+	memcpy(&v, &f, sizeof(v));
+	put_u32le(p, v);
+}
+
+static inline uint16_t get_u16le(const uint8_t* p) {
+	return (uint16_t)p[0] | (uint16_t)p[1] << 8;
+}
+
+static inline uint32_t get_u32le(const uint8_t* p) {
+	return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline float get_f32le(const uint8_t* p) {
+	uint32_t v = get_u32le(p);
+	float f;
+	memcpy(&f, &v, sizeof(f));
+	return f;
+}
+
 /*
 #define set_error(fmt, ...) set_error__(fmt " in " __FUNCTION__ ":"__LINE__" -> `"__FILE__"`" , ##__VA_ARGS__)
 
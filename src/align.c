@@ -0,0 +1,284 @@
+#include "align.h"
+#include "profile.h"
+#include <math.h>
+
+static inline void LinesOf(Rectangle r, float out[ALIGN_LINE_COUNT]) {
+	if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+	if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+	out[ALIGN_LEFT] = r.x;
+	out[ALIGN_CENTER_X] = r.x + r.width/2;
+	out[ALIGN_RIGHT] = r.x + r.width;
+	out[ALIGN_TOP] = r.y;
+	out[ALIGN_CENTER_Y] = r.y + r.height/2;
+	out[ALIGN_BOTTOM] = r.y + r.height;
+}
+
+static inline bool Before(AlignEntry a, AlignEntry b) {
+	return a.at < b.at || (a.at == b.at && a.index < b.index);
+}
+
+static int CompareEntries(const void* a, const void* b) {
+	AlignEntry x = *(const AlignEntry*)a, y = *(const AlignEntry*)b;
+	return Before(x, y) ? -1 : Before(y, x) ? 1 : 0;
+}
+
+//first position whose entry isn't before `e`
+static size_t LowerBound(const ArrayAlignEntry* l, AlignEntry e) {
+	size_t lo = 0, hi = Array_size(l);
+	while(lo < hi) {
+		size_t mid = lo + (hi - lo)/2;
+		if(Before(Array_at(l, mid), e)) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+static inline bool Found(const ArrayAlignEntry* l, size_t p, AlignEntry e) {
+	return p < Array_size(l) && Array_at(l, p).at == e.at && Array_at(l, p).index == e.index;
+}
+
+//Move the entry `from` to where `to` goes, shifting only the entries in between
+static void MoveEntry(ArrayAlignEntry* l, AlignEntry from, AlignEntry to) {
+	size_t p = LowerBound(l, from), q = LowerBound(l, to);
+	if(!Found(l, p, from)) return;
+	AlignEntry* d = Array_data(l);
+	if(q > p) {
+		--q; //`from` is gone from before it
+		memmove(&d[p], &d[p+1], (q-p)*sizeof(AlignEntry));
+	} else {
+		memmove(&d[q+1], &d[q], (p-q)*sizeof(AlignEntry));
+	}
+	d[q] = to;
+}
+
+void AlignIndexCreate(AlignIndex* a, Allocator* allocator) {
+	*a = (AlignIndex){0};
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) a->lines[i].allocator = allocator;
+}
+
+void AlignIndexDestroy(AlignIndex* a) {
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) Array_destroy(&a->lines[i]);
+}
+
+void AlignIndexClear(AlignIndex* a) {
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) a->lines[i].size = 0;
+}
+
+void AlignIndexRebuild(AlignIndex* a, const ArrayWidget* w) {
+	AlignIndexClear(a);
+	size_t n = Array_size(w);
+	if(n == 0) return;
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) {
+		if(Array_reserve(&a->lines[i], n) != VEE_OK) {
+			AlignIndexClear(a);
+			return;
+		}
+	}
+	for(size_t j=0; j<n; ++j) {
+		float lines[ALIGN_LINE_COUNT];
+		LinesOf(Array_at(w, j).bounds, lines);
+		for(int i=0; i<ALIGN_LINE_COUNT; ++i) Array_at(&a->lines[i], j) = (AlignEntry){ lines[i], (int)j };
+	}
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) {
+		a->lines[i].size = n;
+		qsort(Array_data(&a->lines[i]), n, sizeof(AlignEntry), CompareEntries);
+	}
+}
+
+static inline bool Masked(const uint64_t* mask, size_t maskWords, int index) {
+	size_t i = (size_t)index/64;
+	return i < maskWords && ((mask[i] >> (index%64)) & 1);
+}
+
+void AlignIndexRefresh(AlignIndex* a, const ArrayWidget* w, const uint64_t* mask, size_t maskWords) {
+	ArrayAlignEntry add = { .allocator = a->lines[0].allocator };
+	size_t n = Array_size(w);
+	if(maskWords > (n+63)/64) maskWords = (n+63)/64;
+
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) {
+		ArrayAlignEntry* l = &a->lines[i];
+		//the masked widgets out, the others keep their order
+		size_t kept = 0;
+		for(ArrayIt j=0; j<Array_size(l); ++j)
+			if(!Masked(mask, maskWords, Array_at(l, j).index)) Array_at(l, kept++) = Array_at(l, j);
+		l->size = kept;
+
+		add.size = 0;
+		for(size_t word=0; word<maskWords; ++word) {
+			for(uint64_t bits = mask[word]; bits != 0; bits &= bits - 1) {
+				size_t j = word*64 + __builtin_ctzll(bits);
+				if(j >= n) break;
+				float lines[ALIGN_LINE_COUNT];
+				LinesOf(Array_at(w, j).bounds, lines);
+				if(Array_push(&add, ((AlignEntry){ lines[i], (int)j })) != VEE_OK) goto fail;
+			}
+		}
+		size_t k = Array_size(&add);
+		if(k == 0) continue;
+		qsort(Array_data(&add), k, sizeof(AlignEntry), CompareEntries);
+
+		//merged from the back so nothing is overwritten before it moved
+		if(Array_reserve(l, kept + k) != VEE_OK) goto fail;
+		AlignEntry* d = Array_data(l);
+		size_t x = kept, y = k, out = kept + k;
+		while(y > 0) {
+			if(x > 0 && Before(Array_at(&add, y-1), d[x-1])) d[--out] = d[--x];
+			else d[--out] = Array_at(&add, --y);
+		}
+		l->size = kept + k;
+	}
+	Array_destroy(&add);
+	return;
+
+fail:
+	Array_destroy(&add);
+	AlignIndexClear(a);
+}
+
+static void* AppendThread(void* arg) {
+	PROFILE_ZONE("AlignAppend");
+	AlignAppend* j = arg;
+	ArrayAlignEntry add = {0};
+	size_t k = Array_size(j->w) - j->first;
+	j->result = VEE_OK;
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) {
+		const ArrayAlignEntry* from = &j->from->lines[i];
+		ArrayAlignEntry* out = &j->merged.lines[i];
+		size_t kept = Array_size(from);
+		if(Array_reserve_exact(&add, k) != VEE_OK || Array_reserve_exact(out, kept + k) != VEE_OK) {
+			j->result = VEE_OUT_OF_MEMORY;
+			break;
+		}
+		for(size_t y=0; y<k; ++y) {
+			float lines[ALIGN_LINE_COUNT];
+			LinesOf(Array_at(j->w, j->first + y).bounds, lines);
+			Array_at(&add, y) = (AlignEntry){ lines[i], (int)(j->first + y) };
+		}
+		qsort(Array_data(&add), k, sizeof(AlignEntry), CompareEntries);
+
+		const AlignEntry *x0 = Array_data(from), *y0 = Array_data(&add);
+		AlignEntry* d = Array_data(out);
+		size_t x = 0, y = 0, o = 0;
+		while(x < kept && y < k) d[o++] = Before(y0[y], x0[x]) ? y0[y++] : x0[x++];
+		while(x < kept) d[o++] = x0[x++];
+		while(y < k) d[o++] = y0[y++];
+		out->size = kept + k;
+	}
+	Array_destroy(&add);
+	__atomic_store_n(&j->done, 1, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+void AlignAppendBegin(AlignAppend* j, const AlignIndex* a, const ArrayWidget* w, size_t first) {
+	*j = (AlignAppend){ .from = a, .w = w, .first = first };
+	//the allocator of `a` may not be safe to use from another thread
+	AlignIndexCreate(&j->merged, NULL);
+	j->started = pthread_create(&j->thread, NULL, AppendThread, j) == 0;
+	if(!j->started) AppendThread(j);
+}
+
+bool AlignAppendDone(AlignAppend* j) {
+	return __atomic_load_n(&j->done, __ATOMIC_ACQUIRE) != 0;
+}
+
+void AlignAppendEnd(AlignAppend* j, AlignIndex* a) {
+	if(j->started) pthread_join(j->thread, NULL);
+	if(j->result == VEE_OK) {
+		AlignIndexDestroy(a);
+		*a = j->merged;
+	} else {
+		AlignIndexDestroy(&j->merged);
+		AlignIndexClear(a);
+	}
+	*j = (AlignAppend){0};
+}
+
+void AlignIndexInsert(AlignIndex* a, int index, Rectangle r) {
+	float lines[ALIGN_LINE_COUNT];
+	LinesOf(r, lines);
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) {
+		AlignEntry e = { lines[i], index };
+		size_t p = LowerBound(&a->lines[i], e); //Array_insert() evaluates it twice
+		if(Array_insert(&a->lines[i], p, &e, 1) != VEE_OK) {
+			AlignIndexClear(a);
+			return;
+		}
+	}
+}
+
+void AlignIndexRemove(AlignIndex* a, int index, Rectangle r) {
+	float lines[ALIGN_LINE_COUNT];
+	LinesOf(r, lines);
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) {
+		AlignEntry e = { lines[i], index };
+		size_t p = LowerBound(&a->lines[i], e);
+		if(Found(&a->lines[i], p, e)) Array_remove(&a->lines[i], p, 1);
+	}
+}
+
+void AlignIndexUpdate(AlignIndex* a, int index, Rectangle from, Rectangle to) {
+	float before[ALIGN_LINE_COUNT], after[ALIGN_LINE_COUNT];
+	LinesOf(from, before);
+	LinesOf(to, after);
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i)
+		MoveEntry(&a->lines[i], (AlignEntry){ before[i], index }, (AlignEntry){ after[i], index });
+}
+
+void AlignIndexRename(AlignIndex* a, int from, int to, Rectangle r) {
+	float lines[ALIGN_LINE_COUNT];
+	LinesOf(r, lines);
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i)
+		MoveEntry(&a->lines[i], (AlignEntry){ lines[i], from }, (AlignEntry){ lines[i], to });
+}
+
+
+// -------
+// QUERIES
+// -------
+
+static inline void Consider(AlignEntry e, float at, AlignMatch* best) {
+	if(best->widget < 0 || fabsf(e.at - at) < fabsf(best->delta))
+		*best = (AlignMatch){ e.index, e.at, e.at - at };
+}
+
+//Closest unskipped entry on each side of `at`, the ones further away can't do better
+static void NearestOnLine(const ArrayAlignEntry* l, float at, float tolerance, const Selection* skip, AlignMatch* best) {
+	size_t n = Array_size(l), mid = LowerBound(l, (AlignEntry){ at, INT32_MIN });
+	for(size_t i=mid; i<n; ++i) {
+		AlignEntry e = Array_at(l, i);
+		if(e.at - at > tolerance) break;
+		if(skip != NULL && SelectionHas(skip, e.index)) continue;
+		Consider(e, at, best);
+		break;
+	}
+	for(size_t i=mid; i-- > 0;) {
+		AlignEntry e = Array_at(l, i);
+		if(at - e.at > tolerance) break;
+		if(skip != NULL && SelectionHas(skip, e.index)) continue;
+		Consider(e, at, best);
+		break;
+	}
+}
+
+AlignMatch AlignNearest(const AlignIndex* a, AlignAxis axis, float at, float tolerance, const Selection* skip) {
+	AlignMatch best = { -1, 0, 0 };
+	int first = (axis == ALIGN_AXIS_X) ? ALIGN_LEFT : ALIGN_TOP;
+	for(int i=first; i<first+3; ++i) {
+		NearestOnLine(&a->lines[i], at, tolerance, skip, &best);
+		if(best.widget >= 0) tolerance = fabsf(best.delta);
+	}
+	return best;
+}
+
+void AlignRect(const AlignIndex* a, Rectangle r, unsigned lines, float tolerance, const Selection* skip, AlignMatch m[2]) {
+	float at[ALIGN_LINE_COUNT];
+	LinesOf(r, at);
+	m[ALIGN_AXIS_X] = m[ALIGN_AXIS_Y] = (AlignMatch){ -1, 0, 0 };
+	for(int i=0; i<ALIGN_LINE_COUNT; ++i) {
+		if(!(lines & (1u << i))) continue;
+		AlignAxis axis = (i < ALIGN_TOP) ? ALIGN_AXIS_X : ALIGN_AXIS_Y;
+		float reach = (m[axis].widget >= 0) ? fabsf(m[axis].delta) : tolerance;
+		AlignMatch found = AlignNearest(a, axis, at[i], reach, skip);
+		if(found.widget >= 0 && (m[axis].widget < 0 || fabsf(found.delta) < fabsf(m[axis].delta))) m[axis] = found;
+	}
+}
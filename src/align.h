@@ -0,0 +1,101 @@
+#ifndef GE_ALIGN_H
+#define GE_ALIGN_H
+
+#include "editor.h"
+#include "selection.h"
+#include <pthread.h>
+
+//moving more widgets than this at once is cheaper with AlignIndexRefresh()
+#define ALIGN_BATCH_MIN 64
+//how close (in screen pixels) a line has to get to another widget's line to snap to it
+#define ALIGN_TOLERANCE 6
+
+/* ALIGNMENT INDEX
+ * The left, right, top and bottom edges and the two center lines of every widget, each kind in
+ * its own array sorted by coordinate, so the line of another widget closest to a point is a
+ * binary search away. Widgets with negative size (resized past the opposite edge) use the
+ * edges they cover. It's kept in sync by whoever changes the widgets, like the spatial index.
+ *
+ * Single widgets are moved in place (binary search and one memmove per line), a batch of
+ * them is taken out and merged back in one pass with AlignIndexRefresh(). A big batch added
+ * to the end of the widget array is sorted and merged by a background thread instead, see
+ * AlignAppendBegin(). When memory runs out the index is left empty, nothing snaps until the
+ * next rebuild. */
+
+typedef enum {
+	ALIGN_LEFT,
+	ALIGN_CENTER_X,
+	ALIGN_RIGHT,
+	ALIGN_TOP,
+	ALIGN_CENTER_Y,
+	ALIGN_BOTTOM,
+	ALIGN_LINE_COUNT
+} AlignLine;
+
+typedef enum {
+	ALIGN_AXIS_X, //vertical lines, the first 3 AlignLine
+	ALIGN_AXIS_Y  //horizontal lines, the last 3
+} AlignAxis;
+
+typedef struct {
+	float at;
+	int index;
+} AlignEntry;
+
+typedef Array(AlignEntry) ArrayAlignEntry;
+
+typedef struct {
+	ArrayAlignEntry lines[ALIGN_LINE_COUNT]; //sorted by `at` then `index`
+} AlignIndex;
+
+typedef struct {
+	int widget;  //lined up with or -1 when nothing was in reach
+	float at;    //where the guide goes
+	float delta; //to add to the line that was looked up
+} AlignMatch;
+
+extern void AlignIndexCreate(AlignIndex* a, Allocator* allocator);
+extern void AlignIndexDestroy(AlignIndex* a);
+extern void AlignIndexClear(AlignIndex* a);
+/** Drop everything and add all the widgets from `w` again. */
+extern void AlignIndexRebuild(AlignIndex* a, const ArrayWidget* w);
+/** Take the lines of the widgets whose bit is set in `mask` from `w` again, whether they were
+ * in the index or were just added to the end of `w`. O(n + k log k) for k widgets. */
+extern void AlignIndexRefresh(AlignIndex* a, const ArrayWidget* w, const uint64_t* mask, size_t maskWords);
+
+extern void AlignIndexInsert(AlignIndex* a, int index, Rectangle r);
+/** `r` must be the same bounds the widget was inserted with. */
+extern void AlignIndexRemove(AlignIndex* a, int index, Rectangle r);
+extern void AlignIndexUpdate(AlignIndex* a, int index, Rectangle from, Rectangle to);
+/** Widget with bounds `r` moved from index `from` to index `to` in the widget array. */
+extern void AlignIndexRename(AlignIndex* a, int from, int to, Rectangle r);
+
+//merge of the widgets added to the end of the array, see AlignAppendBegin()
+typedef struct {
+	pthread_t thread;
+	bool started;            //on its own thread, false when it ran on the caller's
+	const AlignIndex* from;
+	const ArrayWidget* w;
+	size_t first;
+	AlignIndex merged;       //`from` with the lines of the widgets from `first` on
+	int result;
+	int done;                //set by the thread once `merged` and `result` are there
+} AlignAppend;
+
+/** Start merging the lines of the widgets of `w` from `first` to the end into a copy of `a`
+ * on a background thread (on the calling one if no thread can be started). `a` and `w` can
+ * be read but must not change until AlignAppendEnd(). */
+extern void AlignAppendBegin(AlignAppend* j, const AlignIndex* a, const ArrayWidget* w, size_t first);
+/** True once the merge is done, AlignAppendEnd() doesn't wait then. */
+extern bool AlignAppendDone(AlignAppend* j);
+/** Wait for the merge and put its lines in `a`, the index it was started with. */
+extern void AlignAppendEnd(AlignAppend* j, AlignIndex* a);
+
+/** The line on `axis` of any widget not in `skip` (can be NULL) closest to `at`, no further than
+ * `tolerance`. O(log n) plus the skipped widgets around `at`. */
+extern AlignMatch AlignNearest(const AlignIndex* a, AlignAxis axis, float at, float tolerance, const Selection* skip);
+/** The closest match per axis (m[ALIGN_AXIS_X], m[ALIGN_AXIS_Y]) for the lines of `r` whose
+ * bit (1 << AlignLine) is set in `lines`. */
+extern void AlignRect(const AlignIndex* a, Rectangle r, unsigned lines, float tolerance, const Selection* skip, AlignMatch m[2]);
+
+#endif
@@ -0,0 +1,312 @@
+#include "batch.h"
+#include "uifile.h"
+#include "codegen.h"
+#include "profile.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h> //for sysconf()
+#include <sys/stat.h>
+
+static const char* StyleName[CODE_STYLE_COUNT] = { "calls", "tables" };
+
+typedef struct {
+	const char* in;
+	char out[1040];
+	uint64_t hash;     //of the content of `in`
+	int result;        //number of widgets or a negative VEE_* error code
+	bool unchanged;    //the output was up to date
+	const struct BatchCached* cached; //by the last run, or NULL
+	size_t bytes;
+	double read, decode, generate; //ms
+} BatchJob;
+
+typedef Array(BatchJob) ArrayBatchJob;
+
+//an input exported by an earlier run
+typedef struct BatchCached {
+	uint64_t hash;
+	CodeStyle style;
+	int widgets;
+	char* path;
+	bool batched;  //this run has the input too
+} BatchCached;
+
+typedef Array(BatchCached) ArrayBatchCached;
+
+typedef Array(uint8_t) ArrayBytes;
+
+//the memory a worker reuses from one file to the next
+typedef struct {
+	ArrayBytes data;
+	ArrayWidget w, ordered;
+	ArrayDepthRank depth;
+	StringTable strings;
+} BatchScratch;
+
+static struct {
+	ArrayBatchJob jobs;
+	ArrayBatchCached cache; //sorted by path
+	CodeStyle style;
+	size_t next;            //job the next free worker takes
+} batch;
+
+static inline double Now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec*1000.0 + t.tv_nsec/1e6;
+}
+
+static bool ReplaceFile(const char* tmp, const char* path) {
+#ifdef _WIN32
+	remove(path);
+#endif
+	return rename(tmp, path) == 0;
+}
+
+static int ComparePaths(const void* a, const void* b) {
+	return strcmp(((const BatchCached*)a)->path, ((const BatchCached*)b)->path);
+}
+
+static const BatchCached* FindCached(const char* path) {
+	BatchCached key = { .path = (char*)path };
+	return bsearch(&key, Array_data(&batch.cache), Array_size(&batch.cache), sizeof(BatchCached), ComparePaths);
+}
+
+
+// -------
+// CACHE
+// -------
+
+static void LoadCache(const char* file) {
+	FILE* f = fopen(file, "r");
+	if(f == NULL) return;
+	char line[1200], style[16];
+	while(fgets(line, sizeof(line), f) != NULL) {
+		BatchCached c = {0};
+		int at = 0;
+		if(sscanf(line, "%16" SCNx64 " %15s %i %n", &c.hash, style, &c.widgets, &at) != 3 || at == 0) continue;
+		line[strcspn(line, "\r\n")] = '\0';
+		c.style = CODE_STYLE_COUNT;
+		for(int s=0; s<CODE_STYLE_COUNT; ++s) if(strcmp(style, StyleName[s]) == 0) c.style = s;
+		if(c.style == CODE_STYLE_COUNT || line[at] == '\0' || (c.path = strdup(line + at)) == NULL) continue;
+		if(Array_push(&batch.cache, c) != VEE_OK) {
+			free(c.path);
+			break;
+		}
+	}
+	fclose(f);
+	qsort(Array_data(&batch.cache), Array_size(&batch.cache), sizeof(BatchCached), ComparePaths);
+}
+
+//the files of this batch that were exported, and those of the earlier runs it didn't touch
+static void SaveCache(const char* file) {
+	char tmp[1050];
+	snprintf(tmp, sizeof(tmp), "%s.tmp", file);
+	FILE* f = fopen(tmp, "w");
+	if(f == NULL) {
+		warn("failed to write the export cache `%s`", file);
+		return;
+	}
+	for(ArrayIt i=0; i<Array_size(&batch.jobs); ++i) {
+		BatchJob j = Array_at(&batch.jobs, i);
+		if(j.result >= 0) fprintf(f, "%016" PRIx64 " %s %i %s\n", j.hash, StyleName[batch.style], j.result, j.in);
+	}
+	for(ArrayIt i=0; i<Array_size(&batch.cache); ++i) {
+		BatchCached c = Array_at(&batch.cache, i);
+		if(!c.batched) fprintf(f, "%016" PRIx64 " %s %i %s\n", c.hash, StyleName[c.style], c.widgets, c.path);
+	}
+	if(fclose(f) != 0 || !ReplaceFile(tmp, file)) {
+		remove(tmp);
+		warn("failed to write the export cache `%s`", file);
+	}
+}
+
+
+// -------
+// WORKERS
+// -------
+
+static int ReadAll(const char* file, ArrayBytes* data) {
+	FILE* f = fopen(file, "rb");
+	if(f == NULL) return VEE_IO_ERROR;
+	int r = VEE_IO_ERROR;
+	long size = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+	if(size >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+		data->size = 0;
+		if(Array_reserve(data, (size_t)size) != VEE_OK) r = VEE_OUT_OF_MEMORY;
+		else if(fread(Array_data(data), 1, size, f) == (size_t)size) {
+			data->size = size;
+			r = VEE_OK;
+		}
+	}
+	fclose(f);
+	return r;
+}
+
+static void ExportJob(BatchJob* j, BatchScratch* s) {
+	PROFILE_ZONE("ExportJob");
+	double t = Now();
+	j->result = ReadAll(j->in, &s->data);
+	if(j->result != VEE_OK) return;
+	j->bytes = Array_size(&s->data);
+	j->hash = fnv64_1a((char*)Array_data(&s->data), j->bytes);
+	j->read = Now() - t;
+
+	struct stat st;
+	const BatchCached* c = j->cached;
+	if(c != NULL && c->hash == j->hash && c->style == batch.style && stat(j->out, &st) == 0) {
+		j->unchanged = true;
+		j->result = c->widgets;
+		return;
+	}
+
+	t = Now();
+	s->w.size = 0;
+	StringTableClear(&s->strings);
+	j->result = DecodeUIFile(Array_data(&s->data), j->bytes, &s->w, 0, &s->depth, &s->strings);
+	if(j->result < 0) return;
+	//the code draws the widgets in depth order
+	if(Array_reserve(&s->ordered, Array_size(&s->w)) != VEE_OK) {
+		j->result = VEE_OUT_OF_MEMORY;
+		return;
+	}
+	for(ArrayIt i=0; i<Array_size(&s->w); ++i) Array_at(&s->ordered, Array_at(&s->depth, i)) = Array_at(&s->w, i);
+	s->ordered.size = Array_size(&s->w);
+	j->decode = Now() - t;
+
+	t = Now();
+	char tmp[1050];
+	snprintf(tmp, sizeof(tmp), "%s.tmp", j->out);
+	int r = ExportCode(tmp, &s->ordered, &s->strings, batch.style);
+	if(r != VEE_OK || !ReplaceFile(tmp, j->out)) {
+		remove(tmp);
+		j->result = (r != VEE_OK) ? r : VEE_IO_ERROR;
+	}
+	j->generate = Now() - t;
+}
+
+static void* BatchThread(void* arg) {
+	BatchScratch s = {0};
+	int r = StringTableCreate(&s.strings, NULL);
+	for(size_t i; (i = __atomic_fetch_add(&batch.next, 1, __ATOMIC_RELAXED)) < Array_size(&batch.jobs);) {
+		BatchJob* j = &Array_at(&batch.jobs, i);
+		if(r != VEE_OK) j->result = r;
+		else if(j->result == VEE_OK) ExportJob(j, &s);
+	}
+	StringTableDestroy(&s.strings);
+	Array_destroy(&s.data);
+	Array_destroy(&s.w);
+	Array_destroy(&s.ordered);
+	Array_destroy(&s.depth);
+	return NULL;
+}
+
+//two inputs that would write the same output, both of them fail
+static int CompareOutputs(const void* a, const void* b) {
+	return strcmp((*(BatchJob* const*)a)->out, (*(BatchJob* const*)b)->out);
+}
+
+static void RejectClashes() {
+	size_t n = Array_size(&batch.jobs);
+	BatchJob** byOut = malloc(n*sizeof(BatchJob*));
+	if(byOut == NULL) return;
+	for(size_t i=0; i<n; ++i) byOut[i] = &Array_at(&batch.jobs, i);
+	qsort(byOut, n, sizeof(BatchJob*), CompareOutputs);
+	for(size_t i=1; i<n; ++i) {
+		if(byOut[i]->out[0] == '\0' || strcmp(byOut[i-1]->out, byOut[i]->out) != 0) continue;
+		byOut[i-1]->result = byOut[i]->result = VEE_BAD_ARG;
+	}
+	free(byOut);
+}
+
+
+// -------
+// COMMAND LINE
+// -------
+
+int RunBatchExport(int argc, char** argv) {
+	const char* dir = NULL;
+	long workers = sysconf(_SC_NPROCESSORS_ONLN);
+
+	for(int i=0; i<argc; ++i) {
+		if(strcmp(argv[i], "--tables") == 0) batch.style = CODE_TABLES;
+		else if(strcmp(argv[i], "-o") == 0 && i+1 < argc) dir = argv[++i];
+		else if(strcmp(argv[i], "-j") == 0 && i+1 < argc) workers = strtol(argv[++i], NULL, 10);
+		else if(Array_push(&batch.jobs, ((BatchJob){ .in = argv[i] })) != VEE_OK) {
+			warn("out of memory");
+			Array_destroy(&batch.jobs);
+			return EXIT_FAILURE;
+		}
+	}
+	if(Array_size(&batch.jobs) == 0) {
+		warn("usage: --export [--tables] [-o <dir>] [-j <workers>] <in.ui>...");
+		return EXIT_FAILURE;
+	}
+
+	char cacheFile[1040];
+	int length = snprintf(cacheFile, sizeof(cacheFile), "%s/%s", (dir != NULL) ? dir : ".", BATCH_CACHE_FILE);
+	if(length < 0 || (size_t)length >= sizeof(cacheFile)) {
+		warn("the output directory `%s` is too long", dir);
+		Array_destroy(&batch.jobs);
+		return EXIT_FAILURE;
+	}
+	LoadCache(cacheFile);
+	for(ArrayIt i=0; i<Array_size(&batch.jobs); ++i) {
+		BatchJob* j = &Array_at(&batch.jobs, i);
+		const char* name = j->in;
+		if(dir != NULL) {
+			for(const char* c = name; *c; ++c) if(*c == '/' || *c == '\\') name = c + 1;
+			length = snprintf(j->out, sizeof(j->out), "%s/%s.c", dir, name);
+		} else {
+			length = snprintf(j->out, sizeof(j->out), "%s.c", name);
+		}
+		//a truncated path would be some other file
+		if(length < 0 || (size_t)length >= sizeof(j->out)) {
+			warn("the output path of `%s` is too long", j->in);
+			j->out[0] = '\0';
+			j->result = VEE_BAD_ARG;
+		}
+		BatchCached* c = (BatchCached*)FindCached(j->in);
+		if(c != NULL) c->batched = true;
+		j->cached = c;
+	}
+	RejectClashes();
+
+	int n = (workers < 1) ? 1 : (workers > BATCH_MAX_WORKERS) ? BATCH_MAX_WORKERS : workers;
+	if((size_t)n > Array_size(&batch.jobs)) n = Array_size(&batch.jobs);
+	pthread_t threads[BATCH_MAX_WORKERS];
+	double t = Now();
+	int started = 0;
+	for(; started<n; ++started)
+		if(pthread_create(&threads[started], NULL, BatchThread, NULL) != 0) break;
+	if(started == 0) BatchThread(NULL);
+	for(int i=0; i<started; ++i) pthread_join(threads[i], NULL);
+	t = Now() - t;
+
+	size_t exported = 0, unchanged = 0, failed = 0, widgets = 0, bytes = 0;
+	for(ArrayIt i=0; i<Array_size(&batch.jobs); ++i) {
+		BatchJob j = Array_at(&batch.jobs, i);
+		if(j.result < 0) {
+			++failed;
+			warn("failed to export `%s` to `%s` (%i)", j.in, j.out, j.result);
+		} else if(j.unchanged) {
+			++unchanged;
+			info("%-40s %8i widgets  unchanged", j.in, j.result);
+		} else {
+			++exported;
+			widgets += j.result;
+			bytes += j.bytes;
+			info("%-40s %8i widgets %9.2f ms read %9.2f ms decode %9.2f ms generate", j.in, j.result, j.read, j.decode, j.generate);
+		}
+	}
+	double s = (t > 0) ? t/1000.0 : 1e-9;
+	info("%zu exported, %zu unchanged, %zu failed in %.2f ms on %i workers: %.1f files/s, %.0f widgets/s, %.2f MB/s",
+		exported, unchanged, failed, t, (started > 0) ? started : 1, exported/s, widgets/s, bytes/s/(1024.0*1024.0));
+
+	SaveCache(cacheFile);
+	for(ArrayIt i=0; i<Array_size(&batch.cache); ++i) free(Array_at(&batch.cache, i).path);
+	Array_destroy(&batch.cache);
+	Array_destroy(&batch.jobs);
+	return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,22 @@
+#ifndef GE_BATCH_H
+#define GE_BATCH_H
+
+/* BATCH EXPORT
+ * `editor --export [--tables] [-o <dir>] [-j <workers>] <in.ui>...` generates the code of many
+ * layouts without opening a window. The files are read, decoded and generated by a pool of
+ * BATCH_MAX_WORKERS threads at most (one per core, or `workers`), every output is written next
+ * to its input as `<in.ui>.c` (in `dir` when given, which has to exist) through a temporary
+ * file, so an output is either the old one or the whole new one.
+ *
+ * The fnv64-1a hash of every input is kept in BATCH_CACHE_FILE (in `dir` or the current
+ * directory), an input with the same hash and code style as last time whose output is still
+ * there isn't generated again. The time every file took and the throughput of the batch are
+ * printed to stdout. Returns EXIT_SUCCESS or EXIT_FAILURE when a file couldn't be exported. */
+
+#define BATCH_MAX_WORKERS 32
+#define BATCH_CACHE_FILE ".uiexport"
+
+/** `argv` starts after `--export`. */
+extern int RunBatchExport(int argc, char** argv);
+
+#endif
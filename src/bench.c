@@ -0,0 +1,1376 @@
+#include "bench.h"
+#include "editor.h"
+#include "selection.h"
+#include "spatial.h"
+#include "align.h"
+#include "lint.h"
+#include "bounds.h"
+#include "textcache.h"
+#include "codegen.h"
+#include "uifile.h"
+#include "import.h"
+#include "history.h"
+#include <math.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#define BENCH_WIDGETS 50000
+#define BENCH_FRAMES 1000
+//what a frame may take at 60 fps
+#define FRAME_BUDGET_MS (1000.0/60.0)
+
+static inline double Now() {
+	return (double)clock()*1000.0/CLOCKS_PER_SEC;
+}
+
+//wall clock, for the time spent in other processes
+static inline double WallNow() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec*1000.0 + t.tv_nsec/1e6;
+}
+
+//a grid of small widgets, like a big form
+static int MakeLayout(ArrayWidget* w, size_t n) {
+	if(Array_reserve_exact(w, n) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	for(size_t i=0; i<n; ++i)
+		Array_at(w, i) = (Widget){ i % WIDGET_COUNT, (Rectangle){ (i%250)*30, (i/250)*25, 25, 20 }, i };
+	w->size = n;
+	return VEE_OK;
+}
+
+static void BenchSelection() {
+	ArrayWidget w = {0};
+	Selection s;
+	ArrayWidgetMove m = {0};
+	SpatialIndex spatial;
+	WidgetBounds b;
+	SelectionCreate(&s);
+	SpatialIndexCreate(&spatial, 80);
+	BoundsCreate(&b, NULL);
+	if(MakeLayout(&w, BENCH_WIDGETS) != VEE_OK || BoundsLoad(&b, &w) != VEE_OK) return;
+
+	double t = Now();
+	SelectionAddRect(&s, &b, (Rectangle){ -1, -1, 1e6, 1e6 });
+	double select = Now() - t;
+
+	t = Now();
+	SelectionMoves(&s, &w, &m);
+	double begin = Now() - t;
+
+	t = Now();
+	for(int f=0; f<BENCH_FRAMES; ++f)
+		TranslateWidgets(&w, Array_data(&m), Array_size(&m), (Vector2){ f%64, f%32 });
+	double move = (Now() - t)/BENCH_FRAMES;
+
+	t = Now();
+	SpatialIndexRebuild(&spatial, &w);
+	double end = Now() - t;
+
+	//keeps the compiler from dropping the moves
+	float sum = 0;
+	for(size_t i=0; i<Array_size(&w); ++i) sum += Array_at(&w, i).bounds.x;
+
+	info("selection of %zu widgets (checksum %.0f)", s.count, sum);
+	info("  box select           %8.3f ms", select);
+	info("  drag start           %8.3f ms", begin);
+	info("  move (per frame)     %8.3f ms  (%.1f%% of a 60 fps frame)", move, 100.0*move/FRAME_BUDGET_MS);
+	info("  drag end (reindex)   %8.3f ms", end);
+
+	BoundsDestroy(&b);
+	SpatialIndexDestroy(&spatial);
+	Array_destroy(&m);
+	SelectionDestroy(&s);
+	Array_destroy(&w);
+}
+
+
+//Lining up a dragged widget with the rest: one query per frame, the index catches up once at the end
+static void BenchAlign() {
+	ArrayWidget w = {0};
+	AlignIndex a;
+	Selection s;
+	AlignIndexCreate(&a, NULL);
+	SelectionCreate(&s);
+	if(MakeLayout(&w, BENCH_WIDGETS) != VEE_OK || SelectionAdd(&s, BENCH_WIDGETS/2) != VEE_OK) return;
+
+	double t = Now();
+	AlignIndexRebuild(&a, &w);
+	double build = Now() - t;
+
+	int matched = 0;
+	Rectangle r = Array_at(&w, BENCH_WIDGETS/2).bounds;
+	t = Now();
+	for(int f=0; f<BENCH_FRAMES; ++f) {
+		AlignMatch m[2];
+		AlignRect(&a, (Rectangle){ r.x + f%97 - 48, r.y + f%89 - 44, r.width, r.height }, (1u << ALIGN_LINE_COUNT)-1, ALIGN_TOLERANCE, &s, m);
+		matched += (m[ALIGN_AXIS_X].widget >= 0) + (m[ALIGN_AXIS_Y].widget >= 0);
+	}
+	double query = (Now() - t)/BENCH_FRAMES;
+
+	t = Now();
+	for(int f=0; f<BENCH_FRAMES; ++f) {
+		Rectangle to = { r.x, r.y, r.width + f%40, r.height + f%30 };
+		AlignIndexUpdate(&a, BENCH_WIDGETS/2, Array_at(&w, BENCH_WIDGETS/2).bounds, to);
+		Array_at(&w, BENCH_WIDGETS/2).bounds = to;
+	}
+	double update = (Now() - t)/BENCH_FRAMES;
+
+	//a tenth of the layout dropped somewhere else
+	size_t words = (BENCH_WIDGETS+63)/64;
+	uint64_t* mask = calloc(words, sizeof(uint64_t));
+	if(mask != NULL) {
+		for(size_t i=0; i<BENCH_WIDGETS; i+=10) {
+			Array_at(&w, i).bounds.x += 1000;
+			mask[i/64] |= 1ull << (i%64);
+		}
+	}
+	t = Now();
+	if(mask != NULL) AlignIndexRefresh(&a, &w, mask, words);
+	double refresh = Now() - t;
+
+	info("alignment of %zu widgets (%i lines matched)", Array_size(&w), matched);
+	info("  index                %8.3f ms", build);
+	info("  drag (per frame)     %8.3f ms", query);
+	info("  resize (per frame)   %8.3f ms", update);
+	info("  drag end (10%% moved) %8.3f ms", refresh);
+
+	free(mask);
+	SelectionDestroy(&s);
+	AlignIndexDestroy(&a);
+	Array_destroy(&w);
+}
+
+
+//The lint runs again after every edit, a pass over a big layout has to fit in a frame
+#define LINT_WIDGETS 100000
+
+static void BenchLint() {
+	ArrayWidget w = {0};
+	AlignIndex a;
+	LintReport r;
+	AlignIndexCreate(&a, NULL);
+	LintCreate(&r, NULL);
+	if(MakeLayout(&w, LINT_WIDGETS) != VEE_OK) return;
+	//a few of them too wide for their slot of the grid
+	for(size_t i=0; i<LINT_WIDGETS; i+=1000) Array_at(&w, i).bounds.width = 40;
+	AlignIndexRebuild(&a, &w);
+
+	double t = Now();
+	int passes = 0;
+	for(; passes < BENCH_FRAMES/10 && LintLayout(&r, &w, &a, (Rectangle){ 0, 0, screenWidth, screenHeight }) == VEE_OK; ++passes);
+	double pass = (Now() - t)/(passes > 0 ? passes : 1);
+
+	info("lint of %zu widgets (%zu overlap, %zu clipped, %zu outside)", Array_size(&w), 
+		r.counts[LINT_OVERLAP], r.counts[LINT_CLIPPED], r.counts[LINT_OUTSIDE]);
+	info("  pass                 %8.3f ms  (%.1f%% of a 60 fps frame)", pass, 100.0*pass/FRAME_BUDGET_MS);
+
+	LintDestroy(&r);
+	AlignIndexDestroy(&a);
+	Array_destroy(&w);
+}
+
+
+// -------
+// BOUNDS KERNELS
+// -------
+// Every kernel the CPU supports has to give the same results as the scalar one, bit for bit.
+
+#define KERNEL_WIDGETS 4099 //not a multiple of 8 so every version has widgets left over
+
+//deterministic so a mismatch can be reproduced
+static uint32_t seed = 12345;
+static inline uint32_t Random() {
+	seed = seed*1664525u + 1013904223u;
+	return seed >> 8;
+}
+
+static inline float RandomFloat(float lo, float hi) {
+	return lo + (hi-lo)*(Random() & 0xFFFF)/65535.0f;
+}
+
+//random bounds with negative sizes, empty widgets and values already on the grid
+static int RandomBounds(WidgetBounds* b, size_t n) {
+	for(size_t i=0; i<n; ++i) {
+		Rectangle r = { RandomFloat(-200, 1200), RandomFloat(-200, 900), RandomFloat(-80, 160), RandomFloat(-80, 160) };
+		switch(Random()%8) {
+			case 0: r = (Rectangle){ (int)r.x/8*8, (int)r.y/8*8, (int)r.width/8*8, (int)r.height/8*8 }; break;
+			case 1: r.width = 0; break;
+			case 2: r.height = -0.0f; break;
+			default: break;
+		}
+		if(BoundsSwapInsert(b, i, r) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	}
+	return VEE_OK;
+}
+
+static bool SameBits(const uint64_t* a, const uint64_t* b, size_t words) {
+	return memcmp(a, b, words*sizeof(uint64_t)) == 0;
+}
+
+static bool SameBounds(const WidgetBounds* a, const WidgetBounds* b) {
+	size_t n = BoundsSize(a);
+	return n == BoundsSize(b) &&
+		memcmp(Array_data(&a->x), Array_data(&b->x), n*sizeof(float)) == 0 &&
+		memcmp(Array_data(&a->y), Array_data(&b->y), n*sizeof(float)) == 0 &&
+		memcmp(Array_data(&a->w), Array_data(&b->w), n*sizeof(float)) == 0 &&
+		memcmp(Array_data(&a->h), Array_data(&b->h), n*sizeof(float)) == 0;
+}
+
+//compare `k` against the scalar kernels, returns the number of mismatches
+static int CheckKernels(const BoundsKernels* k, const WidgetBounds* src) {
+	const BoundsKernels* ref = BoundsKernelList[0];
+	enum { WORDS = (KERNEL_WIDGETS+63)/64 };
+	uint64_t a[WORDS], b[WORDS], mask[WORDS];
+	WidgetBounds ra, rb;
+	int failed = 0;
+	BoundsCreate(&ra, NULL);
+	BoundsCreate(&rb, NULL);
+	
+	for(int round=0; round<64; ++round) {
+		Rectangle r = { RandomFloat(-300, 1200), RandomFloat(-300, 900), RandomFloat(-400, 600), RandomFloat(-400, 600) };
+		Vector2 p = { RandomFloat(-100, 1100), RandomFloat(-100, 800) };
+		//on the grid too so edges touch exactly
+		if(round%2 == 0) r = (Rectangle){ (int)r.x/8*8, (int)r.y/8*8, (int)r.width/8*8, (int)r.height/8*8 };
+		if(round%4 == 0) p = (Vector2){ Array_at(&src->x, round), Array_at(&src->y, round) };
+		//a mask that's empty, full or sparse per word and shorter than the widgets
+		size_t maskWords = WORDS - round%3;
+		for(size_t i=0; i<WORDS; ++i) {
+			switch(Random()%4) {
+				case 0: mask[i] = 0; break;
+				case 1: mask[i] = ~(uint64_t)0; break;
+				default: mask[i] = ((uint64_t)Random() << 40) ^ ((uint64_t)Random() << 20) ^ Random(); break;
+			}
+		}
+		
+		memset(a, 0, sizeof(a)); memset(b, 0, sizeof(b));
+		ref->overlap(src, r, a);
+		k->overlap(src, r, b);
+		if(!SameBits(a, b, WORDS)) { warn("%s overlap differs from scalar (round %i)", k->name, round); ++failed; }
+		
+		memset(a, 0, sizeof(a)); memset(b, 0, sizeof(b));
+		ref->contain(src, p, a);
+		k->contain(src, p, b);
+		if(!SameBits(a, b, WORDS)) { warn("%s contain differs from scalar (round %i)", k->name, round); ++failed; }
+		
+		float grid = (round%2) ? 8 : RandomFloat(1, 32);
+		if(BoundsCopy(&ra, src) != VEE_OK || BoundsCopy(&rb, src) != VEE_OK) break;
+		memset(a, 0, sizeof(a)); memset(b, 0, sizeof(b));
+		ref->snap(&ra, mask, maskWords, grid, a);
+		k->snap(&rb, mask, maskWords, grid, b);
+		if(!SameBits(a, b, WORDS) || !SameBounds(&ra, &rb)) { warn("%s snap differs from scalar (round %i)", k->name, round); ++failed; }
+		
+		Vector2 d = { RandomFloat(-50, 50), RandomFloat(-50, 50) };
+		ref->translate(&ra, src, mask, maskWords, d);
+		k->translate(&rb, src, mask, maskWords, d);
+		if(!SameBounds(&ra, &rb)) { warn("%s translate differs from scalar (round %i)", k->name, round); ++failed; }
+	}
+	
+	BoundsDestroy(&ra);
+	BoundsDestroy(&rb);
+	return failed;
+}
+
+static int BenchBounds() {
+	WidgetBounds src, b;
+	ArrayWidget w = {0};
+	int failed = 0;
+	BoundsCreate(&src, NULL);
+	BoundsCreate(&b, NULL);
+	if(RandomBounds(&src, KERNEL_WIDGETS) != VEE_OK || MakeLayout(&w, BENCH_WIDGETS) != VEE_OK) {
+		warn("out of memory");
+		return 1;
+	}
+	
+	for(int i=1; BoundsKernelList[i] != NULL; ++i) {
+		const BoundsKernels* k = BoundsKernelList[i];
+		if(!k->supported()) info("%s kernels not supported by this CPU", k->name);
+		else failed += CheckKernels(k, &src);
+	}
+	
+	//every widget selected, a bit set for each one
+	size_t words = (BENCH_WIDGETS+63)/64;
+	uint64_t* all = malloc(words*sizeof(uint64_t));
+	uint64_t* out = malloc(words*sizeof(uint64_t));
+	if(all == NULL || out == NULL || BoundsLoad(&src, &w) != VEE_OK || BoundsCopy(&b, &src) != VEE_OK) {
+		warn("out of memory");
+		++failed;
+	}
+	else {
+		memset(all, 0xFF, words*sizeof(uint64_t));
+		info("bounds kernels on %i widgets (ms per call)", BENCH_WIDGETS);
+		info("  %-8s %8s %8s %8s %8s", "", "overlap", "contain", "snap", "move");
+		for(int i=0; BoundsKernelList[i] != NULL; ++i) {
+			const BoundsKernels* k = BoundsKernelList[i];
+			if(!k->supported()) continue;
+			double t = Now();
+			for(int f=0; f<BENCH_FRAMES; ++f) k->overlap(&b, (Rectangle){ f, f, 1920, 1080 }, out);
+			double overlap = (Now() - t)/BENCH_FRAMES;
+			t = Now();
+			for(int f=0; f<BENCH_FRAMES; ++f) k->contain(&b, (Vector2){ f, f }, out);
+			double contain = (Now() - t)/BENCH_FRAMES;
+			t = Now();
+			for(int f=0; f<BENCH_FRAMES; ++f) k->snap(&b, all, words, 8 + f%2, out);
+			double snap = (Now() - t)/BENCH_FRAMES;
+			t = Now();
+			for(int f=0; f<BENCH_FRAMES; ++f) k->translate(&b, &src, all, words, (Vector2){ f%64, f%32 });
+			double move = (Now() - t)/BENCH_FRAMES;
+			info("  %-8s %8.4f %8.4f %8.4f %8.4f", k->name, overlap, contain, snap, move);
+		}
+	}
+	
+	free(all);
+	free(out);
+	Array_destroy(&w);
+	BoundsDestroy(&src);
+	BoundsDestroy(&b);
+	return failed;
+}
+
+
+// -------
+// HIT TESTING
+// -------
+// Picking the topmost widget under the mouse with the spatial grid against walking the depth
+// order down from the top, the way the editor did before it had the grid. Both have to pick
+// the same widget.
+
+#define PICK_QUERIES 10000
+
+static int BenchPick(size_t n) {
+	ArrayWidget w = {0};
+	DepthOrder d;
+	SpatialIndex s;
+	DepthOrderCreate(&d);
+	SpatialIndexCreate(&s, 80);
+	int failed = 0;
+	//about as crowded at every size, with overlaps and a few large widgets
+	float side = sqrtf((float)n)*40;
+	if(Array_reserve_exact(&w, n) != VEE_OK || DepthOrderAppend(&d, n, NULL, DEPTH_NONE) != VEE_OK) {
+		warn("out of memory");
+		failed = 1;
+		goto done;
+	}
+	for(size_t i=0; i<n; ++i) {
+		float size = (Random()%100 == 0) ? 600 : 60;
+		Rectangle r = { RandomFloat(0, side), RandomFloat(0, side), RandomFloat(8, size), RandomFloat(8, size) };
+		Array_at(&w, i) = (Widget){ i % WIDGET_COUNT, r, i };
+	}
+	w.size = n;
+	//the draw order isn't the order of the array
+	for(size_t i=0; i<n/4; ++i) DepthOrderMove(&d, Random()%n, (Random()%8 == 0) ? DEPTH_NONE : (int)(Random()%n));
+	SpatialIndexRebuild(&s, &w);
+
+	Vector2* points = malloc(PICK_QUERIES*sizeof(Vector2));
+	int* picked = malloc(PICK_QUERIES*sizeof(int));
+	if(points == NULL || picked == NULL) {
+		warn("out of memory");
+		failed = 1;
+	} else {
+		for(int q=0; q<PICK_QUERIES; ++q) points[q] = (Vector2){ RandomFloat(-50, side + 50), RandomFloat(-50, side + 50) };
+
+		double t = Now();
+		for(int q=0; q<PICK_QUERIES; ++q) picked[q] = SpatialIndexPick(&s, &w, &d, points[q]);
+		double grid = (Now() - t)*1000.0/PICK_QUERIES;
+
+		int hits = 0;
+		t = Now();
+		for(int q=0; q<PICK_QUERIES; ++q) {
+			int top = d.top;
+			while(top != DEPTH_NONE && !CheckCollisionPointRec(points[q], Array_at(&w, top).bounds)) top = DepthBelow(&d, top);
+			if(top != picked[q]) {
+				if(failed++ == 0) warn("picked widget %i at (%g, %g) with the grid, %i by scanning", picked[q], points[q].x, points[q].y, top);
+			}
+			hits += (top != DEPTH_NONE);
+		}
+		double scan = (Now() - t)*1000.0/PICK_QUERIES;
+		info("  %7zu widgets  %9.3f us %9.3f us  %6.1fx  (%i%% hits)", n, grid, scan, (grid > 0) ? scan/grid : 0, hits*100/PICK_QUERIES);
+	}
+	free(points);
+	free(picked);
+
+done:
+	SpatialIndexDestroy(&s);
+	DepthOrderDestroy(&d);
+	Array_destroy(&w);
+	return failed;
+}
+
+static int BenchSpatial() {
+	info("hit testing (per pick)");
+	info("  %15s  %12s %12s", "", "grid", "scan");
+	int failed = 0;
+	for(size_t n=1000; n<=100000; n*=10) failed += BenchPick(n);
+	return failed;
+}
+
+// -------
+// LAYOUT FILES
+// -------
+// Random layouts written to a `.ui` file and decoded again have to come back the same, field
+// by field and string by string. Every truncation of the file and random byte flips have to
+// be rejected with an error.
+
+#define FILE_LAYOUTS 200
+#define FILE_MAX_WIDGETS 64
+//layouts whose every truncation and some flips are decoded
+#define FILE_CORRUPTED_LAYOUTS 20
+#define FILE_FLIPS 2000
+
+typedef Array(uint8_t) ArrayBytes;
+
+static const char* Words[] = { "", "OK", "Cancel", "Name", "one;two;three", "a;b", "Title of the window", "x", "Ünïcode" };
+
+static void RandomLayout(ArrayWidget* w, ArrayDepthRank* depth, StringTable* t, size_t n) {
+	w->size = depth->size = 0;
+	for(size_t i=0; i<n; ++i) {
+		Widget x = { Random()%WIDGET_COUNT, { RandomFloat(-100, 1000), RandomFloat(-100, 800), RandomFloat(-50, 300), RandomFloat(-50, 300) }, Random()%100000 };
+		WidgetProps* p = &x.props;
+		p->set = Random() & PROP_ALL;
+		if(p->set & PROP_TEXT) StringIntern(t, Words[Random()%(sizeof(Words)/sizeof(Words[0]))], &p->text);
+		if(p->set & PROP_ITEMS) StringIntern(t, Words[Random()%(sizeof(Words)/sizeof(Words[0]))], &p->items);
+		if(p->set & PROP_RANGE) { p->min = RandomFloat(-100, 100); p->max = RandomFloat(-100, 100); }
+		if(p->set & PROP_VALUE) p->value = RandomFloat(-100, 100);
+		if(p->set & PROP_COLOR) p->color = (Color){ Random(), Random(), Random(), Random() };
+		Array_push(w, x);
+		Array_push(depth, (uint32_t)i);
+	}
+	for(size_t i=n; i-- > 1;) {
+		size_t j = Random()%(i+1);
+		uint32_t r = Array_at(depth, i);
+		Array_at(depth, i) = Array_at(depth, j);
+		Array_at(depth, j) = r;
+	}
+}
+
+static bool SameFloat(float a, float b) {
+	return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static bool SameWidget(Widget a, const StringTable* ta, Widget b, const StringTable* tb) {
+	WidgetProps p = a.props, q = b.props;
+	return a.type == b.type && a.id == b.id && SameFloat(a.bounds.x, b.bounds.x) && SameFloat(a.bounds.y, b.bounds.y) &&
+		SameFloat(a.bounds.width, b.bounds.width) && SameFloat(a.bounds.height, b.bounds.height) &&
+		p.set == q.set && p.text == q.text && p.items == q.items &&
+		strcmp(StringTableGet(ta, p.text), StringTableGet(tb, q.text)) == 0 &&
+		strcmp(StringTableGet(ta, p.items), StringTableGet(tb, q.items)) == 0 &&
+		SameFloat(p.min, q.min) && SameFloat(p.max, q.max) && SameFloat(p.value, q.value) &&
+		p.color.r == q.color.r && p.color.g == q.color.g && p.color.b == q.color.b && p.color.a == q.color.a;
+}
+
+//VEE_OK when the whole of `file` was read
+static int ReadBytes(const char* file, ArrayBytes* data) {
+	FILE* f = fopen(file, "rb");
+	if(f == NULL) return VEE_IO_ERROR;
+	data->size = 0;
+	uint8_t chunk[4096];
+	size_t n;
+	while((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+		if(Array_reserve(data, Array_size(data) + n) != VEE_OK) break;
+		memcpy(Array_data(data) + Array_size(data), chunk, n);
+		data->size += n;
+	}
+	int r = ferror(f) || !feof(f) ? VEE_IO_ERROR : VEE_OK;
+	fclose(f);
+	return r;
+}
+
+//decoding the damaged `data` has to fail with a VEE_* error and leave `w` alone
+static bool Rejected(const uint8_t* data, size_t size, ArrayWidget* w, ArrayDepthRank* depth, StringTable* t) {
+	w->size = 0;
+	StringTableClear(t);
+	int r = DecodeUIFile(data, size, w, 0, depth, t);
+	return r >= VEE_OUT_OF_MEMORY && r <= VEE_BAD_FORMAT && Array_size(w) == 0;
+}
+
+static int BenchLayoutFile() {
+	const char* file = "bench_layout.ui";
+	ArrayWidget w = {0}, back = {0};
+	ArrayDepthRank depth = {0}, backDepth = {0};
+	ArrayBytes data = {0}, damaged = {0};
+	StringTable t, tb;
+	int failed = 0;
+	size_t widgets = 0, bytes = 0, truncations = 0, flips = 0;
+	StringTableCreate(&t, NULL);
+	StringTableCreate(&tb, NULL);
+	double encode = 0, decode = 0;
+
+	for(int layout=0; layout<FILE_LAYOUTS && failed == 0; ++layout) {
+		StringTableClear(&t);
+		RandomLayout(&w, &depth, &t, (layout == 0) ? 0 : Random()%(FILE_MAX_WIDGETS+1));
+		double s = Now();
+		int r = WriteUIFile(file, &w, Array_data(&depth), StringTableData(&t), StringTableSize(&t));
+		encode += Now() - s;
+		if(r != VEE_OK || ReadBytes(file, &data) != VEE_OK) {
+			warn("failed to write `%s` (%i)", file, r);
+			++failed;
+			break;
+		}
+
+		back.size = 0;
+		StringTableClear(&tb);
+		s = Now();
+		r = DecodeUIFile(Array_data(&data), Array_size(&data), &back, 0, &backDepth, &tb);
+		decode += Now() - s;
+		if(r != (int)Array_size(&w) || Array_size(&back) != Array_size(&w)) {
+			warn("layout %i: decoded %i of %zu widgets", layout, r, Array_size(&w));
+			++failed;
+			break;
+		}
+		for(ArrayIt i=0; i<Array_size(&w); ++i) {
+			if(!SameWidget(Array_at(&w, i), &t, Array_at(&back, i), &tb) || Array_at(&depth, i) != Array_at(&backDepth, i)) {
+				warn("layout %i: widget %zu differs after a round trip", layout, i);
+				++failed;
+				break;
+			}
+		}
+		widgets += Array_size(&w);
+		bytes += Array_size(&data);
+		if(layout >= FILE_CORRUPTED_LAYOUTS) continue;
+
+		for(size_t n=0; n<Array_size(&data); ++n, ++truncations) {
+			if(!Rejected(Array_data(&data), n, &back, &backDepth, &tb)) {
+				warn("layout %i: truncated to %zu of %zu bytes and accepted", layout, n, Array_size(&data));
+				++failed;
+				break;
+			}
+		}
+		if(Array_reserve(&damaged, Array_size(&data)) != VEE_OK) break;
+		damaged.size = Array_size(&data);
+		for(int f=0; f<FILE_FLIPS; ++f, ++flips) {
+			memcpy(Array_data(&damaged), Array_data(&data), Array_size(&data));
+			size_t at = Random()%Array_size(&data);
+			uint8_t flip = 1 + Random()%255;
+			Array_at(&damaged, at) ^= flip;
+			if(!Rejected(Array_data(&damaged), Array_size(&damaged), &back, &backDepth, &tb)) {
+				warn("layout %i: byte %zu xor %02x of %zu accepted", layout, at, flip, Array_size(&data));
+				++failed;
+				break;
+			}
+		}
+	}
+
+	info("layout files (%zu widgets in %zu KB)", widgets, bytes/1024);
+	info("  write %8.3f ms  decode %8.3f ms  %zu truncations and %zu flips rejected", encode, decode, truncations, flips);
+	remove(file);
+	Array_destroy(&w);
+	Array_destroy(&back);
+	Array_destroy(&depth);
+	Array_destroy(&backDepth);
+	Array_destroy(&data);
+	Array_destroy(&damaged);
+	StringTableDestroy(&t);
+	StringTableDestroy(&tb);
+	return failed;
+}
+
+// -------
+// UNDO/REDO HISTORY
+// -------
+// A million random edits made the way the editor makes them, in chunks: every chunk is undone
+// back to the layout it started from and redone to the layout it ended with. Some edits are
+// grouped, some are undone and redone in the middle of a chunk and then overwritten.
+// Then the same edits with a small byte budget: the history has to stay within it, keep its
+// groups whole and undo back to the layout it had when its oldest entry was recorded.
+
+#define HISTORY_EDITS 1000000
+#define HISTORY_CHUNK 10000
+#define HISTORY_START_WIDGETS 1000
+#define HISTORY_MAX_WIDGETS 4000
+#define HISTORY_BUDGET (256*1024)
+#define HISTORY_BUDGET_EDITS 10000
+//every this many edits the budgeted history is undone and redone completely
+#define HISTORY_BUDGET_CHECK 1000
+
+typedef struct {
+	ArrayWidget w;
+	ArrayDepthRank ranks;
+} LayoutState;
+
+static int SaveState(LayoutState* s, const ArrayWidget* w, const DepthOrder* d) {
+	s->w.size = 0;
+	if(Array_reserve(&s->w, Array_size(w)) != VEE_OK || DepthOrderRanks(d, &s->ranks) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	memcpy(Array_data(&s->w), Array_data(w), Array_size(w)*sizeof(Widget));
+	s->w.size = Array_size(w);
+	return VEE_OK;
+}
+
+static bool SameProps(WidgetProps p, WidgetProps q) {
+	return p.set == q.set && p.text == q.text && p.items == q.items && SameFloat(p.min, q.min) && SameFloat(p.max, q.max) &&
+		SameFloat(p.value, q.value) && p.color.r == q.color.r && p.color.g == q.color.g && p.color.b == q.color.b && p.color.a == q.color.a;
+}
+
+//the widget in every slot and the draw order are the same
+static bool SameState(const LayoutState* s, const ArrayWidget* w, const DepthOrder* d, ArrayDepthRank* ranks) {
+	if(Array_size(&s->w) != Array_size(w) || DepthOrderRanks(d, ranks) != VEE_OK) return false;
+	for(ArrayIt i=0; i<Array_size(w); ++i) {
+		Widget a = Array_at(&s->w, i), b = Array_at(w, i);
+		if(a.type != b.type || a.id != b.id || !SameFloat(a.bounds.x, b.bounds.x) || !SameFloat(a.bounds.y, b.bounds.y) ||
+			!SameFloat(a.bounds.width, b.bounds.width) || !SameFloat(a.bounds.height, b.bounds.height) ||
+			!SameProps(a.props, b.props) || Array_at(&s->ranks, i) != Array_at(ranks, i)) return false;
+	}
+	return true;
+}
+
+//a slot of `d` or DEPTH_NONE
+static inline int RandomBelow(const DepthOrder* d, size_t n) {
+	return (n == 0 || Random()%16 == 0) ? DEPTH_NONE : (Random()%8 == 0) ? d->top : (int)(Random()%n);
+}
+
+static Widget RandomWidget(int id) {
+	return (Widget){ Random()%WIDGET_COUNT, { RandomFloat(0, 1000), RandomFloat(0, 800), RandomFloat(-20, 200), RandomFloat(-20, 200) }, id };
+}
+
+//One edit applied to `w` and `d` and recorded in `h` like the editor does it. Returns false when out of memory.
+static bool RandomEdit(History* h, ArrayWidget* w, DepthOrder* d, int* nextId, ArrayWidgetMove* moves) {
+	size_t n = Array_size(w);
+	int kind = Random()%16;
+	if(n >= HISTORY_MAX_WIDGETS && kind < 3) kind = 3;
+	if(n == 0) kind = 0;
+	switch(kind) {
+		case 0: case 1: { //added on top of something
+			int below = RandomBelow(d, n);
+			Widget x = RandomWidget((*nextId)++);
+			if(WidgetSwapInsert(w, n, x) != VEE_OK) return false;
+			if(DepthOrderSwapInsert(d, n, below) != VEE_OK) return false;
+			HistoryRecord(h, (HistoryEntry){ HISTORY_INSERT, n, .below = below, .widget = x });
+		} break;
+		case 2: { //a few pasted at once
+			size_t k = 1 + Random()%16;
+			int below = RandomBelow(d, n);
+			if(Array_reserve(w, n + k) != VEE_OK) return false;
+			for(size_t i=0; i<k; ++i) Array_at(w, n+i) = RandomWidget((*nextId)++);
+			w->size = n + k;
+			if(DepthOrderAppend(d, k, NULL, below) != VEE_OK) return false;
+			HistoryRecordRange(h, n, k, below);
+		} break;
+		case 3: case 4: { //removed, the last one takes its slot
+			int i = Random()%n;
+			Widget x = Array_at(w, i);
+			int below = DepthBelow(d, i);
+			WidgetSwapRemove(w, i);
+			DepthOrderSwapRemove(d, i);
+			HistoryRecord(h, (HistoryEntry){ HISTORY_REMOVE, i, .below = below, .widget = x });
+		} break;
+		case 5: case 6: case 7: case 8: { //resized, dragged or given other properties
+			int i = Random()%n;
+			Widget before = Array_at(w, i), *x = &Array_at(w, i);
+			if(Random()%2) x->bounds = RandomWidget(0).bounds;
+			else {
+				x->props.set = Random() & PROP_ALL;
+				x->props.value = RandomFloat(-10, 10);
+				x->props.color = (Color){ Random(), Random(), Random(), Random() };
+			}
+			if(Random()%4 == 0) HistoryBreak(h);
+			HistoryRecord(h, (HistoryEntry){ HISTORY_SET, i, .before = before, .widget = *x });
+		} break;
+		case 9: case 10: { //put above another one
+			int i = Random()%n, below = RandomBelow(d, n), oldBelow = DepthBelow(d, i);
+			if(i == below || oldBelow == below) break;
+			DepthOrderMove(d, i, below);
+			HistoryRecord(h, (HistoryEntry){ HISTORY_MOVE, i, .below = below, .oldBelow = oldBelow });
+		} break;
+		case 11: case 12: { //a selection dragged, the slots are sorted
+			moves->size = 0;
+			for(size_t i = Random()%8; i<n; i += 1 + Random()%64) {
+				WidgetMove m = { i, { Array_at(w, i).bounds.x, Array_at(w, i).bounds.y } };
+				if(Array_push(moves, m) != VEE_OK) return false;
+			}
+			if(Array_size(moves) == 0) break;
+			Vector2 offset = { RandomFloat(-100, 100), RandomFloat(-100, 100) };
+			TranslateWidgets(w, Array_data(moves), Array_size(moves), offset);
+			if(HistoryRecordTranslate(h, Array_data(moves), Array_size(moves), offset) != VEE_OK) return false;
+		} break;
+		case 13: HistoryBeginGroup(h); break;
+		default: HistoryEndGroup(h); break;
+	}
+	return true;
+}
+
+static int BenchHistory() {
+	ArrayWidget w = {0};
+	ArrayWidgetMove moves = {0};
+	ArrayDepthRank ranks = {0};
+	LayoutState before = {0}, after = {0};
+	DepthOrder d;
+	History h;
+	DepthOrderCreate(&d);
+	HistoryCreate(&h, SIZE_MAX);
+	int failed = 0, nextId = HISTORY_START_WIDGETS;
+	size_t edits = 0, undone = 0, redone = 0;
+	if(MakeLayout(&w, HISTORY_START_WIDGETS) != VEE_OK || DepthOrderAppend(&d, HISTORY_START_WIDGETS, NULL, DEPTH_NONE) != VEE_OK) {
+		warn("out of memory");
+		failed = 1;
+		goto done;
+	}
+
+	double t = Now(), undo = 0, redo = 0;
+	for(int chunk=0; chunk < HISTORY_EDITS/HISTORY_CHUNK && failed == 0; ++chunk) {
+		HistoryClear(&h);
+		HistoryEndGroup(&h);
+		if(SaveState(&before, &w, &d) != VEE_OK) { ++failed; break; }
+		for(int e=0; e<HISTORY_CHUNK; ++e, ++edits) {
+			if(!RandomEdit(&h, &w, &d, &nextId, &moves)) { warn("out of memory"); ++failed; break; }
+			//changed its mind: undo a few, redo some of them, the next edit drops the rest
+			if(Random()%64 == 0) {
+				int k = 1 + Random()%8, j = Random()%(k+1);
+				while(k-- > 0 && HistoryUndo(&h, &w, &d, NULL)) ++undone;
+				while(j-- > 0 && HistoryRedo(&h, &w, &d, NULL)) ++redone;
+			}
+		}
+		while(HistoryRedo(&h, &w, &d, NULL)) ++redone;
+		if(SaveState(&after, &w, &d) != VEE_OK) { ++failed; break; }
+
+		double s = Now();
+		while(HistoryUndo(&h, &w, &d, NULL)) ++undone;
+		undo += Now() - s;
+		if(!SameState(&before, &w, &d, &ranks)) {
+			warn("chunk %i: undoing every edit didn't give back the layout it started from", chunk);
+			++failed;
+			break;
+		}
+		s = Now();
+		while(HistoryRedo(&h, &w, &d, NULL)) ++redone;
+		redo += Now() - s;
+		if(!SameState(&after, &w, &d, &ranks)) {
+			warn("chunk %i: redoing every edit didn't give back the layout it ended with", chunk);
+			++failed;
+			break;
+		}
+	}
+	t = Now() - t;
+
+	info("history of %zu random edits (%zu widgets at the end)", edits, Array_size(&w));
+	info("  %zu undone, %zu redone in %.1f ms, undo all %.2f ms, redo all %.2f ms per %i edits", undone, redone, t,
+		undo/(HISTORY_EDITS/HISTORY_CHUNK), redo/(HISTORY_EDITS/HISTORY_CHUNK), HISTORY_CHUNK);
+
+done:
+	HistoryDestroy(&h);
+	DepthOrderDestroy(&d);
+	Array_destroy(&w);
+	Array_destroy(&moves);
+	Array_destroy(&ranks);
+	Array_destroy(&before.w);
+	Array_destroy(&before.ranks);
+	Array_destroy(&after.w);
+	Array_destroy(&after.ranks);
+	return failed;
+}
+
+typedef Array(uint64_t) ArrayStateHash;
+
+//fnv64-1a over what SameState() compares, a word at a time
+static uint64_t StateHash(const ArrayWidget* w, const DepthOrder* d, ArrayDepthRank* ranks) {
+	uint64_t h = 14695981039346656037ull ^ Array_size(w);
+	if(DepthOrderRanks(d, ranks) != VEE_OK) return 0;
+	for(ArrayIt i=0; i<Array_size(w); ++i) {
+		Widget x = Array_at(w, i);
+		Color c = x.props.color;
+		float f[7] = { x.bounds.x, x.bounds.y, x.bounds.width, x.bounds.height, x.props.min, x.props.max, x.props.value };
+		uint32_t v[14] = { x.type, x.id, x.props.set, x.props.text, x.props.items, 
+			c.r | c.g << 8 | c.b << 16 | (uint32_t)c.a << 24, Array_at(ranks, i) };
+		memcpy(&v[7], f, sizeof(f));
+		for(int k=0; k<14; ++k) h = (h ^ v[k]) * 1099511628211ull;
+	}
+	return h;
+}
+
+//Undo everything left in `h`, it has to give back the layout with hash `first`, and redo it
+//all to the layout with hash `last`
+static int CheckBudgetUndo(History* h, ArrayWidget* w, DepthOrder* d, ArrayDepthRank* ranks, uint64_t first, uint64_t last) {
+	int failed = 0;
+	while(HistoryUndo(h, w, d, NULL));
+	if(h->cursor != 0 || StateHash(w, d, ranks) != first) {
+		warn("undoing a trimmed history didn't give back the layout of its oldest entry");
+		++failed;
+	}
+	while(HistoryRedo(h, w, d, NULL));
+	if(h->cursor != Array_size(&h->entries) || StateHash(w, d, ranks) != last) {
+		warn("redoing a trimmed history didn't give back the layout it ended with");
+		++failed;
+	}
+	return failed;
+}
+
+static int BenchHistoryBudget() {
+	ArrayWidget w = {0};
+	ArrayWidgetMove moves = {0};
+	ArrayDepthRank ranks = {0};
+	ArrayStateHash hashes = {0}; //of the layout with every entry up to that one recorded, by entry
+	DepthOrder d;
+	History h;
+	DepthOrderCreate(&d);
+	HistoryCreate(&h, HISTORY_BUDGET);
+	int failed = 0, nextId = HISTORY_START_WIDGETS, trims = 0, checks = 0;
+	size_t dropped = 0, largest = 0; //entries trimmed so far, the most bytes the history held
+	if(MakeLayout(&w, HISTORY_START_WIDGETS) != VEE_OK || DepthOrderAppend(&d, HISTORY_START_WIDGETS, NULL, DEPTH_NONE) != VEE_OK ||
+		Array_push(&hashes, StateHash(&w, &d, &ranks)) != VEE_OK)
+	{
+		warn("out of memory");
+		failed = 1;
+		goto done;
+	}
+	
+	for(int e=1; e<=HISTORY_BUDGET_EDITS && failed == 0; ++e) {
+		size_t before = Array_size(&h.entries);
+		if(!RandomEdit(&h, &w, &d, &nextId, &moves)) { warn("out of memory"); ++failed; break; }
+		//only a new entry gets the history over the budget
+		if(Array_size(&h.entries) < before) {
+			dropped += before + 1 - Array_size(&h.entries);
+			++trims;
+		}
+		size_t n = dropped + Array_size(&h.entries);
+		if(Array_reserve(&hashes, n + 1) != VEE_OK) { warn("out of memory"); ++failed; break; }
+		hashes.size = n + 1;
+		Array_at(&hashes, n) = StateHash(&w, &d, &ranks);
+		
+		largest = (h.bytes > largest) ? h.bytes : largest;
+		if(h.bytes > h.budget) {
+			warn("edit %i: the history holds %zu bytes, over its budget of %zu", e, h.bytes, h.budget);
+			++failed;
+		}
+		if(Array_size(&h.entries) > 0 && Array_at(&h.entries, 0).joined) {
+			warn("edit %i: the oldest entry left is the middle of a group", e);
+			++failed;
+		}
+		if(e % HISTORY_BUDGET_CHECK == 0) {
+			failed += CheckBudgetUndo(&h, &w, &d, &ranks, Array_at(&hashes, dropped), Array_at(&hashes, n));
+			++checks;
+		}
+	}
+	
+	info("history of %i random edits within %i KB", HISTORY_BUDGET_EDITS, HISTORY_BUDGET/1024);
+	info("  %i trims dropped %zu entries, %zu left, %zu KB at most, undone and redone completely %i times", 
+		trims, dropped, Array_size(&h.entries), largest/1024, checks);
+	if(trims == 0) {
+		warn("the history never reached its budget");
+		++failed;
+	}
+
+done:
+	HistoryDestroy(&h);
+	DepthOrderDestroy(&d);
+	Array_destroy(&w);
+	Array_destroy(&moves);
+	Array_destroy(&ranks);
+	Array_destroy(&hashes);
+	return failed;
+}
+
+// -------
+// SPLIT TEXT
+// -------
+// The text work ToggleGroup, ComboBox and DropdownBox do every frame: split the element list
+// and get every element as a string. Drawing needs a window, so only this part is timed.
+
+#define SPLIT_CONTROLS 5000
+#define SPLIT_FRAMES 200
+#define SPLIT_LABEL_SIZE 128
+//raylib's TextSplitEx() writes past the arrays of raygui after 16 elements
+#define SPLIT_MAX_ELEMENTS 16
+
+static int BenchTextSplit() {
+	int failed = 0;
+	char (*labels)[SPLIT_LABEL_SIZE] = malloc(SPLIT_CONTROLS*SPLIT_LABEL_SIZE);
+	if(labels == NULL) {
+		warn("out of memory");
+		return 1;
+	}
+	for(int i=0; i<SPLIT_CONTROLS; ++i) {
+		int n = snprintf(labels[i], SPLIT_LABEL_SIZE, "Control %i", i);
+		for(int e=0; e<i%SPLIT_MAX_ELEMENTS && n < SPLIT_LABEL_SIZE-8; ++e) 
+			n += snprintf(&labels[i][n], SPLIT_LABEL_SIZE-n, ";Item %i", e);
+	}
+	
+	size_t sum = 0;
+	double t = Now();
+	for(int f=0; f<SPLIT_FRAMES; ++f) {
+		for(int i=0; i<SPLIT_CONTROLS; ++i) {
+			const char* ptrs[SPLIT_MAX_ELEMENTS];
+			int lengths[SPLIT_MAX_ELEMENTS], count = 0;
+			TextSplitEx(labels[i], ';', &count, ptrs, lengths);
+			for(int e=0; e<count; ++e) sum += strlen(TextSubtext(ptrs[e], 0, lengths[e]));
+		}
+	}
+	double split = (Now() - t)/SPLIT_FRAMES;
+	
+	size_t cachedSum = 0;
+	t = Now();
+	for(int f=0; f<SPLIT_FRAMES; ++f) {
+		for(int i=0; i<SPLIT_CONTROLS; ++i) {
+			int count = 0;
+			const char** elements = TextCacheSplit(labels[i], ';', &count);
+			for(int e=0; e<count; ++e) cachedSum += strlen(elements[e]);
+		}
+	}
+	double cached = (Now() - t)/SPLIT_FRAMES;
+	
+	//the same elements as raylib
+	for(int i=0; i<SPLIT_CONTROLS; ++i) {
+		const char* ptrs[SPLIT_MAX_ELEMENTS];
+		int lengths[SPLIT_MAX_ELEMENTS], count = 0, cachedCount = 0;
+		TextSplitEx(labels[i], ';', &count, ptrs, lengths);
+		const char** elements = TextCacheSplit(labels[i], ';', &cachedCount);
+		bool same = count == cachedCount;
+		for(int e=0; same && e<count; ++e) same = strcmp(TextSubtext(ptrs[e], 0, lengths[e]), elements[e]) == 0;
+		if(!same) {
+			warn("split of `%s` differs", labels[i]);
+			++failed;
+			break;
+		}
+	}
+	//a label changed in place is split again
+	strcpy(labels[0], "a;b;c");
+	int count = 0;
+	const char** elements = TextCacheSplit(labels[0], ';', &count);
+	if(count != 3 || strcmp(elements[2], "c") != 0) {
+		warn("split of a changed label is outdated");
+		++failed;
+	}
+	
+	//past the 1024 bytes and 16 elements of TextSplitEx()
+	char* list = malloc(10000*8);
+	if(list != NULL) {
+		int n = 0;
+		for(int e=0; e<10000; ++e) n += sprintf(&list[n], e ? ";%i" : "%i", e);
+		elements = TextCacheSplit(list, ';', &count);
+		if(count != 10000 || strcmp(elements[9999], "9999") != 0) {
+			warn("long list split into %i elements", count);
+			++failed;
+		}
+		free(list);
+	}
+	
+	TextCacheStats stats = TextCacheGetStats();
+	info("split text of %i controls (checksum %zu %zu)", SPLIT_CONTROLS, sum, cachedSum);
+	info("  TextSplitEx (per frame)  %8.3f ms", split);
+	info("  cached (per frame)       %8.3f ms  (%llu hits, %llu misses)", cached, 
+		(unsigned long long)stats.splitHits, (unsigned long long)stats.splitMisses);
+	free(labels);
+	TextCacheDestroy();
+	return failed;
+}
+
+
+
+// -------
+// GENERATED CODE
+// -------
+// Both export styles of a 10k and a 100k widget layout, compiled against raygui with the system
+// compiler, the 10k ones are also run for some frames. $CC, $BENCH_CFLAGS and $BENCH_LIBS say how
+// to build against raylib and raygui, by default from the root of the repository with raylib
+// installed. Code that doesn't compile fails the benchmarks, linking needs the raylib library
+// and running needs a display, these steps are reported as skipped when they fail.
+
+#define CODEGEN_WIDGETS 10000
+#define CODEGEN_FRAMES 300
+//only generated and compiled, not run
+#define CODEGEN_LARGE_WIDGETS 100000
+
+//runs DrawGUI() of a generated file (its main() is renamed away) and prints the average
+//time it took in ms
+static const char* FrameDriver = 
+	"#include <raylib.h>\n"
+	"#include <stdio.h>\n"
+	"void DrawGUI();\n"
+	"int main() {\n"
+	"    InitWindow(1280, 720, \"bench\");\n"
+	"    double total = 0;\n"
+	"    for(int f=0; f<FRAMES; ++f) {\n"
+	"        BeginDrawing();\n"
+	"        ClearBackground(RAYWHITE);\n"
+	"        double t = GetTime();\n"
+	"        DrawGUI();\n"
+	"        total += GetTime() - t;\n"
+	"        EndDrawing();\n"
+	"    }\n"
+	"    CloseWindow();\n"
+	"    printf(\"%f\\n\", total*1000.0/FRAMES);\n"
+	"    return 0;\n"
+	"}\n";
+
+static inline const char* Env(const char* name, const char* otherwise) {
+	const char* v = getenv(name);
+	return (v != NULL) ? v : otherwise;
+}
+
+static inline double FileSize(const char* path) {
+	struct stat st;
+	return (stat(path, &st) == 0) ? st.st_size/1024.0 : -1;
+}
+
+//run `cmd` and return how long it took in ms, -1 when it failed
+static double TimeCommand(const char* cmd) {
+	double t = WallNow();
+	if(system(cmd) != 0) return -1;
+	return WallNow() - t;
+}
+
+//Generate `w` in `style` and compile it, the object has to build. With `frames` the code is also
+//linked with the frame driver and run for that many frames, which may be skipped.
+static int GenerateAndCompile(const ArrayWidget* w, const StringTable* strings, CodeStyle style, int frames) {
+	static const char* names[CODE_STYLE_COUNT] = { "calls", "tables" };
+	const char* cc = Env("CC", "cc");
+	const char* cflags = Env("BENCH_CFLAGS", "-Iexternal");
+	const char* libs = Env("BENCH_LIBS", "-lraylib -lm -lpthread -ldl");
+	char cmd[1024], path[64];
+	snprintf(path, sizeof(path), "bench_%s.c", names[style]);
+	double t = Now();
+	if(ExportCode(path, w, strings, style) != VEE_OK) {
+		warn("failed to write `%s`", path);
+		return 1;
+	}
+	double generate = Now() - t;
+	double source = FileSize(path);
+
+	//the big layouts are only checked, compiling one function of 100k calls takes gigabytes and minutes
+	if(frames > 0) snprintf(cmd, sizeof(cmd), "%s -O2 -c -Dmain=GeneratedMain %s bench_%s.c -o bench_%s.o", cc, cflags, names[style], names[style]);
+	else snprintf(cmd, sizeof(cmd), "%s -fsyntax-only %s bench_%s.c", cc, cflags, names[style]);
+	double compile = TimeCommand(cmd);
+	snprintf(path, sizeof(path), "bench_%s.o", names[style]);
+	double object = (compile >= 0 && frames > 0) ? FileSize(path) : -1;
+	if(compile < 0) warn("the %s code of %zu widgets doesn't compile: %s", names[style], Array_size(w), cmd);
+
+	double frame = -1;
+	if(compile >= 0 && frames > 0) {
+		snprintf(cmd, sizeof(cmd), "%s -O2 -DFRAMES=%i %s bench_driver.c bench_%s.o -o bench_%s %s", 
+			cc, frames, cflags, names[style], names[style], libs);
+		snprintf(path, sizeof(path), "./bench_%s", names[style]);
+		FILE* p = (TimeCommand(cmd) >= 0) ? popen(path, "r") : NULL;
+		if(p != NULL) {
+			if(fscanf(p, "%lf", &frame) != 1) frame = -1;
+			pclose(p);
+		}
+	}
+
+	char c[16], o[16], fr[16];
+	snprintf(c, sizeof(c), (compile < 0) ? "FAILED" : (frames > 0) ? "%.0f ms" : "%.0f ms *", compile);
+	snprintf(o, sizeof(o), (object >= 0) ? "%.0f KB" : "-", object);
+	snprintf(fr, sizeof(fr), (frames <= 0 || compile < 0) ? "-" : (frame >= 0) ? "%.3f ms" : "skipped", frame);
+	info("  %-8s %7zu %7.0f KB %7.2f ms %10s %10s %10s", names[style], Array_size(w), source, generate, c, o, fr);
+
+	snprintf(path, sizeof(path), "bench_%s.c", names[style]);
+	remove(path);
+	snprintf(path, sizeof(path), "bench_%s.o", names[style]);
+	remove(path);
+	snprintf(path, sizeof(path), "bench_%s", names[style]);
+	remove(path);
+	return (compile < 0) ? 1 : 0;
+}
+
+static int BenchCodegen() {
+	static const size_t sizes[] = { CODEGEN_WIDGETS, CODEGEN_LARGE_WIDGETS };
+	ArrayWidget w = {0};
+	StringTable strings; //the layout sets no texts, every widget shows its label
+	int failed = 0;
+	if(StringTableCreate(&strings, NULL) != VEE_OK) {
+		warn("out of memory");
+		return 1;
+	}
+	FILE* f = fopen("bench_driver.c", "wb");
+	if(f != NULL) {
+		fputs(FrameDriver, f);
+		fclose(f);
+	}
+	
+	info("generated code");
+	info("  %-8s %7s %10s %10s %10s %10s %10s", "", "widgets", "source", "generate", "compile", "object", "frame");
+	for(size_t k=0; k<sizeof(sizes)/sizeof(sizes[0]); ++k) {
+		if(MakeLayout(&w, sizes[k]) != VEE_OK) {
+			warn("out of memory");
+			++failed;
+			break;
+		}
+		for(int style=0; style<CODE_STYLE_COUNT; ++style)
+			failed += GenerateAndCompile(&w, &strings, style, (sizes[k] == CODEGEN_WIDGETS) ? CODEGEN_FRAMES : 0);
+	}
+	info("  * syntax check only");
+	remove("bench_driver.c");
+	Array_destroy(&w);
+	StringTableDestroy(&strings);
+	return failed;
+}
+
+
+// -------
+// IMPORT
+// -------
+// A batch of files dropped at once: read one after the other into the widget array, the way
+// a single dropped file is, and read by the import workers then added in steps of
+// IMPORT_MERGE_STEP widgets the way the editor does it, one per frame.
+
+#define IMPORT_FILES 100
+#define IMPORT_FILE_WIDGETS 10000
+
+//order independent, the two ways add the files in the same order but that's not what's checked
+static uint64_t Checksum(const Widget* w, size_t n) {
+	uint64_t sum = 0;
+	for(size_t i=0; i<n; ++i) sum += (uint64_t)w[i].type*31 + (uint64_t)w[i].id*131 + (uint64_t)w[i].bounds.width;
+	return sum;
+}
+
+static int BenchImport() {
+	ArrayWidget w = {0};
+	char* files[IMPORT_FILES];
+	char names[IMPORT_FILES][32];
+	int failed = 0;
+	if(MakeLayout(&w, IMPORT_FILE_WIDGETS) != VEE_OK) {
+		warn("out of memory");
+		return 1;
+	}
+	for(int i=0; i<IMPORT_FILES; ++i) {
+		snprintf(names[i], sizeof(names[i]), "bench_import_%03i.ui", i);
+		files[i] = names[i];
+		if(WriteUIFile(files[i], &w, NULL, NULL, 0) != VEE_OK) {
+			warn("failed to write `%s`", files[i]);
+			++failed;
+		}
+	}
+	Array_destroy(&w);
+	if(failed > 0) goto done;
+
+	//one file after the other, each one grows the array to its exact size
+	ArrayDepthRank depth = {0};
+	StringTable strings;
+	StringTableCreate(&strings, NULL);
+	double t = WallNow();
+	for(int i=0; i<IMPORT_FILES; ++i) {
+		if(ReadUIFile(files[i], &w, Array_size(&w), &depth, &strings) != IMPORT_FILE_WIDGETS) {
+			warn("failed to read `%s`", files[i]);
+			++failed;
+			break;
+		}
+	}
+	double serial = WallNow() - t;
+	uint64_t serialSum = Checksum(Array_data(&w), Array_size(&w));
+	size_t serialCount = Array_size(&w);
+	Array_destroy(&w);
+	Array_destroy(&depth);
+	StringTableDestroy(&strings);
+
+	//the workers, then the steps the editor adds the batch in, one per frame
+	ArrayImportFile batch = {0};
+	t = WallNow();
+	bool queued = ImportFiles(files, IMPORT_FILES) == VEE_OK;
+	ImportWait();
+	double decode = WallNow() - t;
+	if(!queued || !ImportTake(&batch)) {
+		warn("the import workers didn't read the batch");
+		ImportClose();
+		++failed;
+		goto done;
+	}
+	ImportPlace(&batch, IMPORT_TILE);
+	size_t total = 0;
+	for(ArrayIt i=0; i<Array_size(&batch); ++i) total += (Array_at(&batch, i)->result > 0) ? Array_at(&batch, i)->result : 0;
+	SpatialIndex spatial;
+	WidgetBounds b;
+	ArrayStringRemap remap = {0};
+	SpatialIndexCreate(&spatial, 80);
+	BoundsCreate(&b, NULL);
+	StringTableCreate(&strings, NULL);
+	double merge = 0, worst = 0;
+	int steps = 0;
+	if(Array_reserve(&w, total) == VEE_OK) {
+		size_t file = 0, next = 0;
+		while(Array_size(&w) < total) {
+			t = WallNow();
+			size_t start = Array_size(&w);
+			for(size_t k=0; k<IMPORT_MERGE_STEP && file < Array_size(&batch); ++file, next = 0) {
+				ImportFile* f = Array_at(&batch, file);
+				if(f->result <= 0) continue;
+				if(next == 0 && StringTableLoad(&strings, StringTableData(&f->strings), StringTableSize(&f->strings), &remap) < 0) remap.size = 0;
+				for(; k<IMPORT_MERGE_STEP && next<(size_t)f->result; ++k, ++next) {
+					Widget wi = Array_at(&f->widgets, next);
+					wi.bounds.x += f->offset.x;
+					wi.bounds.y += f->offset.y;
+					if((wi.props.set & PROP_TEXT) && !StringRemapFind(&remap, wi.props.text, &wi.props.text)) wi.props.set &= ~PROP_TEXT;
+					Array_at(&w, w.size++) = wi;
+				}
+				if(next < (size_t)f->result) break;
+			}
+			for(size_t i=start; i<Array_size(&w); ++i) {
+				SpatialIndexInsert(&spatial, i, Array_at(&w, i).bounds);
+				BoundsSwapInsert(&b, i, Array_at(&w, i).bounds);
+			}
+			t = WallNow() - t;
+			merge += t;
+			worst = fmax(worst, t);
+			++steps;
+		}
+	}
+	ImportRelease(&batch);
+	ImportClose();
+	
+	//the alignment index takes the whole batch on its own thread once the last step is done
+	AlignIndex a;
+	AlignAppend job;
+	AlignIndexCreate(&a, NULL);
+	t = WallNow();
+	AlignAppendBegin(&job, &a, &w, 0);
+	AlignAppendEnd(&job, &a);
+	double aligned = WallNow() - t;
+
+	if(Array_size(&w) != serialCount || Checksum(Array_data(&w), Array_size(&w)) != serialSum) {
+		warn("imported %zu widgets, read %zu one file after the other", Array_size(&w), serialCount);
+		++failed;
+	}
+	if(BoundsSize(&b) != Array_size(&w) || Array_size(&a.lines[0]) != Array_size(&w)) {
+		warn("the bounds and alignment index have %zu and %zu of %zu widgets", BoundsSize(&b), Array_size(&a.lines[0]), Array_size(&w));
+		++failed;
+	}
+	info("%i dropped files of %i widgets", IMPORT_FILES, IMPORT_FILE_WIDGETS);
+	info("  one after the other      %8.2f ms", serial);
+	info("  import workers           %8.2f ms", decode);
+	info("  merge, %4i steps         %8.2f ms  (worst step %.2f ms, %.1f%% of a 60 fps frame)", steps, merge, worst, 100.0*worst/FRAME_BUDGET_MS);
+	info("  alignment thread         %8.2f ms", aligned);
+	Array_destroy(&w);
+	Array_destroy(&remap);
+	StringTableDestroy(&strings);
+	BoundsDestroy(&b);
+	SpatialIndexDestroy(&spatial);
+	AlignIndexDestroy(&a);
+
+done:
+	for(int i=0; i<IMPORT_FILES; ++i) remove(files[i]);
+	return failed;
+}
+
+#define ALLOC_ARRAYS 1000
+#define ALLOC_ITEMS 5000
+#define ALLOC_INSERTS 40000
+#define ALLOC_MIXED_ARRAYS 256
+#define ALLOC_MIXED_OPS 2000000
+
+//many arrays filled one push at a time (`exact` reserves their size first), then thrown away.
+//The arena drops them all at once.
+static uint64_t AllocAppend(Allocator* a, Arena* arena, bool exact, double* ms) {
+	ArrayWidget* w = calloc(ALLOC_ARRAYS, sizeof(ArrayWidget));
+	if(w == NULL) return 0;
+	double t = Now();
+	for(int i=0; i<ALLOC_ARRAYS; ++i) {
+		Array_create_with(&w[i], 0, a);
+		if(exact) Array_reserve_exact(&w[i], ALLOC_ITEMS);
+		for(int k=0; k<ALLOC_ITEMS; ++k) {
+			Widget x = { k % WIDGET_COUNT, (Rectangle){ k, i, 1, 1 }, k };
+			if(Array_push(&w[i], x) != VEE_OK) break;
+		}
+	}
+	*ms = Now() - t;
+	uint64_t sum = 0;
+	for(int i=0; i<ALLOC_ARRAYS; ++i) sum += Checksum(Array_data(&w[i]), Array_size(&w[i]));
+	t = Now();
+	for(int i=0; i<ALLOC_ARRAYS; ++i) Array_destroy(&w[i]);
+	if(arena != NULL) arena_reset(arena);
+	*ms += Now() - t;
+	free(w);
+	return sum;
+}
+
+//one array growing by inserts at random places, then shrinking by removes
+static uint64_t AllocInsertRemove(Allocator* a, double* ms) {
+	ArrayWidget w;
+	Array_create_with(&w, 0, a);
+	seed = 12345;
+	double t = Now();
+	for(int k=0; k<ALLOC_INSERTS; ++k) {
+		Widget x = { k % WIDGET_COUNT, (Rectangle){ k, 0, 1, 1 }, k };
+		size_t p = Random() % (Array_size(&w) + 1);
+		if(Array_insert(&w, p, &x, 1) != VEE_OK) break;
+	}
+	*ms = Now() - t;
+	uint64_t sum = Checksum(Array_data(&w), Array_size(&w));
+	t = Now();
+	while(Array_size(&w) > 0) Array_remove(&w, Random() % Array_size(&w), 1);
+	*ms += Now() - t;
+	Array_destroy(&w);
+	return sum;
+}
+
+//small arrays that are pushed to and thrown away at random, like per widget scratch lists
+static uint64_t AllocMixed(Allocator* a, double* ms) {
+	ArrayWidget w[ALLOC_MIXED_ARRAYS];
+	for(int i=0; i<ALLOC_MIXED_ARRAYS; ++i) Array_create_with(&w[i], 0, a);
+	seed = 12345;
+	uint64_t sum = 0;
+	double t = Now();
+	for(int k=0; k<ALLOC_MIXED_OPS; ++k) {
+		uint32_t r = Random();
+		ArrayWidget* x = &w[r % ALLOC_MIXED_ARRAYS];
+		if((r / ALLOC_MIXED_ARRAYS) % 64 == 0) {
+			sum += Array_size(x);
+			Array_destroy(x);
+			continue;
+		}
+		Widget v = { k % WIDGET_COUNT, (Rectangle){ k, 0, 1, 1 }, k };
+		if(Array_push(x, v) != VEE_OK) break;
+	}
+	for(int i=0; i<ALLOC_MIXED_ARRAYS; ++i) {
+		sum += Checksum(Array_data(&w[i]), Array_size(&w[i]));
+		Array_destroy(&w[i]);
+	}
+	*ms = Now() - t;
+	return sum;
+}
+
+//The allocators behind Array(T) against realloc(), they all have to end up with the same items
+static int BenchAllocators() {
+	Pool pool;
+	Arena arena;
+	pool_create(&pool);
+	arena_create(&arena, 0);
+	double ms[4][3] = {{0}};
+	uint64_t sum[4][3] = {{0}};
+	sum[0][0] = AllocAppend(NULL, NULL, false, &ms[0][0]);
+	sum[0][1] = AllocAppend(&pool.allocator, NULL, false, &ms[0][1]);
+	sum[1][0] = AllocAppend(NULL, NULL, true, &ms[1][0]);
+	sum[1][1] = AllocAppend(&pool.allocator, NULL, true, &ms[1][1]);
+	//the arena is reused like the frame arena, after the first round it has a block that fits everything
+	AllocAppend(&arena.allocator, &arena, true, &ms[1][2]);
+	sum[1][2] = AllocAppend(&arena.allocator, &arena, true, &ms[1][2]);
+	sum[2][0] = AllocInsertRemove(NULL, &ms[2][0]);
+	sum[2][1] = AllocInsertRemove(&pool.allocator, &ms[2][1]);
+	sum[3][0] = AllocMixed(NULL, &ms[3][0]);
+	sum[3][1] = AllocMixed(&pool.allocator, &ms[3][1]);
+	pool_destroy(&pool);
+	arena_destroy(&arena);
+	
+	int failed = 0;
+	if(sum[0][1] != sum[0][0] || sum[1][0] != sum[0][0] || sum[1][1] != sum[0][0] || sum[1][2] != sum[0][0] || 
+		sum[2][1] != sum[2][0] || sum[3][1] != sum[3][0])
+	{
+		warn("the allocators ended up with different items");
+		++failed;
+	}
+	char append[40], inserts[40], mixed[40];
+	snprintf(append, sizeof(append), "append %i x %i", ALLOC_ARRAYS, ALLOC_ITEMS);
+	snprintf(inserts, sizeof(inserts), "insert/remove %i at random", ALLOC_INSERTS);
+	snprintf(mixed, sizeof(mixed), "push/destroy %i, %i arrays", ALLOC_MIXED_OPS, ALLOC_MIXED_ARRAYS);
+	info("allocators, %zu byte items", sizeof(Widget));
+	info("  %-34s %11s %11s %11s", "", "realloc", "pool", "arena");
+	info("  %-34s %8.2f ms %8.2f ms", append, ms[0][0], ms[0][1]);
+	info("  %-34s %8.2f ms %8.2f ms %8.2f ms", "append, exact reserve", ms[1][0], ms[1][1], ms[1][2]);
+	info("  %-34s %8.2f ms %8.2f ms", inserts, ms[2][0], ms[2][1]);
+	info("  %-34s %8.2f ms %8.2f ms", mixed, ms[3][0], ms[3][1]);
+	return failed;
+}
+
+int RunBenchmarks() {
+	int failed = BenchBounds();
+	failed += BenchSpatial();
+	failed += BenchLayoutFile();
+	failed += BenchHistory();
+	failed += BenchHistoryBudget();
+	BenchSelection();
+	BenchAlign();
+	BenchLint();
+	failed += BenchTextSplit();
+	failed += BenchImport();
+	failed += BenchAllocators();
+	failed += BenchCodegen();
+	if(failed > 0) {
+		warn("%i checks failed", failed);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,24 @@
+#ifndef GE_BENCH_H
+#define GE_BENCH_H
+
+/* BENCHMARKS
+ * `editor --bench` checks every bounds kernel the CPU supports against the scalar one, times
+ * the batch kernels on a synthetic layout, times picking with the spatial grid against walking
+ * the depth order at 1k, 10k and 100k widgets (both have to pick the same widget), round trips
+ * random layouts through `.ui` files and feeds every truncation and random byte flips of them
+ * to the decoder (all of them have to be rejected), undoes and redoes a million random edits
+ * in chunks (every chunk has to come back to the layout it started and ended with), keeps a
+ * history of random edits within a 256 KB budget (it has to stay within it, keep its groups
+ * whole and undo back to the layout of its oldest entry), compares the cached text split of
+ * raygui's list controls with raylib's, times a batch of dropped files read by the import
+ * workers against reading them one after the other, times append, random insert/remove and
+ * push/destroy through the pool and arena allocators against realloc() and compares the two
+ * styles of generated code of a 10k and a 100k widget layout (size, compile time and the time
+ * DrawGUI() takes, the only part that opens a window).
+ * Returns EXIT_FAILURE when a kernel, a pick, a layout file, an undo/redo or a split gave
+ * a different result, a damaged layout file was accepted, a trimmed history broke its budget
+ * or its groups, the allocators ended up with different items or generated code didn't
+ * compile. */
+extern int RunBenchmarks();
+
+#endif
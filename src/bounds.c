@@ -0,0 +1,399 @@
+#include "bounds.h"
+
+#if !defined(GE_NO_SIMD) && (defined(__x86_64__) || defined(__SSE2__))
+	#define BOUNDS_SSE2
+	#include <emmintrin.h>
+	//the AVX2 versions are compiled for that target only, the rest of the build doesn't need it
+	#if defined(__GNUC__)
+		#define BOUNDS_AVX2
+		#include <immintrin.h>
+	#endif
+#endif
+
+void BoundsCreate(WidgetBounds* b, Allocator* a) {
+	Array_create_with(&b->x, 0, a);
+	Array_create_with(&b->y, 0, a);
+	Array_create_with(&b->w, 0, a);
+	Array_create_with(&b->h, 0, a);
+}
+
+void BoundsDestroy(WidgetBounds* b) {
+	Array_destroy(&b->x);
+	Array_destroy(&b->y);
+	Array_destroy(&b->w);
+	Array_destroy(&b->h);
+}
+
+static int Reserve(WidgetBounds* b, size_t n) {
+	if(Array_reserve(&b->x, n) != VEE_OK || Array_reserve(&b->y, n) != VEE_OK ||
+		Array_reserve(&b->w, n) != VEE_OK || Array_reserve(&b->h, n) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	return VEE_OK;
+}
+
+static inline void Resize(WidgetBounds* b, size_t n) {
+	b->x.size = b->y.size = b->w.size = b->h.size = n;
+}
+
+int BoundsLoad(WidgetBounds* b, const ArrayWidget* w) {
+	size_t n = Array_size(w);
+	if(Reserve(b, n) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	Resize(b, n);
+	for(size_t i=0; i<n; ++i) BoundsSet(b, i, Array_at(w, i).bounds);
+	return VEE_OK;
+}
+
+int BoundsCopy(WidgetBounds* dst, const WidgetBounds* src) {
+	size_t n = BoundsSize(src);
+	if(Reserve(dst, n) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	Resize(dst, n);
+	memcpy(Array_data(&dst->x), Array_data(&src->x), n*sizeof(float));
+	memcpy(Array_data(&dst->y), Array_data(&src->y), n*sizeof(float));
+	memcpy(Array_data(&dst->w), Array_data(&src->w), n*sizeof(float));
+	memcpy(Array_data(&dst->h), Array_data(&src->h), n*sizeof(float));
+	return VEE_OK;
+}
+
+int BoundsSwapInsert(WidgetBounds* b, int slot, Rectangle r) {
+	size_t n = BoundsSize(b);
+	if(slot < 0 || (size_t)slot > n) return VEE_BAD_ARG;
+	if(Reserve(b, n+1) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	Resize(b, n+1);
+	if((size_t)slot < n) BoundsSet(b, n, BoundsAt(b, slot));
+	BoundsSet(b, slot, r);
+	return VEE_OK;
+}
+
+void BoundsSwapRemove(WidgetBounds* b, int slot) {
+	size_t last = BoundsSize(b)-1;
+	BoundsSet(b, slot, BoundsAt(b, last));
+	Resize(b, last);
+}
+
+
+// -------
+// SCALAR
+// -------
+// One widget at a time. The SIMD versions use these for the widgets left over at the end.
+// MIN/MAX pick the same operand as minps/maxps so the results match with NaNs too.
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define SET_BIT(out, i) ((out)[(i)/64] |= (uint64_t)1 << ((i)%64))
+#define HAS_BIT(mask, i) (((mask)[(i)/64] >> ((i)%64)) & 1)
+
+static inline Rectangle Normalize(Rectangle r) {
+	if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+	if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+	return r;
+}
+
+static inline bool OverlapOne(const WidgetBounds* b, size_t i, Rectangle r) {
+	float x = Array_at(&b->x, i), y = Array_at(&b->y, i);
+	float x1 = x + Array_at(&b->w, i), y1 = y + Array_at(&b->h, i);
+	return MIN(x, x1) <= r.x+r.width && MAX(x, x1) >= r.x && MIN(y, y1) <= r.y+r.height && MAX(y, y1) >= r.y;
+}
+
+static inline bool ContainOne(const WidgetBounds* b, size_t i, Vector2 p) {
+	float x = Array_at(&b->x, i), y = Array_at(&b->y, i);
+	return p.x >= x && p.x <= x+Array_at(&b->w, i) && p.y >= y && p.y <= y+Array_at(&b->h, i);
+}
+
+static inline float SnapValue(float v, float grid) {
+	return (float)(int)(v/grid) * grid;
+}
+
+//returns true if the bounds changed
+static inline bool SnapOne(WidgetBounds* b, size_t i, float grid) {
+	Rectangle r = BoundsAt(b, i), s = { SnapValue(r.x, grid), SnapValue(r.y, grid),
+		SnapValue(r.width, grid), SnapValue(r.height, grid) };
+	BoundsSet(b, i, s);
+	return s.x != r.x || s.y != r.y || s.width != r.width || s.height != r.height;
+}
+
+static inline void TranslateOne(WidgetBounds* b, const WidgetBounds* from, size_t i, Vector2 d) {
+	Array_at(&b->x, i) = Array_at(&from->x, i) + d.x;
+	Array_at(&b->y, i) = Array_at(&from->y, i) + d.y;
+}
+
+//number of slots a masked kernel looks at
+static inline size_t MaskEnd(const WidgetBounds* b, size_t maskWords) {
+	return MIN(BoundsSize(b), maskWords*64);
+}
+
+static bool ScalarSupported() { return true; }
+
+static void ScalarOverlap(const WidgetBounds* b, Rectangle r, uint64_t* out) {
+	r = Normalize(r);
+	for(size_t i=0; i<BoundsSize(b); ++i)
+		if(OverlapOne(b, i, r)) SET_BIT(out, i);
+}
+
+static void ScalarContain(const WidgetBounds* b, Vector2 p, uint64_t* out) {
+	for(size_t i=0; i<BoundsSize(b); ++i)
+		if(ContainOne(b, i, p)) SET_BIT(out, i);
+}
+
+static void ScalarSnap(WidgetBounds* b, const uint64_t* mask, size_t maskWords, float grid, uint64_t* out) {
+	size_t end = MaskEnd(b, maskWords);
+	for(size_t i=0; i<end; ++i)
+		if(HAS_BIT(mask, i) && SnapOne(b, i, grid)) SET_BIT(out, i);
+}
+
+static void ScalarTranslate(WidgetBounds* b, const WidgetBounds* from, const uint64_t* mask, size_t maskWords, Vector2 d) {
+	size_t end = MaskEnd(b, maskWords);
+	for(size_t i=0; i<end; ++i)
+		if(HAS_BIT(mask, i)) TranslateOne(b, from, i, d);
+}
+
+static const BoundsKernels scalarKernels = {
+	"scalar", ScalarSupported, ScalarOverlap, ScalarContain, ScalarSnap, ScalarTranslate
+};
+
+
+// -------
+// SSE2
+// -------
+// 4 widgets at a time. Masked kernels skip empty words of the mask and empty groups of 4.
+
+#ifdef BOUNDS_SSE2
+
+static bool SSE2Supported() { return true; }
+
+//lanes whose bit is set in the lowest 4 bits of `m`
+static inline __m128 SSE2LaneMask(unsigned m) {
+	const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+	return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(m), bits), bits));
+}
+
+static inline __m128 SSE2Select(__m128 m, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+
+static void SSE2Overlap(const WidgetBounds* b, Rectangle r, uint64_t* out) {
+	r = Normalize(r);
+	const __m128 rx0 = _mm_set1_ps(r.x), ry0 = _mm_set1_ps(r.y);
+	const __m128 rx1 = _mm_set1_ps(r.x+r.width), ry1 = _mm_set1_ps(r.y+r.height);
+	size_t n = BoundsSize(b), i = 0;
+	for(; i+4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(&Array_at(&b->x, i)), y = _mm_loadu_ps(&Array_at(&b->y, i));
+		__m128 x1 = _mm_add_ps(x, _mm_loadu_ps(&Array_at(&b->w, i)));
+		__m128 y1 = _mm_add_ps(y, _mm_loadu_ps(&Array_at(&b->h, i)));
+		__m128 hit = _mm_and_ps(
+			_mm_and_ps(_mm_cmple_ps(_mm_min_ps(x, x1), rx1), _mm_cmpge_ps(_mm_max_ps(x, x1), rx0)),
+			_mm_and_ps(_mm_cmple_ps(_mm_min_ps(y, y1), ry1), _mm_cmpge_ps(_mm_max_ps(y, y1), ry0)));
+		out[i/64] |= (uint64_t)_mm_movemask_ps(hit) << (i%64);
+	}
+	for(; i<n; ++i)
+		if(OverlapOne(b, i, r)) SET_BIT(out, i);
+}
+
+static void SSE2Contain(const WidgetBounds* b, Vector2 p, uint64_t* out) {
+	const __m128 px = _mm_set1_ps(p.x), py = _mm_set1_ps(p.y);
+	size_t n = BoundsSize(b), i = 0;
+	for(; i+4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps(&Array_at(&b->x, i)), y = _mm_loadu_ps(&Array_at(&b->y, i));
+		__m128 x1 = _mm_add_ps(x, _mm_loadu_ps(&Array_at(&b->w, i)));
+		__m128 y1 = _mm_add_ps(y, _mm_loadu_ps(&Array_at(&b->h, i)));
+		__m128 hit = _mm_and_ps(
+			_mm_and_ps(_mm_cmpge_ps(px, x), _mm_cmple_ps(px, x1)),
+			_mm_and_ps(_mm_cmpge_ps(py, y), _mm_cmple_ps(py, y1)));
+		out[i/64] |= (uint64_t)_mm_movemask_ps(hit) << (i%64);
+	}
+	for(; i<n; ++i)
+		if(ContainOne(b, i, p)) SET_BIT(out, i);
+}
+
+static inline __m128 SSE2SnapValue(__m128 v, __m128 grid) {
+	return _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(v, grid))), grid);
+}
+
+static void SSE2Snap(WidgetBounds* b, const uint64_t* mask, size_t maskWords, float grid, uint64_t* out) {
+	const __m128 g = _mm_set1_ps(grid);
+	size_t end = MaskEnd(b, maskWords);
+	for(size_t k=0; k*64 < end; ++k) {
+		if(mask[k] == 0) continue;
+		size_t i = k*64, stop = MIN(end, i+64);
+		for(; i+4 <= stop; i += 4) {
+			unsigned m = (mask[k] >> (i%64)) & 0xF;
+			if(m == 0) continue;
+			__m128 lanes = SSE2LaneMask(m), changed = _mm_setzero_ps();
+			float* v[4] = { &Array_at(&b->x, i), &Array_at(&b->y, i), &Array_at(&b->w, i), &Array_at(&b->h, i) };
+			for(int c=0; c<4; ++c) {
+				__m128 old = _mm_loadu_ps(v[c]), s = SSE2SnapValue(old, g);
+				changed = _mm_or_ps(changed, _mm_cmpneq_ps(s, old));
+				_mm_storeu_ps(v[c], SSE2Select(lanes, s, old));
+			}
+			out[k] |= (uint64_t)(_mm_movemask_ps(changed) & m) << (i%64);
+		}
+		for(; i<stop; ++i)
+			if(HAS_BIT(mask, i) && SnapOne(b, i, grid)) SET_BIT(out, i);
+	}
+}
+
+static void SSE2Translate(WidgetBounds* b, const WidgetBounds* from, const uint64_t* mask, size_t maskWords, Vector2 d) {
+	const __m128 dx = _mm_set1_ps(d.x), dy = _mm_set1_ps(d.y);
+	size_t end = MaskEnd(b, maskWords);
+	for(size_t k=0; k*64 < end; ++k) {
+		if(mask[k] == 0) continue;
+		size_t i = k*64, stop = MIN(end, i+64);
+		for(; i+4 <= stop; i += 4) {
+			unsigned m = (mask[k] >> (i%64)) & 0xF;
+			if(m == 0) continue;
+			__m128 lanes = SSE2LaneMask(m);
+			__m128 x = _mm_add_ps(_mm_loadu_ps(&Array_at(&from->x, i)), dx);
+			__m128 y = _mm_add_ps(_mm_loadu_ps(&Array_at(&from->y, i)), dy);
+			_mm_storeu_ps(&Array_at(&b->x, i), SSE2Select(lanes, x, _mm_loadu_ps(&Array_at(&b->x, i))));
+			_mm_storeu_ps(&Array_at(&b->y, i), SSE2Select(lanes, y, _mm_loadu_ps(&Array_at(&b->y, i))));
+		}
+		for(; i<stop; ++i)
+			if(HAS_BIT(mask, i)) TranslateOne(b, from, i, d);
+	}
+}
+
+static const BoundsKernels sse2Kernels = {
+	"sse2", SSE2Supported, SSE2Overlap, SSE2Contain, SSE2Snap, SSE2Translate
+};
+
+#endif
+
+
+// -------
+// AVX2
+// -------
+// Same as the SSE2 versions with 8 widgets at a time.
+
+#ifdef BOUNDS_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+static bool AVX2Supported() { return __builtin_cpu_supports("avx2"); }
+
+AVX2 static inline __m256 AVX2LaneMask(unsigned m) {
+	const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+	return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(m), bits), bits));
+}
+
+AVX2 static void AVX2Overlap(const WidgetBounds* b, Rectangle r, uint64_t* out) {
+	r = Normalize(r);
+	const __m256 rx0 = _mm256_set1_ps(r.x), ry0 = _mm256_set1_ps(r.y);
+	const __m256 rx1 = _mm256_set1_ps(r.x+r.width), ry1 = _mm256_set1_ps(r.y+r.height);
+	size_t n = BoundsSize(b), i = 0;
+	for(; i+8 <= n; i += 8) {
+		__m256 x = _mm256_loadu_ps(&Array_at(&b->x, i)), y = _mm256_loadu_ps(&Array_at(&b->y, i));
+		__m256 x1 = _mm256_add_ps(x, _mm256_loadu_ps(&Array_at(&b->w, i)));
+		__m256 y1 = _mm256_add_ps(y, _mm256_loadu_ps(&Array_at(&b->h, i)));
+		__m256 hit = _mm256_and_ps(
+			_mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(x, x1), rx1, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_max_ps(x, x1), rx0, _CMP_GE_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(_mm256_min_ps(y, y1), ry1, _CMP_LE_OQ), _mm256_cmp_ps(_mm256_max_ps(y, y1), ry0, _CMP_GE_OQ)));
+		out[i/64] |= (uint64_t)_mm256_movemask_ps(hit) << (i%64);
+	}
+	for(; i<n; ++i)
+		if(OverlapOne(b, i, r)) SET_BIT(out, i);
+}
+
+AVX2 static void AVX2Contain(const WidgetBounds* b, Vector2 p, uint64_t* out) {
+	const __m256 px = _mm256_set1_ps(p.x), py = _mm256_set1_ps(p.y);
+	size_t n = BoundsSize(b), i = 0;
+	for(; i+8 <= n; i += 8) {
+		__m256 x = _mm256_loadu_ps(&Array_at(&b->x, i)), y = _mm256_loadu_ps(&Array_at(&b->y, i));
+		__m256 x1 = _mm256_add_ps(x, _mm256_loadu_ps(&Array_at(&b->w, i)));
+		__m256 y1 = _mm256_add_ps(y, _mm256_loadu_ps(&Array_at(&b->h, i)));
+		__m256 hit = _mm256_and_ps(
+			_mm256_and_ps(_mm256_cmp_ps(px, x, _CMP_GE_OQ), _mm256_cmp_ps(px, x1, _CMP_LE_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(py, y, _CMP_GE_OQ), _mm256_cmp_ps(py, y1, _CMP_LE_OQ)));
+		out[i/64] |= (uint64_t)_mm256_movemask_ps(hit) << (i%64);
+	}
+	for(; i<n; ++i)
+		if(ContainOne(b, i, p)) SET_BIT(out, i);
+}
+
+AVX2 static void AVX2Snap(WidgetBounds* b, const uint64_t* mask, size_t maskWords, float grid, uint64_t* out) {
+	const __m256 g = _mm256_set1_ps(grid);
+	size_t end = MaskEnd(b, maskWords);
+	for(size_t k=0; k*64 < end; ++k) {
+		if(mask[k] == 0) continue;
+		size_t i = k*64, stop = MIN(end, i+64);
+		for(; i+8 <= stop; i += 8) {
+			unsigned m = (mask[k] >> (i%64)) & 0xFF;
+			if(m == 0) continue;
+			__m256 lanes = AVX2LaneMask(m), changed = _mm256_setzero_ps();
+			float* v[4] = { &Array_at(&b->x, i), &Array_at(&b->y, i), &Array_at(&b->w, i), &Array_at(&b->h, i) };
+			for(int c=0; c<4; ++c) {
+				__m256 old = _mm256_loadu_ps(v[c]);
+				__m256 s = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_div_ps(old, g))), g);
+				changed = _mm256_or_ps(changed, _mm256_cmp_ps(s, old, _CMP_NEQ_UQ));
+				_mm256_storeu_ps(v[c], _mm256_blendv_ps(old, s, lanes));
+			}
+			out[k] |= (uint64_t)(_mm256_movemask_ps(changed) & m) << (i%64);
+		}
+		for(; i<stop; ++i)
+			if(HAS_BIT(mask, i) && SnapOne(b, i, grid)) SET_BIT(out, i);
+	}
+}
+
+AVX2 static void AVX2Translate(WidgetBounds* b, const WidgetBounds* from, const uint64_t* mask, size_t maskWords, Vector2 d) {
+	const __m256 dx = _mm256_set1_ps(d.x), dy = _mm256_set1_ps(d.y);
+	size_t end = MaskEnd(b, maskWords);
+	for(size_t k=0; k*64 < end; ++k) {
+		if(mask[k] == 0) continue;
+		size_t i = k*64, stop = MIN(end, i+64);
+		for(; i+8 <= stop; i += 8) {
+			unsigned m = (mask[k] >> (i%64)) & 0xFF;
+			if(m == 0) continue;
+			__m256 lanes = AVX2LaneMask(m);
+			__m256 x = _mm256_add_ps(_mm256_loadu_ps(&Array_at(&from->x, i)), dx);
+			__m256 y = _mm256_add_ps(_mm256_loadu_ps(&Array_at(&from->y, i)), dy);
+			_mm256_storeu_ps(&Array_at(&b->x, i), _mm256_blendv_ps(_mm256_loadu_ps(&Array_at(&b->x, i)), x, lanes));
+			_mm256_storeu_ps(&Array_at(&b->y, i), _mm256_blendv_ps(_mm256_loadu_ps(&Array_at(&b->y, i)), y, lanes));
+		}
+		for(; i<stop; ++i)
+			if(HAS_BIT(mask, i)) TranslateOne(b, from, i, d);
+	}
+}
+
+static const BoundsKernels avx2Kernels = {
+	"avx2", AVX2Supported, AVX2Overlap, AVX2Contain, AVX2Snap, AVX2Translate
+};
+
+#endif
+
+
+// -------
+// DISPATCH
+// -------
+
+const BoundsKernels* const BoundsKernelList[] = {
+	&scalarKernels,
+#ifdef BOUNDS_SSE2
+	&sse2Kernels,
+#endif
+#ifdef BOUNDS_AVX2
+	&avx2Kernels,
+#endif
+	NULL
+};
+
+//the last supported one of the list
+static const BoundsKernels* Kernels() {
+	static const BoundsKernels* best = NULL;
+	if(best == NULL) {
+		for(int i=0; BoundsKernelList[i] != NULL; ++i)
+			if(BoundsKernelList[i]->supported()) best = BoundsKernelList[i];
+	}
+	return best;
+}
+
+void BoundsOverlap(const WidgetBounds* b, Rectangle r, uint64_t* out) {
+	Kernels()->overlap(b, r, out);
+}
+
+void BoundsContain(const WidgetBounds* b, Vector2 p, uint64_t* out) {
+	Kernels()->contain(b, p, out);
+}
+
+void BoundsSnap(WidgetBounds* b, const uint64_t* mask, size_t maskWords, float grid, uint64_t* out) {
+	Kernels()->snap(b, mask, maskWords, grid, out);
+}
+
+void BoundsTranslate(WidgetBounds* b, const WidgetBounds* from, const uint64_t* mask, size_t maskWords, Vector2 d) {
+	Kernels()->translate(b, from, mask, maskWords, d);
+}
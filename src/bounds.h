@@ -0,0 +1,79 @@
+#ifndef GE_BOUNDS_H
+#define GE_BOUNDS_H
+
+#include "editor.h"
+
+/* WIDGET BOUNDS
+ * Structure of arrays copy of the bounds of every widget (slot `i` of the widget array is
+ * x[i], y[i], w[i], h[i]) so bulk geometry passes can test several widgets per instruction.
+ * It's changed the same way as the widget array (see WidgetSwapInsert()/WidgetSwapRemove())
+ * and has to be kept in sync by whoever changes the widgets, like the spatial index.
+ *
+ * The kernels come in a scalar, SSE2 and AVX2 version. The fastest one the CPU supports is
+ * picked on first use, define GE_NO_SIMD to build with the scalar one only. All of them give
+ * the same results bit for bit. Bitsets have the bit of slot `i` at bit `i % 64` of word `i / 64`
+ * (the same layout as Selection). */
+
+typedef Array(float) ArrayFloat;
+
+typedef struct {
+	ArrayFloat x, y, w, h;
+} WidgetBounds;
+
+extern void BoundsCreate(WidgetBounds* b, Allocator* a);
+extern void BoundsDestroy(WidgetBounds* b);
+/** Copy the bounds of all the widgets in `w`. Returns VEE_OK[0] on success. */
+extern int BoundsLoad(WidgetBounds* b, const ArrayWidget* w);
+/** Make `dst` a copy of `src`. Returns VEE_OK[0] on success. */
+extern int BoundsCopy(WidgetBounds* dst, const WidgetBounds* src);
+/** Same as WidgetSwapInsert(). Returns VEE_OK[0] on success. */
+extern int BoundsSwapInsert(WidgetBounds* b, int slot, Rectangle r);
+/** Same as WidgetSwapRemove(). */
+extern void BoundsSwapRemove(WidgetBounds* b, int slot);
+
+static inline size_t BoundsSize(const WidgetBounds* b) { return Array_size(&b->x); }
+
+static inline void BoundsSet(WidgetBounds* b, int slot, Rectangle r) {
+	Array_at(&b->x, slot) = r.x;
+	Array_at(&b->y, slot) = r.y;
+	Array_at(&b->w, slot) = r.width;
+	Array_at(&b->h, slot) = r.height;
+}
+
+static inline Rectangle BoundsAt(const WidgetBounds* b, int slot) {
+	return (Rectangle){ Array_at(&b->x, slot), Array_at(&b->y, slot), Array_at(&b->w, slot), Array_at(&b->h, slot) };
+}
+
+
+// -------
+// KERNELS
+// -------
+// `mask` is a bitset of `maskWords` words that limits a kernel to some of the widgets (slots past
+// the end of the mask are left alone). Results are added to the bitset `out`, which must have
+// room for every widget.
+
+/** Sets the bit of every widget that overlaps `r`. Widgets with negative sizes cover the
+ * area they were resized over. */
+extern void BoundsOverlap(const WidgetBounds* b, Rectangle r, uint64_t* out);
+/** Sets the bit of every widget that contains `p`, same as CheckCollisionPointRec(). */
+extern void BoundsContain(const WidgetBounds* b, Vector2 p, uint64_t* out);
+/** Snap the x, y, width and height of the masked widgets to multiples of `grid` (rounding
+ * towards zero like an int cast) and set the bit of those that changed in `out`. */
+extern void BoundsSnap(WidgetBounds* b, const uint64_t* mask, size_t maskWords, float grid, uint64_t* out);
+/** Put the masked widgets at the position they have in `from` plus `d` (`from` may be `b`
+ * to move them by `d`). Only x and y of `from` are read. */
+extern void BoundsTranslate(WidgetBounds* b, const WidgetBounds* from, const uint64_t* mask, size_t maskWords, Vector2 d);
+
+typedef struct {
+	const char* name;
+	bool (*supported)();
+	void (*overlap)(const WidgetBounds* b, Rectangle r, uint64_t* out);
+	void (*contain)(const WidgetBounds* b, Vector2 p, uint64_t* out);
+	void (*snap)(WidgetBounds* b, const uint64_t* mask, size_t maskWords, float grid, uint64_t* out);
+	void (*translate)(WidgetBounds* b, const WidgetBounds* from, const uint64_t* mask, size_t maskWords, Vector2 d);
+} BoundsKernels;
+
+//every version built in (scalar first, it's the reference for the others), NULL terminated
+extern const BoundsKernels* const BoundsKernelList[];
+
+#endif
@@ -0,0 +1,775 @@
+#include "codegen.h"
+#include "widgets.h"
+#include "hierarchy.h"
+#include <limits.h>
+#include <math.h>
+#include <stddef.h> //for offsetof()
+
+typedef Array(char) ArrayChar;
+
+//growable output buffer that gets flushed to `f` in large blocks
+typedef struct {
+	ArrayChar buf;
+	FILE* f;
+	int error;
+	const StringTable* strings; //of the widgets
+	int textSize;               //$S in the tables, the longest text of the layout
+} CodeWriter;
+
+static void Flush(CodeWriter* cw) {
+	size_t size = Array_size(&cw->buf);
+	if(size != 0 && cw->error == VEE_OK && fwrite(Array_data(&cw->buf), 1, size, cw->f) != size)
+		cw->error = VEE_IO_ERROR;
+	cw->buf.size = 0;
+}
+
+static inline void Write(CodeWriter* cw, const char* s, size_t n) {
+	if(Array_reserve(&cw->buf, Array_size(&cw->buf) + n) != VEE_OK) {
+		cw->error = VEE_OUT_OF_MEMORY;
+		return;
+	}
+	memcpy(&Array_at(&cw->buf, Array_size(&cw->buf)), s, n);
+	cw->buf.size += n;
+	if(Array_size(&cw->buf) >= CODEGEN_FLUSH_SIZE) Flush(cw);
+}
+
+static inline void WriteString(CodeWriter* cw, const char* s) {
+	Write(cw, s, strlen(s));
+}
+
+static inline void WriteInt(CodeWriter* cw, int v) {
+	char tmp[12];
+	char* p = &tmp[sizeof(tmp)];
+	unsigned int u = (v < 0) ? -(unsigned int)v : (unsigned int)v;
+	do { *--p = '0' + u%10; u /= 10; } while(u != 0);
+	if(v < 0) *--p = '-';
+	Write(cw, p, &tmp[sizeof(tmp)] - p);
+}
+
+//`v` as a float literal, with as few digits as read back the same
+static void WriteFloat(CodeWriter* cw, float v) {
+	char tmp[32];
+	int n = 0;
+	for(int digits = 6; digits <= 9; ++digits) {
+		n = snprintf(tmp, sizeof(tmp), "%.*g", digits, v);
+		if(strtof(tmp, NULL) == v) break;
+	}
+	Write(cw, tmp, n);
+	if(strpbrk(tmp, ".e") == NULL) Write(cw, ".", 1);
+	Write(cw, "f", 1);
+}
+
+//the `n` bytes at `s` as a string literal
+static void WriteCString(CodeWriter* cw, const char* s, size_t n) {
+	Write(cw, "\"", 1);
+	for(size_t i=0; i<n; ++i) {
+		//copy everything up to the next character that needs an escape in one go
+		size_t run = i;
+		while(run < n && s[run] != '"' && s[run] != '\\' && (unsigned char)s[run] >= 0x20 && s[run] != 0x7f) ++run;
+		Write(cw, &s[i], run - i);
+		if(run == n) break;
+		i = run;
+		char e[5];
+		switch(s[i]) {
+			case '"': Write(cw, "\\\"", 2); break;
+			case '\\': Write(cw, "\\\\", 2); break;
+			case '\n': Write(cw, "\\n", 2); break;
+			case '\t': Write(cw, "\\t", 2); break;
+			default:
+				snprintf(e, sizeof(e), "\\%03o", (unsigned char)s[i]);
+				Write(cw, e, 4);
+			break;
+		}
+	}
+	Write(cw, "\"", 1);
+}
+
+static inline void WriteColor(CodeWriter* cw, Color c) {
+	WriteInt(cw, c.r); Write(cw, ", ", 2);
+	WriteInt(cw, c.g); Write(cw, ", ", 2);
+	WriteInt(cw, c.b); Write(cw, ", ", 2);
+	WriteInt(cw, c.a);
+}
+
+static inline int ToInt(float v) {
+	return (v >= (float)INT_MAX) ? INT_MAX : (v <= (float)INT_MIN) ? INT_MIN : (int)v;
+}
+
+//size of a text box buffer holding `text`
+static inline int TextSize(const char* text) {
+	size_t n = strlen(text) + 1;
+	return (n < 32) ? 32 : (n > INT_MAX) ? INT_MAX : (int)n;
+}
+
+//number of `;` separated items in `items`
+static int ItemCount(const char* items) {
+	int count = 1;
+	for(const char* s = strchr(items, ';'); s != NULL; s = strchr(s+1, ';')) ++count;
+	return count;
+}
+
+//the items of `items` as string literals, separated by `sep`
+static void WriteItems(CodeWriter* cw, const char* items, const char* sep) {
+	for(const char* s = items;; ++s) {
+		const char* e = strchr(s, ';');
+		size_t n = (e != NULL) ? (size_t)(e - s) : strlen(s);
+		WriteCString(cw, s, n);
+		if(e == NULL) break;
+		WriteString(cw, sep);
+		s = e;
+	}
+}
+
+//number property `f` of the widget, or column `column` of its row in the tables
+static void WriteNumber(CodeWriter* cw, const WidgetValues* v, float f, const char* column, bool real) {
+	if(v == NULL) {
+		if(!real) WriteString(cw, "(int)");
+		WriteString(cw, column);
+	}
+	else if(real) WriteFloat(cw, f);
+	else WriteInt(cw, ToInt(f));
+}
+
+//true when template `code` has one of the substitutions in `tokens`
+static bool Uses(const char* code, const char* tokens) {
+	if(code == NULL) return false;
+	for(const char* s = strchr(code, '$'); s != NULL && s[1] != '\0'; s = strchr(s+2, '$')) {
+		if(strchr(tokens, s[1]) != NULL) return true;
+	}
+	return false;
+}
+
+static inline void WriteIndent(CodeWriter* cw, int depth) {
+	for(int i=0; i<depth; ++i) Write(cw, "    ", 4);
+}
+
+//where the widgets inside a container are placed from
+typedef struct {
+	int id;   //of the container, -1 outside of every container
+	int x, y; //of the container
+} Origin;
+
+//`v` as an offset from the `axis` of origin `o`
+static void WriteCoord(CodeWriter* cw, Origin o, char axis, int v) {
+	if(o.id == -1) {
+		WriteInt(cw, v);
+		return;
+	}
+	v -= (axis == 'x') ? o.x : o.y;
+	WriteString(cw, "origin");
+	WriteInt(cw, o.id);
+	Write(cw, (axis == 'x') ? ".x" : ".y", 2);
+	if(v >= 0) Write(cw, "+", 1);
+	WriteInt(cw, v);
+}
+
+//expand template `code` for widget `w` with properties `v`, NULL in the dispatch loop of the tables
+//where they are the columns of row `i`. `content` is the space the widgets inside it take.
+//The lines after the first one are indented by `depth`.
+static void WriteTemplate(CodeWriter* cw, const char* code, Widget w, const WidgetValues* v, Origin o, Rectangle content, int depth) {
+	for(const char* s = code; *s != '\0'; ++s) {
+		//copy everything up to the next substitution or line break in one go
+		const char* e = strpbrk(s, "$\n");
+		if(e == NULL) {
+			WriteString(cw, s);
+			break;
+		}
+		Write(cw, s, e-s);
+		s = e;
+		if(*s == '\n') {
+			Write(cw, "\n", 1);
+			WriteIndent(cw, depth);
+			continue;
+		}
+		++s;
+		switch(*s) {
+			case 'B':
+				WriteString(cw, "(Rectangle){");
+				WriteCoord(cw, o, 'x', (int)w.bounds.x); Write(cw, ",", 1);
+				WriteCoord(cw, o, 'y', (int)w.bounds.y); Write(cw, ",", 1);
+				WriteInt(cw, (int)w.bounds.width); Write(cw, ",", 1);
+				WriteInt(cw, (int)w.bounds.height); Write(cw, "}", 1);
+			break;
+			case 'C':
+				WriteString(cw, "(Rectangle){0,0,");
+				WriteInt(cw, (int)ceilf(content.width)); Write(cw, ",", 1);
+				WriteInt(cw, (int)ceilf(content.height)); Write(cw, "}", 1);
+			break;
+			case 'W':
+				WriteInt(cw, (int)ceilf(content.width));
+			break;
+			case 'H':
+				WriteInt(cw, (int)ceilf(content.height));
+			break;
+			case 'I':
+				WriteInt(cw, w.id);
+			break;
+			case 'L':
+				if(v == NULL) WriteString(cw, "layoutText[layoutLabel[i]]");
+				else WriteCString(cw, v->text, strlen(v->text));
+			break;
+			case 'E':
+				if(v == NULL) WriteString(cw, "layoutText[layoutItems[i]]");
+				else WriteCString(cw, v->items, strlen(v->items));
+			break;
+			case 'A':
+				if(v == NULL) {
+					WriteString(cw, "&layoutEntries[layoutEntry[i]]");
+					break;
+				}
+				WriteString(cw, "(const char*[]){ ");
+				WriteItems(cw, v->items, ", ");
+				WriteString(cw, " }");
+			break;
+			case '#':
+				if(v == NULL) WriteString(cw, "layoutEntryCount[i]");
+				else WriteInt(cw, ItemCount(v->items));
+			break;
+			case 'V': case 'v':
+				WriteNumber(cw, v, v ? v->value : 0, "layoutValue[i]", *s == 'V');
+			break;
+			case 'N': case 'n':
+				WriteNumber(cw, v, v ? v->min : 0, "layoutRange[2*i]", *s == 'N');
+			break;
+			case 'X': case 'x':
+				WriteNumber(cw, v, v ? v->max : 0, "layoutRange[2*i+1]", *s == 'X');
+			break;
+			case 'K':
+				if(v == NULL) {
+					WriteString(cw, "layoutColor[i]");
+					break;
+				}
+				WriteString(cw, "(Color){ ");
+				WriteColor(cw, v->color);
+				WriteString(cw, " }");
+			break;
+			case 'k':
+				if(v == NULL) WriteString(cw, "layoutColor[i].r, layoutColor[i].g, layoutColor[i].b, layoutColor[i].a");
+				else WriteColor(cw, v->color);
+			break;
+			case 'S':
+				WriteInt(cw, (v == NULL) ? cw->textSize : TextSize(v->text));
+			break;
+			case '$':
+				Write(cw, "$", 1);
+			break;
+			default:
+				//not a substitution, keep it as it is
+				Write(cw, "$", 1);
+				if(*s == '\0') --s; //lone `$` at the end, let the loop stop
+				else Write(cw, s, 1);
+			break;
+		}
+	}
+}
+
+//write the call of widget `w`
+static void WriteWidget(CodeWriter* cw, Widget w, Origin o, Rectangle content, int depth) {
+	const char* code = WidgetDescs[w.type].code;
+	if(code == NULL) return;
+	char label[64];
+	snprintf(label, sizeof(label), "%s%i", WidgetName[w.type], w.id);
+	WidgetValues v = WidgetValuesOf(w, cw->strings, label);
+	WriteIndent(cw, depth);
+	WriteTemplate(cw, code, w, &v, o, content, depth);
+	WriteString(cw, ";\n");
+}
+
+static inline Rectangle Normalize(Rectangle r) {
+	if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+	if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+	return r;
+}
+
+//widget `i` and its children, from the top-left corner of the widget
+static Rectangle ContentOf(const ArrayWidget* w, const Hierarchy* h, int i) {
+	const int* children = HierarchyChildren(h, i);
+	Rectangle r = Normalize(Array_at(w, i).bounds);
+	Rectangle content = { 0, 0, r.width, r.height };
+	for(int k=0; k<HierarchyChildCount(h, i); ++k) {
+		Rectangle c = Normalize(Array_at(w, children[k]).bounds);
+		content.width = fmaxf(content.width, c.x + c.width - r.x);
+		content.height = fmaxf(content.height, c.y + c.height - r.y);
+	}
+	return content;
+}
+
+//Write widget `i` placed from `o` and then the widgets inside it in a block of their own,
+//placed from it.
+static void WriteTree(CodeWriter* cw, const ArrayWidget* w, const Hierarchy* h, int i, Origin o, int depth) {
+	Widget widget = Array_at(w, i);
+	const int* children = HierarchyChildren(h, i);
+	int count = HierarchyChildCount(h, i);
+	WriteWidget(cw, widget, o, ContentOf(w, h, i), depth);
+	if(count == 0 || cw->error != VEE_OK) return;
+
+	WriteIndent(cw, depth);
+	WriteString(cw, "{\n");
+	WriteIndent(cw, depth+1);
+	WriteString(cw, "const Vector2 origin");
+	WriteInt(cw, widget.id);
+	WriteString(cw, " = { ");
+	WriteCoord(cw, o, 'x', (int)widget.bounds.x);
+	if(widget.type == WIDGET_ScrollPanel) {
+		WriteString(cw, " + scroll");
+		WriteInt(cw, widget.id);
+		WriteString(cw, ".x");
+	}
+	WriteString(cw, ", ");
+	WriteCoord(cw, o, 'y', (int)widget.bounds.y);
+	if(widget.type == WIDGET_ScrollPanel) {
+		WriteString(cw, " + scroll");
+		WriteInt(cw, widget.id);
+		WriteString(cw, ".y");
+	}
+	WriteString(cw, " };\n");
+	Origin inner = { widget.id, (int)widget.bounds.x, (int)widget.bounds.y };
+	for(int k=0; k<count; ++k)
+		WriteTree(cw, w, h, children[k], inner, depth+1);
+	WriteIndent(cw, depth);
+	WriteString(cw, "}\n");
+}
+
+// -------
+// TABLES
+// -------
+
+//the texts and items of the widgets, each one is written once
+typedef struct {
+	ArrayChar text;   //every string followed by its `\0`
+	ArrayInt offsets; //where each string starts in `text`
+	ArrayInt slots;   //open addressing hash table (power of 2 size) of label index+1, 0 when empty
+} Labels;
+
+static inline uint64_t HashLabel(const char* s) {
+	return fnv64_1a((char*)s, strlen(s));
+}
+
+//Index of label `s`, added if it isn't there yet. -1 when out of memory.
+static int InternLabel(Labels* l, const char* s) {
+	//at most half full
+	size_t count = Array_size(&l->offsets);
+	if(2*(count+1) > Array_size(&l->slots)) {
+		size_t size = (Array_size(&l->slots) > 0) ? 2*Array_size(&l->slots) : 256;
+		if(Array_reserve_exact(&l->slots, size) != VEE_OK) return -1;
+		l->slots.size = size;
+		memset(Array_data(&l->slots), 0, size*sizeof(int));
+		for(size_t k=0; k<count; ++k) {
+			size_t j = HashLabel(&Array_at(&l->text, Array_at(&l->offsets, k))) & (size-1);
+			while(Array_at(&l->slots, j) != 0) j = (j+1) & (size-1);
+			Array_at(&l->slots, j) = k+1;
+		}
+	}
+
+	size_t mask = Array_size(&l->slots)-1, j = HashLabel(s) & mask;
+	for(; Array_at(&l->slots, j) != 0; j = (j+1) & mask) {
+		int k = Array_at(&l->slots, j)-1;
+		if(strcmp(&Array_at(&l->text, Array_at(&l->offsets, k)), s) == 0) return k;
+	}
+	size_t len = strlen(s)+1, at = Array_size(&l->text);
+	if(Array_reserve(&l->text, at+len) != VEE_OK || Array_push(&l->offsets, at) != VEE_OK) return -1;
+	memcpy(&Array_at(&l->text, at), s, len);
+	l->text.size += len;
+	Array_at(&l->slots, j) = count+1;
+	return count;
+}
+
+static void LabelsDestroy(Labels* l) {
+	Array_destroy(&l->text);
+	Array_destroy(&l->offsets);
+	Array_destroy(&l->slots);
+}
+
+//one widget in the tables, every int field can be written with WriteColumn()
+typedef struct {
+	int type;
+	int x, y, width, height; //from the container the widget is in
+	int parent; //origin slot of that container, -1 for the window
+	int origin; //origin slot of the widgets inside it, -1 when there are none
+	int label;  //0 when it has none
+	int items;  //in the labels too
+	int entry;  //first of its items in layoutEntries
+	int entries;
+	int state;  //in the state array of its type
+	float min, max, value;
+	Color color;
+} TableRow;
+
+#define TABLE_FIELD(F) (offsetof(TableRow, F)/sizeof(int))
+
+//`decl` initialized with `per` fields of every row starting at `field`, 16 values per line
+static void WriteColumn(CodeWriter* cw, const char* decl, const TableRow* rows, size_t n, size_t field, int per) {
+	WriteString(cw, decl);
+	WriteString(cw, " = {");
+	for(size_t k=0; k<n*per; ++k) {
+		WriteString(cw, (k%16 == 0) ? "\n    " : " ");
+		WriteInt(cw, ((const int*)&rows[k/per])[field + k%per]);
+		Write(cw, ",", 1);
+	}
+	WriteString(cw, "\n};\n");
+}
+
+//`decl` initialized with `per` floats of every row starting at the one at `offset`, 8 values per line
+static void WriteFloatColumn(CodeWriter* cw, const char* decl, const TableRow* rows, size_t n, size_t offset, int per) {
+	WriteString(cw, decl);
+	WriteString(cw, " = {");
+	for(size_t k=0; k<n*per; ++k) {
+		WriteString(cw, (k%8 == 0) ? "\n    " : " ");
+		WriteFloat(cw, ((const float*)((const char*)&rows[k/per] + offset))[k%per]);
+		Write(cw, ",", 1);
+	}
+	WriteString(cw, "\n};\n");
+}
+
+//smallest type holding every value in [min, max]
+static const char* IntType(int min, int max) {
+	if(min >= 0 && max <= UINT8_MAX) return "unsigned char";
+	if(min >= 0 && max <= UINT16_MAX) return "unsigned short";
+	if(min >= INT16_MIN && max <= INT16_MAX) return "short";
+	return "int";
+}
+
+//what every widget type of the layout needs
+typedef struct {
+	int count;    //widgets of the type
+	bool label;   //its table call uses the text
+	bool items;   //the items as one string
+	bool entries; //the items one by one
+	bool range;
+	bool value;
+	bool color;
+	bool inner;   //its table call moves the widgets inside it
+} TableType;
+
+//Static tables of the widgets and one loop that draws them, see CODE_TABLES.
+static void WriteTables(CodeWriter* cw, const ArrayWidget* w, const Hierarchy* h) {
+	size_t n = Array_size(w);
+	TableRow* rows = malloc(n*sizeof(TableRow));
+	Labels labels = {0};
+	if(rows == NULL || InternLabel(&labels, "") != 0) {
+		free(rows);
+		LabelsDestroy(&labels);
+		cw->error = VEE_OUT_OF_MEMORY;
+		return;
+	}
+
+	//the widgets are in draw order, a container always comes before the widgets inside it
+	TableType types[WIDGET_COUNT] = {0};
+	int origins = 0, minCoord = 0, maxCoord = 0, maxState = 0;
+	for(size_t i=0; i<n && cw->error == VEE_OK; ++i) {
+		Widget widget = Array_at(w, i);
+		const WidgetDesc* d = &WidgetDescs[widget.type];
+		TableType* t = &types[widget.type];
+		TableRow* r = &rows[i];
+		if(t->count == 0) {
+			t->label = Uses(d->table, "L");
+			t->items = Uses(d->table, "E");
+			t->entries = Uses(d->table, "A#");
+			t->range = Uses(d->table, "NnXx");
+			t->value = Uses(d->table, "Vv");
+			t->color = Uses(d->table, "Kk");
+			t->inner = strstr(d->table, "inner") != NULL;
+		}
+		int parent = HierarchyParent(h, i);
+		r->type = widget.type;
+		r->parent = (parent == -1) ? -1 : rows[parent].origin;
+		r->x = (int)widget.bounds.x - ((parent == -1) ? 0 : (int)Array_at(w, parent).bounds.x);
+		r->y = (int)widget.bounds.y - ((parent == -1) ? 0 : (int)Array_at(w, parent).bounds.y);
+		r->width = widget.bounds.width;
+		r->height = widget.bounds.height;
+		r->origin = (HierarchyChildCount(h, i) > 0) ? origins++ : -1;
+		r->state = (d->state != NULL) ? t->count : 0;
+		++t->count;
+
+		char label[64];
+		snprintf(label, sizeof(label), "%s%i", WidgetName[widget.type], widget.id);
+		WidgetValues v = WidgetValuesOf(widget, cw->strings, label);
+		r->label = t->label ? InternLabel(&labels, v.text) : 0;
+		r->items = (t->items || t->entries) ? InternLabel(&labels, v.items) : 0;
+		r->entry = r->entries = 0;
+		r->min = v.min;
+		r->max = v.max;
+		r->value = v.value;
+		r->color = v.color;
+		if(r->label == -1 || r->items == -1) cw->error = VEE_OUT_OF_MEMORY;
+		if(Uses(d->table, "S") || Uses(d->state, "S")) {
+			int size = TextSize(v.text);
+			if(size > cw->textSize) cw->textSize = size;
+		}
+		const int coords[4] = { r->x, r->y, r->width, r->height };
+		for(int c=0; c<4; ++c) {
+			if(coords[c] < minCoord) minCoord = coords[c];
+			if(coords[c] > maxCoord) maxCoord = coords[c];
+		}
+		if(r->state > maxState) maxState = r->state;
+	}
+
+	TableType used = { .inner = origins > 0 };
+	bool stateful = false;
+	for(int k=0; k<WIDGET_COUNT; ++k) {
+		if(types[k].count == 0) continue;
+		used.label |= types[k].label;
+		used.items |= types[k].items;
+		used.entries |= types[k].entries;
+		used.range |= types[k].range;
+		used.value |= types[k].value;
+		used.color |= types[k].color;
+		stateful |= WidgetDescs[k].state != NULL;
+		used.inner |= types[k].inner;
+	}
+
+	//the items of every string that is split are written once, in the order they are first used
+	ArrayInt split = {0};
+	int* entryOf = NULL;
+	int entries = 0, maxEntries = 0;
+	if(used.entries && cw->error == VEE_OK) {
+		size_t count = Array_size(&labels.offsets);
+		entryOf = malloc(count*sizeof(int));
+		if(entryOf == NULL) cw->error = VEE_OUT_OF_MEMORY;
+		for(size_t k=0; entryOf != NULL && k<count; ++k) entryOf[k] = -1;
+		for(size_t i=0; i<n && cw->error == VEE_OK; ++i) {
+			TableRow* r = &rows[i];
+			if(!types[r->type].entries) continue;
+			r->entries = ItemCount(&Array_at(&labels.text, Array_at(&labels.offsets, r->items)));
+			if(entryOf[r->items] == -1) {
+				entryOf[r->items] = entries;
+				entries += r->entries;
+				if(Array_push(&split, r->items) != VEE_OK) cw->error = VEE_OUT_OF_MEMORY;
+			}
+			r->entry = entryOf[r->items];
+			if(r->entries > maxEntries) maxEntries = r->entries;
+		}
+	}
+
+	//TABLES
+	WriteString(cw, "// The widgets are drawn in this order by DrawGUI(), each one from a row of the tables below.\n"\
+	"#define LAYOUT_COUNT ");
+	WriteInt(cw, n);
+	WriteString(cw, "\n\nenum {\n");
+	for(int k=0; k<WIDGET_COUNT; ++k) {
+		if(types[k].count == 0) continue;
+		WriteString(cw, "    LAYOUT_");
+		WriteString(cw, WidgetName[k]);
+		WriteString(cw, " = ");
+		WriteInt(cw, k);
+		WriteString(cw, ",\n");
+	}
+	WriteString(cw, "};\n\n");
+
+	char decl[128];
+	WriteColumn(cw, "static const unsigned char layoutType[LAYOUT_COUNT]", rows, n, TABLE_FIELD(type), 1);
+	WriteString(cw, "// x, y, width and height, from the container the widget is in\n");
+	snprintf(decl, sizeof(decl), "static const %s layoutBounds[4*LAYOUT_COUNT]", IntType(minCoord, maxCoord));
+	WriteColumn(cw, decl, rows, n, TABLE_FIELD(x), 4);
+	if(origins > 0) {
+		WriteString(cw, "// origin of the container the widget is in, -1 for the window\n");
+		snprintf(decl, sizeof(decl), "static const %s layoutParent[LAYOUT_COUNT]", IntType(-1, origins));
+		WriteColumn(cw, decl, rows, n, TABLE_FIELD(parent), 1);
+		WriteString(cw, "// origin of the widgets inside it, -1 when there are none\n");
+		snprintf(decl, sizeof(decl), "static const %s layoutOrigin[LAYOUT_COUNT]", IntType(-1, origins));
+		WriteColumn(cw, decl, rows, n, TABLE_FIELD(origin), 1);
+	}
+	if(stateful) {
+		WriteString(cw, "// index in the state array of the widget type\n");
+		snprintf(decl, sizeof(decl), "static const %s layoutState[LAYOUT_COUNT]", IntType(0, maxState));
+		WriteColumn(cw, decl, rows, n, TABLE_FIELD(state), 1);
+	}
+	if(used.label) {
+		snprintf(decl, sizeof(decl), "static const %s layoutLabel[LAYOUT_COUNT]", IntType(0, Array_size(&labels.offsets)));
+		WriteColumn(cw, decl, rows, n, TABLE_FIELD(label), 1);
+	}
+	if(used.items) {
+		snprintf(decl, sizeof(decl), "static const %s layoutItems[LAYOUT_COUNT]", IntType(0, Array_size(&labels.offsets)));
+		WriteColumn(cw, decl, rows, n, TABLE_FIELD(items), 1);
+	}
+	if(used.label || used.items) {
+		WriteString(cw, "static const char* const layoutText[] = {");
+		for(ArrayIt k=0; k<Array_size(&labels.offsets); ++k) {
+			WriteString(cw, (k%8 == 0) ? "\n    " : " ");
+			const char* text = &Array_at(&labels.text, Array_at(&labels.offsets, k));
+			WriteCString(cw, text, strlen(text));
+			WriteString(cw, ",");
+		}
+		WriteString(cw, "\n};\n");
+	}
+	if(used.entries) {
+		WriteString(cw, "// the items of the widgets one by one, from layoutEntry[i] on\n");
+		snprintf(decl, sizeof(decl), "static const %s layoutEntry[LAYOUT_COUNT]", IntType(0, entries));
+		WriteColumn(cw, decl, rows, n, TABLE_FIELD(entry), 1);
+		snprintf(decl, sizeof(decl), "static const %s layoutEntryCount[LAYOUT_COUNT]", IntType(0, maxEntries));
+		WriteColumn(cw, decl, rows, n, TABLE_FIELD(entries), 1);
+		WriteString(cw, "static const char* layoutEntries[] = {");
+		for(ArrayIt k=0; k<Array_size(&split); ++k) {
+			WriteString(cw, "\n    ");
+			WriteItems(cw, &Array_at(&labels.text, Array_at(&labels.offsets, Array_at(&split, k))), ", ");
+			WriteString(cw, ",");
+		}
+		WriteString(cw, "\n};\n");
+	}
+	if(used.range) {
+		WriteString(cw, "// min and max\n");
+		WriteFloatColumn(cw, "static const float layoutRange[2*LAYOUT_COUNT]", rows, n, offsetof(TableRow, min), 2);
+	}
+	if(used.value) WriteFloatColumn(cw, "static const float layoutValue[LAYOUT_COUNT]", rows, n, offsetof(TableRow, value), 1);
+	if(used.color) {
+		WriteString(cw, "static const Color layoutColor[LAYOUT_COUNT] = {");
+		for(size_t k=0; k<n; ++k) {
+			WriteString(cw, (k%4 == 0) ? "\n    { " : " { ");
+			WriteColor(cw, rows[k].color);
+			WriteString(cw, " },");
+		}
+		WriteString(cw, "\n};\n");
+	}
+
+	//STATE
+	if(stateful || origins > 0) {
+		WriteString(cw, "\n");
+		for(int k=0; k<WIDGET_COUNT; ++k) {
+			if(types[k].count == 0 || WidgetDescs[k].state == NULL) continue;
+			WriteString(cw, "typedef struct { ");
+			WriteTemplate(cw, WidgetDescs[k].state, (Widget){0}, NULL, (Origin){ -1, 0, 0 }, (Rectangle){0}, 0);
+			WriteString(cw, " } ");
+			WriteString(cw, WidgetName[k]);
+			WriteString(cw, "State;\n");
+		}
+		WriteString(cw, "\n// everything the widgets change, kept from one frame to the next\ntypedef struct {\n");
+		if(origins > 0) {
+			WriteString(cw, "    Vector2 origin[");
+			WriteInt(cw, origins);
+			WriteString(cw, "];\n");
+		}
+		for(int k=0; k<WIDGET_COUNT; ++k) {
+			if(types[k].count == 0 || WidgetDescs[k].state == NULL) continue;
+			WriteString(cw, "    ");
+			WriteString(cw, WidgetName[k]);
+			WriteString(cw, "State ");
+			WriteString(cw, WidgetName[k]);
+			Write(cw, "[", 1);
+			WriteInt(cw, types[k].count);
+			WriteString(cw, "];\n");
+		}
+		WriteString(cw, "} LayoutState;\n\nstatic LayoutState layout = {\n");
+		const Origin window = { -1, 0, 0 };
+		for(int k=0; k<WIDGET_COUNT && stateful; ++k) {
+			if(types[k].count == 0 || WidgetDescs[k].state == NULL) continue;
+			WriteString(cw, "    .");
+			WriteString(cw, WidgetName[k]);
+			WriteString(cw, " = {\n");
+			for(size_t i=0; i<n; ++i) {
+				if(rows[i].type != k) continue;
+				Widget widget = Array_at(w, i);
+				char label[64];
+				snprintf(label, sizeof(label), "%s%i", WidgetName[widget.type], widget.id);
+				WidgetValues v = WidgetValuesOf(widget, cw->strings, label);
+				WriteIndent(cw, 2);
+				WriteTemplate(cw, WidgetDescs[k].stateInit, widget, &v, window, ContentOf(w, h, i), 2);
+				WriteString(cw, ",\n");
+			}
+			WriteString(cw, "    },\n");
+		}
+		WriteString(cw, "};\n");
+	}
+
+	//DRAW
+	WriteString(cw, "\nvoid DrawGUI() {\n"\
+	"    for(int i=0; i<LAYOUT_COUNT; ++i) {\n");
+	if(origins > 0) WriteString(cw, "        Vector2 o = (layoutParent[i] < 0) ? (Vector2){ 0, 0 } : layout.origin[layoutParent[i]];\n"\
+	"        Rectangle b = { o.x + layoutBounds[4*i], o.y + layoutBounds[4*i+1], layoutBounds[4*i+2], layoutBounds[4*i+3] };\n");
+	else WriteString(cw, "        Rectangle b = { layoutBounds[4*i], layoutBounds[4*i+1], layoutBounds[4*i+2], layoutBounds[4*i+3] };\n");
+	if(used.inner) WriteString(cw, "        Vector2 inner = { b.x, b.y };\n");
+	WriteString(cw, "        switch(layoutType[i]) {\n");
+	const Widget none = {0};
+	const Origin window = { -1, 0, 0 };
+	for(int k=0; k<WIDGET_COUNT; ++k) {
+		if(types[k].count == 0) continue;
+		const WidgetDesc* d = &WidgetDescs[k];
+		WriteString(cw, "            case LAYOUT_");
+		WriteString(cw, WidgetName[k]);
+		if(d->state == NULL) {
+			WriteString(cw, ": ");
+			WriteTemplate(cw, d->table, none, NULL, window, (Rectangle){0}, 3);
+			WriteString(cw, "; break;\n");
+			continue;
+		}
+		WriteString(cw, ": {\n                ");
+		WriteString(cw, WidgetName[k]);
+		WriteString(cw, "State* s = &layout.");
+		WriteString(cw, WidgetName[k]);
+		WriteString(cw, "[layoutState[i]];\n                ");
+		WriteTemplate(cw, d->table, none, NULL, window, (Rectangle){0}, 4);
+		WriteString(cw, ";\n            } break;\n");
+	}
+	WriteString(cw, "        }\n");
+	if(origins > 0) WriteString(cw, "        if(layoutOrigin[i] >= 0) layout.origin[layoutOrigin[i]] = inner;\n");
+	WriteString(cw, "    }\n}\n");
+
+	free(rows);
+	free(entryOf);
+	Array_destroy(&split);
+	LabelsDestroy(&labels);
+}
+
+int GenerateCode(const ArrayWidget* w, const StringTable* strings, CodeStyle style, FILE* f) {
+	if(w == NULL || strings == NULL || f == NULL) return VEE_BAD_ARG;
+
+	CodeWriter cw = { .f = f, .strings = strings };
+	//a bit over the flush size so most writes never have to grow the buffer
+	if(Array_create(&cw.buf, CODEGEN_FLUSH_SIZE + 1024) != VEE_OK) return VEE_OUT_OF_MEMORY;
+
+	WriteString(&cw, "#include <raylib.h>\n"\
+	"#define RAYGUI_IMPLEMENTATION\n"\
+	"#include <raygui.h>\n\n");
+	//the widgets are already in draw order
+	Hierarchy h;
+	HierarchyCreate(&h);
+	size_t n = Array_size(w);
+	int* byDepth = (n > 0) ? malloc(n*sizeof(int)) : NULL;
+	for(size_t i=0; byDepth != NULL && i<n; ++i) byDepth[i] = i;
+	if(n > 0 && (byDepth == NULL || HierarchyBuild(&h, w, byDepth) != VEE_OK)) cw.error = VEE_OUT_OF_MEMORY;
+	if(style == CODE_TABLES && n > 0) {
+		if(cw.error == VEE_OK) WriteTables(&cw, w, &h);
+	} else {
+		const Origin window = { -1, 0, 0 };
+		WriteString(&cw, "void DrawGUI() {\n");
+		for(ArrayIt k = 0; k<Array_size(&h.roots) && cw.error == VEE_OK; ++k)
+			WriteTree(&cw, w, &h, Array_at(&h.roots, k), window, 1);
+		WriteString(&cw, "}\n");
+	}
+	free(byDepth);
+	HierarchyDestroy(&h);
+	//the window fits every widget, but is never smaller than the editor's default canvas
+	int width = screenWidth, height = screenHeight;
+	for(ArrayIt i = 0; i<Array_size(w); ++i) {
+		Rectangle r = Normalize(Array_at(w, i).bounds);
+		if(r.x + r.width > width) width = ceilf(r.x + r.width);
+		if(r.y + r.height > height) height = ceilf(r.y + r.height);
+	}
+	WriteString(&cw, "int main(int argc, char **argv) {\n"\
+	"    InitWindow(");
+	WriteInt(&cw, width);
+	WriteString(&cw, ", ");
+	WriteInt(&cw, height);
+	WriteString(&cw, ", \"GUI Test\");\n"\
+	"    SetTargetFPS(60);\n\n"\
+	"    while(!WindowShouldClose())\n"\
+	"    {\n"\
+	"        BeginDrawing();\n"\
+	"        DrawGUI();\n"\
+	"        EndDrawing();\n"\
+	"    }\n"\
+	"    CloseWindow();\n"\
+	"    return 0;\n"\
+	"}\n\n");
+	Flush(&cw);
+
+	Array_destroy(&cw.buf);
+	return cw.error;
+}
+
+int ExportCode(const char* path, const ArrayWidget* w, const StringTable* strings, CodeStyle style) {
+	FILE* f = fopen(path, "wb");
+	if(f == NULL) return VEE_IO_ERROR;
+	int r = GenerateCode(w, strings, style, f);
+	if(fclose(f) != 0 && r == VEE_OK) r = VEE_IO_ERROR;
+	return r;
+}
@@ -0,0 +1,30 @@
+#ifndef GE_CODEGEN_H
+#define GE_CODEGEN_H
+
+#include "editor.h"
+
+//generated code is collected in memory and written out in blocks of this size
+#define CODEGEN_FLUSH_SIZE (64*1024)
+
+typedef enum {
+	CODE_CALLS = 0, //one call per widget, with its bounds and properties in the arguments
+	CODE_TABLES,    //static tables of bounds, types and properties and one loop drawing them
+	CODE_STYLE_COUNT
+} CodeStyle;
+
+/** Generate a complete C program that draws the widgets `w` (in draw order) with raygui and write it to `f`.
+ * The calls are built from the templates in `WidgetDescs`, with the properties of the widgets (their
+ * strings from `strings`). The widgets inside a container (see hierarchy.h)
+ * are placed from its position, so moving the container in the generated code moves them too (and
+ * scrolling a ScrollPanel scrolls them).
+ *
+ * CODE_CALLS writes the widgets inside a container in a block of their own after it. CODE_TABLES writes
+ * the smallest integer types that fit the layout, every string once, and a struct with the state of the
+ * widgets (values, edit modes, scrolling) that is kept from one frame to the next. It's much less code
+ * for large layouts. Returns VEE_OK[0] on success. */
+extern int GenerateCode(const ArrayWidget* w, const StringTable* strings, CodeStyle style, FILE* f);
+
+/** Same as `GenerateCode()` but writes to the file at `path` (overwriting it). */
+extern int ExportCode(const char* path, const ArrayWidget* w, const StringTable* strings, CodeStyle style);
+
+#endif
@@ -0,0 +1,141 @@
+#include "depth.h"
+
+//spread all the keys evenly again (a gap ran out)
+static void Relabel(DepthOrder* d) {
+	uint64_t key = DEPTH_KEY_GAP;
+	for(int s = d->bottom; s != DEPTH_NONE; s = Array_at(&d->links, s).above, key += DEPTH_KEY_GAP)
+		Array_at(&d->links, s).key = key;
+}
+
+//give keys to the `n` linked slots starting at `first` (going up) that fit between their neighbours
+static void AssignKeys(DepthOrder* d, int first, size_t n) {
+	int below = Array_at(&d->links, first).below, last = first;
+	for(size_t i=1; i<n; ++i) last = Array_at(&d->links, last).above;
+	int above = Array_at(&d->links, last).above;
+
+	uint64_t lo = (below == DEPTH_NONE) ? 0 : Array_at(&d->links, below).key;
+	uint64_t step;
+	if(above == DEPTH_NONE) {
+		step = (UINT64_MAX - lo)/(n+1);
+		if(step > DEPTH_KEY_GAP) step = DEPTH_KEY_GAP;
+	} else {
+		step = (Array_at(&d->links, above).key - lo)/(n+1);
+	}
+	if(step == 0) {
+		Relabel(d);
+		return;
+	}
+	for(int s = first; n-- > 0; s = Array_at(&d->links, s).above)
+		Array_at(&d->links, s).key = (lo += step);
+}
+
+static void Unlink(DepthOrder* d, int slot) {
+	DepthLink l = Array_at(&d->links, slot);
+	if(l.below != DEPTH_NONE) Array_at(&d->links, l.below).above = l.above;
+	else d->bottom = l.above;
+	if(l.above != DEPTH_NONE) Array_at(&d->links, l.above).below = l.below;
+	else d->top = l.below;
+}
+
+//link the chain `first`..`last` (already linked among themselves) right above `below`
+static void LinkChain(DepthOrder* d, int first, int last, int below) {
+	int above = (below == DEPTH_NONE) ? d->bottom : Array_at(&d->links, below).above;
+	Array_at(&d->links, first).below = below;
+	Array_at(&d->links, last).above = above;
+	if(below != DEPTH_NONE) Array_at(&d->links, below).above = first;
+	else d->bottom = first;
+	if(above != DEPTH_NONE) Array_at(&d->links, above).below = last;
+	else d->top = last;
+}
+
+//slot `from` now lives at `to`, point its neighbours there
+static void Relocate(DepthOrder* d, int from, int to) {
+	DepthLink l = Array_at(&d->links, from);
+	Array_at(&d->links, to) = l;
+	if(l.below != DEPTH_NONE) Array_at(&d->links, l.below).above = to;
+	else d->bottom = to;
+	if(l.above != DEPTH_NONE) Array_at(&d->links, l.above).below = to;
+	else d->top = to;
+}
+
+void DepthOrderCreate(DepthOrder* d) {
+	*d = (DepthOrder){ .bottom = DEPTH_NONE, .top = DEPTH_NONE };
+}
+
+void DepthOrderDestroy(DepthOrder* d) {
+	Array_destroy(&d->links);
+	d->bottom = d->top = DEPTH_NONE;
+}
+
+void DepthOrderClear(DepthOrder* d) {
+	d->links.size = 0;
+	d->bottom = d->top = DEPTH_NONE;
+}
+
+int DepthOrderAppend(DepthOrder* d, size_t n, const uint32_t* ranks, int below) {
+	if(n == 0) return VEE_OK;
+	size_t base = Array_size(&d->links);
+	if(base + n > INT32_MAX) return VEE_BAD_ARG;
+
+	//slots from the lowest to the highest
+	int* order = malloc(n*sizeof(int));
+	if(order == NULL) return VEE_OUT_OF_MEMORY;
+	for(size_t i=0; i<n; ++i) order[i] = DEPTH_NONE;
+	for(size_t i=0; i<n; ++i) {
+		uint32_t r = (ranks != NULL) ? ranks[i] : i;
+		if(r >= n || order[r] != DEPTH_NONE) {
+			free(order);
+			return VEE_BAD_ARG;
+		}
+		order[r] = base + i;
+	}
+	if(Array_reserve(&d->links, base + n) != VEE_OK) {
+		free(order);
+		return VEE_OUT_OF_MEMORY;
+	}
+	d->links.size = base + n;
+
+	for(size_t r=0; r<n; ++r) {
+		DepthLink* l = &Array_at(&d->links, order[r]);
+		l->below = (r == 0) ? DEPTH_NONE : order[r-1];
+		l->above = (r == n-1) ? DEPTH_NONE : order[r+1];
+	}
+	LinkChain(d, order[0], order[n-1], below);
+	AssignKeys(d, order[0], n);
+	free(order);
+	return VEE_OK;
+}
+
+void DepthOrderMove(DepthOrder* d, int slot, int below) {
+	if(slot == below || Array_at(&d->links, slot).below == below) return;
+	Unlink(d, slot);
+	LinkChain(d, slot, slot, below);
+	AssignKeys(d, slot, 1);
+}
+
+void DepthOrderSwapRemove(DepthOrder* d, int slot) {
+	int last = Array_size(&d->links) - 1;
+	Unlink(d, slot);
+	if(slot != last) Relocate(d, last, slot);
+	Array_pop(&d->links);
+}
+
+int DepthOrderSwapInsert(DepthOrder* d, int slot, int below) {
+	int n = Array_size(&d->links);
+	if(slot < 0 || slot > n) return VEE_BAD_ARG;
+	if(Array_push(&d->links, (DepthLink){0}) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	if(slot != n) Relocate(d, slot, n);
+	LinkChain(d, slot, slot, below);
+	AssignKeys(d, slot, 1);
+	return VEE_OK;
+}
+
+int DepthOrderRanks(const DepthOrder* d, ArrayDepthRank* ranks) {
+	size_t n = Array_size(&d->links);
+	if(Array_reserve_exact(ranks, n) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	ranks->size = n;
+	uint32_t r = 0;
+	for(int s = d->bottom; s != DEPTH_NONE; s = Array_at(&d->links, s).above)
+		Array_at(ranks, s) = r++;
+	return VEE_OK;
+}
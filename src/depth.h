@@ -0,0 +1,76 @@
+#ifndef GE_DEPTH_H
+#define GE_DEPTH_H
+
+#include "editor.h"
+
+/* DEPTH ORDER
+ * The draw order of the widgets is kept apart from the widget array so reordering never
+ * moves widgets around in memory. Every slot of the widget array has a link to the widget
+ * right below and right above it, which makes moving a widget anywhere O(1), and a sparse
+ * depth key so two widgets can be compared without walking the list. Keys are spread
+ * DEPTH_KEY_GAP apart and a new key takes the middle of the gap it goes into, all the keys
+ * are spread out again when a gap runs out. */
+
+#define DEPTH_NONE -1
+#define DEPTH_KEY_GAP ((uint64_t)1 << 32)
+
+typedef struct {
+	int below, above;  //neighbour slots, DEPTH_NONE at the bottom/top
+	uint64_t key;      //higher is drawn above
+} DepthLink;
+
+typedef Array(DepthLink) ArrayDepthLink;
+typedef Array(uint32_t) ArrayDepthRank;
+
+typedef struct {
+	ArrayDepthLink links;  //one per slot of the widget array
+	int bottom, top;       //DEPTH_NONE when empty
+} DepthOrder;
+
+extern void DepthOrderCreate(DepthOrder* d);
+extern void DepthOrderDestroy(DepthOrder* d);
+extern void DepthOrderClear(DepthOrder* d);
+
+/** Add `n` slots after the existing ones. Slot `Array_size(&d->links)+i` gets the depth rank
+ * `ranks[i]` (0 is the lowest) among the new slots, or `i` if `ranks` is NULL. All of them go
+ * above slot `below` (DEPTH_NONE for the very bottom). `ranks` must be a permutation of 0..n-1.
+ * Returns VEE_OK[0] on success. */
+extern int DepthOrderAppend(DepthOrder* d, size_t n, const uint32_t* ranks, int below);
+
+/** Move slot `slot` right above slot `below` (DEPTH_NONE for the very bottom). */
+extern void DepthOrderMove(DepthOrder* d, int slot, int below);
+
+/** Take `slot` out of the order. The last slot is moved into its place, the same way
+ * the widget array removes widgets. */
+extern void DepthOrderSwapRemove(DepthOrder* d, int slot);
+/** Inverse of DepthOrderSwapRemove(): moves `slot` (if it exists) to a new last slot and
+ * puts a new slot at `slot` right above `below`. Returns VEE_OK[0] on success. */
+extern int DepthOrderSwapInsert(DepthOrder* d, int slot, int below);
+
+/** Store the depth rank (0 is the lowest) of every slot in `ranks`.
+ * Returns VEE_OK[0] on success. */
+extern int DepthOrderRanks(const DepthOrder* d, ArrayDepthRank* ranks);
+
+static inline int DepthBelow(const DepthOrder* d, int slot) { return Array_at(&d->links, slot).below; }
+static inline int DepthAbove(const DepthOrder* d, int slot) { return Array_at(&d->links, slot).above; }
+static inline uint64_t DepthKey(const DepthOrder* d, int slot) { return Array_at(&d->links, slot).key; }
+
+
+// -------
+// WIDGET ARRAY
+// -------
+// The widget array is changed the same way as the order: new widgets are always added at
+// the end and removed widgets are replaced by the last one, nothing else moves.
+
+static inline void WidgetSwapRemove(ArrayWidget* w, int slot) {
+	Array_at(w, slot) = Array_at(w, Array_size(w)-1);
+	Array_pop(w);
+}
+
+static inline int WidgetSwapInsert(ArrayWidget* w, int slot, Widget widget) {
+	int r = (slot < (int)Array_size(w)) ? Array_push(w, Array_at(w, slot)) : Array_push(w, widget);
+	if(r == VEE_OK) Array_at(w, slot) = widget;
+	return r;
+}
+
+#endif
@@ -1,98 +1,39 @@
 #include "editor.h"
+#include "spatial.h"
+#include "align.h"
+#include "lint.h"
+#include "uifile.h"
+#include "widgets.h"
+#include "codegen.h"
+#include "journal.h"
+#include "history.h"
+#include "depth.h"
+#include "selection.h"
+#include "hierarchy.h"
+#include "input.h"
+#include "profile.h"
+#include "textcache.h"
+#include "style.h"
+#include "import.h"
 #include <stdio.h>
 
 #define RAYGUI_IMPLEMENTATION
+#define RAYGUI_TEXT_CACHE
 #include "../external/raygui.h"
 #include <math.h>
 
-typedef enum {
-	WIDGET_WindowBox=0,
-	WIDGET_GroupBox,
-	WIDGET_Line,
-	WIDGET_Panel,
-	WIDGET_ScrollPanel,
-	WIDGET_Label,
-	WIDGET_Button,
-	WIDGET_LabelButton,
-	WIDGET_ImageButton,
-	WIDGET_Toggle,
-	WIDGET_ToggleGroup,
-	WIDGET_CheckBox,
-	WIDGET_ComboBox,
-	WIDGET_DropdownBox,
-	WIDGET_Spinner,
-	WIDGET_ValueBox,
-	WIDGET_TextBox,
-	WIDGET_TextBoxMulti,
-	WIDGET_Slider,
-	WIDGET_SliderBar,
-	WIDGET_ProgressBar,
-	WIDGET_StatusBar,
-	WIDGET_Dummy,
-	WIDGET_ListView,
-	WIDGET_ColorPicker,
-	WIDGET_MessageBox,
-	WIDGET_ColorPanel,
-	WIDGET_ColorBarAlpha,
-	WIDGET_ColorBarHue,
-	WIDGET_Grid,
-	WIDGET_COUNT
-} WidgetType;
-
-char* WidgetName[] = {
-	"WindowBox",
-	"GroupBox",
-	"Line",
-	"Panel",
-	"ScrollPanel",
-	"Label",
-	"Button",
-	"LabelButton",
-	"ImageButton",
-	"Toggle",
-	"ToggleGroup",
-	"CheckBox",
-	"ComboBox",
-	"DropdownBox",
-	"Spinner",
-	"ValueBox",
-	"TextBox",
-	"TextBoxMulti",
-	"Slider",
-	"SliderBar",
-	"ProgressBar",
-	"StatusBar",
-	"Dummy",
-	"ListView",
-	"ColorPicker",
-	"MessageBox",
-	//newer/experimental controls in raygui!?
-	"ColorPanel",
-	"ColorBarAlpha",
-	"ColorBarHue",
-	"Grid"
-};
-
-
 typedef enum {
 	MODE_NORMAL = 0,
 	MODE_RESIZE_WIDGET,
 	MODE_MOVE_WIDGET,
 	MODE_SHOW_MENU,
+	MODE_SELECT_BOX,
 } EditorMode;
 
 const char* EditorModeName[] = {
-	"NORMAL", "RESIZE", "MOVE", "MENU"
+	"NORMAL", "RESIZE", "MOVE", "MENU", "SELECT"
 };
 
-typedef struct {
-	WidgetType type;
-	Rectangle bounds; 
-} Widget;
-
-typedef Array(Widget) ArrayWidget;
-
-
 /* RESIZER POINTS ARE ARRANGED LIKE THIS
  *    7     0     1 
  *   NW     N     NE
@@ -123,36 +64,331 @@ int resizerPointActive = -1;
 EditorMode mode = MODE_NORMAL;
 int snapDistance = 5;
 bool snap = true;
-int selectedWidget = -1;
+CodeStyle codeStyle = CODE_CALLS; //of the C code written by SaveUI()
+const char* CodeStyleName[CODE_STYLE_COUNT] = { "CALLS", "TABLES" };
+ImportPlacement importPlacement = IMPORT_OFFSET; //of the files dropped together
+const char* ImportPlacementName[IMPORT_PLACEMENT_COUNT] = { "OFFSET", "TILE" };
+//the import batch being added to the widget array, see MergeImports()
+struct {
+	ArrayImportFile batch;     //empty when there is none
+	ArrayStringRemap strings;  //where the strings of file `file` went in `widgetStrings`
+	size_t file, next;         //the next widget to add is widget `next` of file `file`
+	size_t first;              //slot of the first widget of the batch
+	size_t total, added;
+	int files;                 //that were read
+	AlignAppend alignment;     //started once all of them are in
+	bool aligning;
+} merge = {0};
+int selectedWidget = -1; //the widget clicked last, always part of the selection
+Selection selection; //every selected widget
 int addWidget = -1;
 Texture2D texture; //a dummy texture used as a placeholder (some widgets require a texture)
 
+Arena frameArena; //scratch memory, released at the start of every frame
 ArrayWidget widgets = {0};
+StringTable widgetStrings; //every text of the widgets, never shrinks so undo can bring a text back
+DepthOrder order; //draw order of the widgets, kept apart so reordering never moves them
+int nextWidgetId = 0;
+const char* projectFile = "project.ui"; //autosaved by the journal
+bool headless = false;
+SpatialIndex spatial; //grid used to find the widget under the mouse
+AlignIndex alignment; //sorted edges and center lines of the widgets for alignment snapping
+WidgetBounds bounds; //structure of arrays copy of the widget bounds for the bulk passes
+History history; //undo/redo
+Hierarchy hierarchy; //the containers and what's inside them, see GetHierarchy()
+bool hierarchyDirty = true;
+Selection subtrees; //the selection and everything inside the selected containers, see SelectSubtrees()
 Color resizerColor = {245,0,0,140};
 const int resizerPointSize = 8;
 
+//cached widget labels, a label only depends on the widget type and id
+//so the entry at index `i` stays valid as long as the type and id stored with it match
+typedef struct {
+	int type; //-1 when the label was never built
+	int id;
+	char text[32];
+} WidgetLabel;
+typedef Array(WidgetLabel) ArrayWidgetLabel;
+ArrayWidgetLabel labels = {0};
+
+//widgets that survived culling the last time the canvas was drawn (topmost first)
+ArrayInt drawList = {0};
+int drawnCount = 0, culledCount = 0;
+//max opaque widgets tested against when checking if a widget is hidden
+#define MAX_OCCLUDERS 32
+
 Rectangle menu = {0,0,0,0};
 int scrollIndex = 0;
 Vector2 lastMousePosition = {0,0};
 
+//a drag puts every selected widget at the position it started from plus `dragOffset`
+ArrayWidgetMove dragMoves = {0};
+WidgetBounds dragFrom; //`bounds` when the drag started
+Vector2 dragStart = {0,0}, dragOffset = {0,0};
+Rectangle dragExtent = {0}; //of the dragged widgets where the drag started
+Rectangle selectBox = {0,0,0,0}; //rubber band of MODE_SELECT_BOX
+
+//the dragged or resized widgets snap to the lines of the others (see AlignIndex)
+bool align = true;
+AlignMatch alignGuides[2] = { {-1}, {-1} }; //what they were lined up with, per axis
+Rectangle alignSubject = {0}; //what was lined up
+Color guideColor = {0,121,241,200};
+
+//the layout lint overlay, checked again after every edit while it's shown
+LintReport lint;
+bool lintShown = false;
+bool lintDirty = true;
+const Color lintColor[LINT_KIND_COUNT] = { 
+	(Color){ 230, 41, 55, 220 }, (Color){ 255, 161, 0, 220 }, (Color){ 255, 161, 0, 220 }, 
+	(Color){ 200, 0, 200, 220 }, (Color){ 200, 0, 200, 220 } 
+};
+
+//edits made to a whole selection are journaled together, see EndJournalBatch()
+typedef Array(JournalOp) ArrayJournalOp;
+ArrayJournalOp journalBatch = {0};
+bool journalBatching = false, journalBatchFull = false;
+
+static inline void BeginJournalBatch() {
+	journalBatching = true;
+	journalBatchFull = false;
+	journalBatch.size = 0;
+}
+
+//The grid and the widgets (the canvas) are drawn into `canvasLayer` and the editor's own UI
+//goes on top of it every frame. The layer is only drawn again where something changed:
+//everything after a change of the view or of the widget array, the region around the widgets
+//that moved or were resized otherwise (canvas coordinates), nothing at all when idle.
+RenderTexture2D canvasLayer = {0};
+bool redrawCanvas = true;
+bool redrawRegion = false;
+Rectangle dirtyRegion = {0};
+//the view the canvas was drawn with
+Camera2D canvasCamera = {0};
+bool canvasSnap = false;
+int canvasSnapDistance = 0;
+//a partial redraw growing past this part of the screen draws everything instead
+#define MAX_REDRAW_AREA 0.5f
+//the widgets a partial redraw has to take along are looked up this many times at most
+#define MAX_REDRAW_STEPS 8
+//raygui draws some outlines and text a little outside of the bounds
+#define REDRAW_MARGIN 2
+
+static inline void RedrawAll() {
+	redrawCanvas = true;
+}
+
+//an import batch is being added, see MergeImports()
+static inline bool Merging() {
+	return Array_size(&merge.batch) > 0;
+}
+
+static inline Rectangle NormalizeRec(Rectangle r) {
+	if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+	if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+	return r;
+}
+
+static inline Rectangle UnionRec(Rectangle a, Rectangle b) {
+	float x0 = fminf(a.x, b.x), y0 = fminf(a.y, b.y);
+	return (Rectangle){ x0, y0, fmaxf(a.x+a.width, b.x+b.width) - x0, fmaxf(a.y+a.height, b.y+b.height) - y0 };
+}
+
+//Draw `r` (canvas coordinates) again with the next frame
+static void RedrawRegion(Rectangle r) {
+	r = NormalizeRec(r);
+	dirtyRegion = redrawRegion ? UnionRec(dirtyRegion, r) : r;
+	redrawRegion = true;
+}
+
+static void Journal(JournalOp op) {
+	hierarchyDirty = true;
+	lintDirty = true;
+	//the callers of JOURNAL_SET redraw where the widget was
+	if(op.op == JOURNAL_SET) RedrawRegion(op.widget.bounds);
+	else RedrawAll();
+	if(!journalBatching) JournalRecord(op);
+	else if(!journalBatchFull) {
+		//a batch with as many edits as a compaction would take is written as a snapshot instead
+		journalBatchFull = Array_size(&journalBatch) >= JOURNAL_COMPACT_OPS || Array_push(&journalBatch, op) != VEE_OK;
+	}
+}
+
+static void EndJournalBatch() {
+	journalBatching = false;
+	if(journalBatchFull) JournalSnapshot(&widgets, &order, &widgetStrings);
+	else for(ArrayIt i=0; i<Array_size(&journalBatch); ++i) JournalRecord(Array_at(&journalBatch, i));
+	journalBatch.size = 0;
+}
+
+//The hierarchy of the widgets as they are now. Every edit is journaled, it's built again
+//the first time it's needed after one.
+static const Hierarchy* GetHierarchy() {
+	if(!hierarchyDirty) return &hierarchy;
+	PROFILE_ZONE("BuildHierarchy");
+	size_t n = Array_size(&widgets);
+	int* byDepth = (n > 0) ? arena_alloc(&frameArena, n*sizeof(int)) : NULL;
+	if(n > 0 && byDepth == NULL) {
+		HierarchyDestroy(&hierarchy);
+		return &hierarchy;
+	}
+	int k = 0;
+	for(int i = order.bottom; i != DEPTH_NONE; i = DepthAbove(&order, i)) byDepth[k++] = i;
+	//an empty hierarchy (out of memory) only means the selection is edited on its own
+	hierarchyDirty = HierarchyBuild(&hierarchy, &widgets, byDepth) != VEE_OK;
+	return &hierarchy;
+}
+
+//Put the selection and every widget inside a selected container in `subtrees`, they're
+//moved, reordered, duplicated and removed together. Returns VEE_OK[0] on success.
+static int SelectSubtrees() {
+	int r = SelectionCopy(&subtrees, &selection);
+	if(r == VEE_OK) r = HierarchyAddDescendants(GetHierarchy(), &subtrees);
+	return r;
+}
+
 //colors for the the snap grid
 const Color gridLineColor[2] = { 
 	(Color){ 120, 120, 120, 25 }, 
 	(Color){ 120, 120, 120, 50 } 
 };
-static inline void DrawSnapGrid(int size, Color c) {
-	//calculate how many squares we can fit
-	int sq = (screenWidth>screenHeight) ? screenWidth/size : screenHeight/size;
-	//and draw them
-	for(int i=0; i<sq; ++i) {
-		DrawLine(0, i*size, screenWidth, i*size,  c);
-		DrawLine(i*size, 0, i*size, screenHeight, c);
+#define MIN_SNAP_DISTANCE 2
+#define MAX_SNAP_DISTANCE 64
+
+// -------
+// VIEW
+// -------
+
+//The canvas is seen through `camera`, its target stays at the origin so a point of the
+//canvas is at `point*zoom + offset` on the screen. The widgets, the selection box and the
+//drag are in canvas coordinates, the menu, the resize points and the status line are in
+//screen coordinates.
+Camera2D camera = { {0, 0}, {0, 0}, 0, 1 };
+Vector2 panMouse = {0,0}; //screen position of the mouse while panning
+#define MIN_ZOOM 0.02f
+#define MAX_ZOOM 8.0f
+#define ZOOM_STEP 1.25f
+//below this zoom the widgets are drawn as flat rectangles
+#define LOD_ZOOM 0.5f
+
+static inline Vector2 ScreenToWorld(Vector2 p) {
+	return (Vector2){ (p.x - camera.offset.x)/camera.zoom, (p.y - camera.offset.y)/camera.zoom };
+}
+
+static inline Vector2 WorldToScreen(Vector2 p) {
+	return (Vector2){ p.x*camera.zoom + camera.offset.x, p.y*camera.zoom + camera.offset.y };
+}
+
+static inline Rectangle WorldToScreenRec(Rectangle r) {
+	return (Rectangle){ r.x*camera.zoom + camera.offset.x, r.y*camera.zoom + camera.offset.y, 
+		r.width*camera.zoom, r.height*camera.zoom };
+}
+
+static inline Vector2 WorldMouse() {
+	return ScreenToWorld(InputMousePosition());
+}
+
+static inline void RecalculateResizePoints();
+static inline bool TypingProperty();
+
+//Pan with the middle mouse button, zoom around the mouse with the wheel, reset with 0
+static void UpdateView(Vector2 screen) {
+	Camera2D before = camera;
+	if(InputMouseButtonDown(MOUSE_MIDDLE_BUTTON)) {
+		if(!InputMouseButtonPressed(MOUSE_MIDDLE_BUTTON)) {
+			camera.offset.x += screen.x - panMouse.x;
+			camera.offset.y += screen.y - panMouse.y;
+		}
+		panMouse = screen;
+	}
+	
+	//the wheel scrolls the menu while it's open
+	int wheel = (mode == MODE_SHOW_MENU) ? 0 : InputMouseWheelMove();
+	if(wheel != 0) {
+		//the point under the mouse stays where it is
+		Vector2 p = ScreenToWorld(screen);
+		float zoom = camera.zoom*powf(ZOOM_STEP, wheel);
+		camera.zoom = (zoom < MIN_ZOOM) ? MIN_ZOOM : (zoom > MAX_ZOOM) ? MAX_ZOOM : zoom;
+		camera.offset = (Vector2){ screen.x - p.x*camera.zoom, screen.y - p.y*camera.zoom };
+	}
+	
+	if(InputKeyPressed(KEY_ZERO) && !TypingProperty()) camera = (Camera2D){ {0, 0}, {0, 0}, 0, 1 };
+	
+	bool moved = camera.zoom != before.zoom || camera.offset.x != before.offset.x || camera.offset.y != before.offset.y;
+	if(moved && selectedWidget != -1) RecalculateResizePoints();
+}
+
+//The grid is drawn once into `gridLayer` and only drawn again when the spacing, the zoom
+//or the size of the view changes, every other frame it's a single textured quad. The layer
+//is one major line period bigger than the view, panning only moves where it's drawn.
+RenderTexture2D gridLayer = {0};
+int gridLayerSpacing = 0;
+float gridLayerZoom = 0;
+
+//`c` drawn over `bg`, the layer is opaque so it doesn't depend on how its alpha is blended
+static inline Color BlendColor(Color c, Color bg) {
+	float a = c.a/255.0f;
+	return (Color){ c.r*a + bg.r*(1-a), c.g*a + bg.g*(1-a), c.b*a + bg.b*(1-a), 255 };
+}
+
+//`spacing` is the distance between the lines on the screen
+static void RenderSnapGrid(int width, int height, float spacing) {
+	if(gridLayer.id != 0 && (gridLayer.texture.width != width || gridLayer.texture.height != height)) {
+		UnloadRenderTexture(gridLayer);
+		gridLayer = (RenderTexture2D){0};
 	}
+	if(gridLayer.id == 0) {
+		gridLayer = LoadRenderTexture(width, height);
+		gridLayerSpacing = 0;
+	}
+	if(gridLayerSpacing == snapDistance && gridLayerZoom == camera.zoom) return;
+	gridLayerSpacing = snapDistance;
+	gridLayerZoom = camera.zoom;
+	
+	PROFILE_ZONE("RenderSnapGrid");
+	//every 4th line is darker, the others are left out once they get too close to each other
+	const Color minor = BlendColor(gridLineColor[0], RAYWHITE);
+	const Color major = BlendColor(gridLineColor[0], BlendColor(gridLineColor[1], RAYWHITE));
+	const bool minorLines = spacing >= 4;
+	BeginTextureMode(gridLayer);
+		ClearBackground(RAYWHITE);
+		for(int i=0; roundf(i*spacing) < height; ++i) {
+			int y = roundf(i*spacing);
+			if(i%4 == 0) DrawLine(0, y, width, y, major);
+			else if(minorLines) DrawLine(0, y, width, y, minor);
+		}
+		for(int i=0; roundf(i*spacing) < width; ++i) {
+			int x = roundf(i*spacing);
+			if(i%4 == 0) DrawLine(x, 0, x, height, major);
+			else if(minorLines) DrawLine(x, 0, x, height, minor);
+		}
+	EndTextureMode();
+}
+
+//Bring the grid layer up to date and store where it goes on the screen in `at`. Returns false
+//when the lines are too close to draw. Not while drawing into another render texture.
+static bool PrepareSnapGrid(Vector2* at) {
+	const float spacing = snapDistance*camera.zoom, period = 4*spacing;
+	if(period < 4) return false; //nothing but lines
+	const int extra = ceilf(period);
+	RenderSnapGrid(screenWidth + extra, screenHeight + extra, spacing);
+	//a major line goes through the origin, the layer starts at the one left of and above the screen
+	*at = (Vector2){ fmodf(camera.offset.x, period), fmodf(camera.offset.y, period) };
+	if(at->x > 0) at->x -= period;
+	if(at->y > 0) at->y -= period;
+	return true;
+}
+
+//the part `r` of the screen of the grid layer placed at `at`
+static inline void DrawSnapGrid(Vector2 at, Rectangle r) {
+	PROFILE_ZONE("DrawSnapGrid");
+	//render textures are upside down
+	Rectangle src = { r.x - at.x, gridLayer.texture.height - (r.y - at.y) - r.height, r.width, -r.height };
+	DrawTextureRec(gridLayer.texture, src, (Vector2){ r.x, r.y }, WHITE);
 }
 
 
 static inline int CheckCollisionWithResizerPoints() {
-	Vector2 mouse = GetMousePosition();
+	Vector2 mouse = InputMousePosition();
 	for(int i=0; i<RESIZER_POINT_COUNT; ++i) {
 		if(CheckCollisionPointRec(mouse, resizerPoints[i]))
 			return i;
@@ -160,8 +396,9 @@ static inline int CheckCollisionWithResizerPoints() {
 	return -1;
 }
 
+//the resize points keep their size at every zoom, so they're in screen coordinates
 static inline void RecalculateResizePoints() {
-	Rectangle r = Array_at(&widgets, selectedWidget).bounds;
+	Rectangle r = WorldToScreenRec(Array_at(&widgets, selectedWidget).bounds);
 	r.x-=4; r.y-=4; r.width+=8; r.height+=8;
 	
 	const int hrp = resizerPointSize/2;
@@ -183,273 +420,685 @@ static inline void RecalculateResizePoints() {
 				resizerPointSize, resizerPointSize};
 }
 
-//Bring to front (increase widget depth by one)
-//widgets are rendered from lowest depth to highest
-//so widgets with high depth will be rendered above 
-//widgets with lower depth
-static inline void BringToFront() {
-	if( selectedWidget+1 < Array_size(&widgets)) {
-		Widget w = Array_at(&widgets, selectedWidget);
-		Array_at(&widgets, selectedWidget) = Array_at(&widgets, selectedWidget+1);
-		Array_at(&widgets, selectedWidget+1) = w;
-		TraceLog(LOG_INFO, TextFormat("Changing depth %i -> %i", selectedWidget, selectedWidget+1));
-		selectedWidget += 1;
+//Change the bounds of widget `i` and keep the spatial index in sync.
+//All the geometry changes of existing widgets should go through here (except moving the selection, see EndDrag()).
+static inline void SetWidgetBounds(int i, Rectangle r) {
+	Widget* w = &Array_at(&widgets, i);
+	Widget before = *w;
+	Rectangle b = w->bounds;
+	if(b.x == r.x && b.y == r.y && b.width == r.width && b.height == r.height) return;
+	SpatialIndexUpdate(&spatial, i, b, r);
+	AlignIndexUpdate(&alignment, i, b, r);
+	BoundsSet(&bounds, i, r);
+	RedrawRegion(b);
+	w->bounds = r;
+	HistoryRecord(&history, (HistoryEntry){ HISTORY_SET, i, .before = before, .widget = *w });
+	Journal((JournalOp){ JOURNAL_SET, i, 0, *w });
+}
+
+static inline bool SameProps(WidgetProps a, WidgetProps b) {
+	return a.set == b.set && a.text == b.text && a.items == b.items && a.min == b.min && a.max == b.max && a.value == b.value &&
+		a.color.r == b.color.r && a.color.g == b.color.g && a.color.b == b.color.b && a.color.a == b.color.a;
+}
+
+//Change the properties of widget `i`, their strings are in `widgetStrings` and were written
+//by a snapshot already (see CommitPropertyText()).
+static void SetWidgetProps(int i, WidgetProps p) {
+	Widget* w = &Array_at(&widgets, i);
+	if(SameProps(w->props, p)) return;
+	Widget before = *w;
+	w->props = p;
+	RedrawRegion(w->bounds);
+	HistoryRecord(&history, (HistoryEntry){ HISTORY_SET, i, .before = before, .widget = *w });
+	Journal((JournalOp){ JOURNAL_SET, i, 0, *w });
+}
+
+//Put widget `i` right above widget `below` (DEPTH_NONE for the very bottom).
+//widgets are rendered from lowest depth to highest so widgets with high depth
+//will be rendered above widgets with lower depth. All the depth changes should go through here.
+static void MoveWidget(int i, int below) {
+	int oldBelow = DepthBelow(&order, i);
+	if(i == below || oldBelow == below) return;
+	DepthOrderMove(&order, i, below);
+	HistoryRecord(&history, (HistoryEntry){ HISTORY_MOVE, i, .below = below, .oldBelow = oldBelow });
+	Journal((JournalOp){ JOURNAL_MOVE, i, below });
+}
+
+//Bring to front (increase the depth of the widgets in `s` by one)
+//walks from the top so a selected widget is moved after the ones above it made room
+static void BringToFront(const Selection* s) {
+	for(int i = order.top, next; i != DEPTH_NONE; i = next) {
+		next = DepthBelow(&order, i);
+		int above = DepthAbove(&order, i);
+		if(SelectionHas(s, i) && above != DEPTH_NONE && !SelectionHas(s, above)) 
+			MoveWidget(i, above);
 	}
 }
 
-//Send to back (decrease widget depth by one)
-//widgets are rendered from lowest depth to highest
-//so widgets with lower depth will be rendered below 
-//widgets with higher depth
-static inline void SendToBack() {
-	if(selectedWidget - 1 >= 0) {
-		Widget w = Array_at(&widgets, selectedWidget);
-		Array_at(&widgets, selectedWidget) = Array_at(&widgets, selectedWidget-1);
-		Array_at(&widgets, selectedWidget-1) = w;
-		TraceLog(LOG_INFO, TextFormat("Changing depth %i -> %i", selectedWidget, selectedWidget-1));
-		selectedWidget -= 1;
+//Send to back (decrease the depth of the widgets in `s` by one)
+static void SendToBack(const Selection* s) {
+	for(int i = order.bottom, next; i != DEPTH_NONE; i = next) {
+		next = DepthAbove(&order, i);
+		int below = DepthBelow(&order, i);
+		if(SelectionHas(s, i) && below != DEPTH_NONE && !SelectionHas(s, below)) 
+			MoveWidget(i, DepthBelow(&order, below));
 	}
 }
 
-int SelectWidget() {
-	Vector2 mouse = GetMousePosition();
-	if(Array_size(&widgets) == 0) return -1;
-	for(int i=Array_size(&widgets)-1; i>=0; --i) {
+//Widgets of `s` from the bottom to the top, in frame memory. NULL if `s` is empty.
+static int* SelectionByDepth(const Selection* s, size_t* n) {
+	*n = 0;
+	int* list = (s->count > 0) ? arena_alloc(&frameArena, s->count*sizeof(int)) : NULL;
+	if(list == NULL) return NULL;
+	for(int i = order.bottom; i != DEPTH_NONE; i = DepthAbove(&order, i))
+		if(SelectionHas(s, i)) list[(*n)++] = i;
+	return list;
+}
+
+//Stack the widgets of `s` right above widget `below` (DEPTH_NONE for the very bottom),
+//keeping their order. `below` may be in `s` itself.
+static void MoveSelection(const Selection* s, int below) {
+	size_t n;
+	int* list = SelectionByDepth(s, &n);
+	for(size_t k=0; k<n; ++k) {
+		MoveWidget(list[k], below);
+		below = list[k];
+	}
+}
+
+//Select only widget `i` (-1 to clear the selection)
+static void SelectOnly(int i) {
+	SelectionClear(&selection);
+	if(i != -1) SelectionAdd(&selection, i);
+	selectedWidget = i;
+}
+
+//Add `w` above all the other widgets and give it a new id. Returns its index or -1.
+static int AddWidgetOnTop(Widget w) {
+	int i = Array_size(&widgets), below = order.top;
+	w.id = nextWidgetId;
+	if(WidgetSwapInsert(&widgets, i, w) != VEE_OK) return -1;
+	if(DepthOrderSwapInsert(&order, i, below) != VEE_OK) {
+		Array_pop(&widgets);
+		return -1;
+	}
+	if(BoundsSwapInsert(&bounds, i, w.bounds) != VEE_OK) {
+		DepthOrderSwapRemove(&order, i);
+		Array_pop(&widgets);
+		return -1;
+	}
+	++nextWidgetId;
+	SpatialIndexInsert(&spatial, i, w.bounds);
+	AlignIndexInsert(&alignment, i, w.bounds);
+	HistoryRecord(&history, (HistoryEntry){ HISTORY_INSERT, i, .below = below, .widget = w });
+	Journal((JournalOp){ JOURNAL_INSERT, i, below, w });
+	return i;
+}
+
+//Remove widget `i`. The last widget takes its index.
+static void RemoveWidget(int i) {
+	Widget w = Array_at(&widgets, i);
+	int last = Array_size(&widgets)-1, below = DepthBelow(&order, i);
+	SpatialIndexRemove(&spatial, i, w.bounds);
+	AlignIndexRemove(&alignment, i, w.bounds);
+	if(i != last) {
+		SpatialIndexRename(&spatial, last, i, Array_at(&widgets, last).bounds);
+		AlignIndexRename(&alignment, last, i, Array_at(&widgets, last).bounds);
+	}
+	WidgetSwapRemove(&widgets, i);
+	DepthOrderSwapRemove(&order, i);
+	BoundsSwapRemove(&bounds, i);
+	SelectionSwapRemove(&selection, i, last);
+	if(selectedWidget == i) selectedWidget = -1;
+	else if(selectedWidget == last) selectedWidget = i;
+	HistoryRecord(&history, (HistoryEntry){ HISTORY_REMOVE, i, .below = below, .widget = w });
+	Journal((JournalOp){ JOURNAL_REMOVE, i });
+}
+
+//Remove every widget of `s` (not the selection itself, RemoveWidget() changes it). Goes from
+//the last slot down so the widget that takes the place of a removed one was already looked at.
+static void RemoveSelection(const Selection* s) {
+	for(int i = Array_size(&widgets)-1; i >= 0; --i)
+		if(SelectionHas(s, i)) RemoveWidget(i);
+	selectedWidget = -1;
+}
+
+//Add a copy of every widget of `s` (not the selection itself) on top, keeping their order.
+//The copies of the selected widgets are selected.
+static void DuplicateSelection(const Selection* s) {
+	size_t n;
+	int* list = SelectionByDepth(s, &n);
+	bool* selected = (n > 0) ? arena_alloc(&frameArena, n*sizeof(bool)) : NULL;
+	if(selected == NULL) return;
+	for(size_t k=0; k<n; ++k) selected[k] = SelectionHas(&selection, list[k]);
+	SelectOnly(-1);
+	for(size_t k=0; k<n; ++k) {
+		int i = AddWidgetOnTop(Array_at(&widgets, list[k]));
+		if(i != -1 && selected[k] && SelectionAdd(&selection, i) == VEE_OK) selectedWidget = i;
+	}
+}
+
+//Realign the widgets of `s` to the snap grid.
+//Happens when they were added/moved while snap was off.
+static void SnapSelection(const Selection* s) {
+	size_t words = (BoundsSize(&bounds)+63)/64;
+	uint64_t* changed = (words > 0) ? arena_alloc(&frameArena, words*sizeof(uint64_t)) : NULL;
+	if(changed == NULL) return;
+	memset(changed, 0, words*sizeof(uint64_t));
+	//snaps the copy in one pass, only the widgets that moved need to be changed
+	BoundsSnap(&bounds, Array_data(&s->words), Array_size(&s->words), snapDistance, changed);
+	for(size_t k=0; k<words; ++k) {
+		for(uint64_t bits = changed[k]; bits != 0; bits &= bits-1) {
+			int i = k*64 + __builtin_ctzll(bits);
+			SetWidgetBounds(i, BoundsAt(&bounds, i));
+		}
+	}
+}
+
+//Bring the indices and the journal up to date after the widgets of the HISTORY_TRANSLATE `e` moved
+static void ApplyTranslate(const HistoryEntry* e) {
+	//moving a good part of the layout is cheaper to index again from scratch
+	bool rebuild = e->count > Array_size(&widgets)/8;
+	if(rebuild) SpatialIndexRebuild(&spatial, &widgets);
+	//a big batch of lines is taken out and merged back in one pass
+	size_t words = (Array_size(&widgets)+63)/64;
+	uint64_t* moved = (e->count > ALIGN_BATCH_MIN) ? arena_alloc(&frameArena, words*sizeof(uint64_t)) : NULL;
+	if(moved != NULL) {
+		memset(moved, 0, words*sizeof(uint64_t));
+		for(size_t k=0; k<e->count; ++k) moved[e->moves[k].index/64] |= 1ull << (e->moves[k].index%64);
+		AlignIndexRefresh(&alignment, &widgets, moved, words);
+	}
+	for(size_t k=0; k<e->count; ++k) {
+		Rectangle to = Array_at(&widgets, e->moves[k].index).bounds, from = to;
+		Vector2 p = HistoryMovedTo(e, e->moves[k], true);
+		from.x = p.x; from.y = p.y;
+		if(!rebuild) SpatialIndexUpdate(&spatial, e->moves[k].index, from, to);
+		if(moved == NULL) AlignIndexUpdate(&alignment, e->moves[k].index, from, to);
+	}
+	for(size_t k=0; k<e->count; ++k) {
+		Widget w = Array_at(&widgets, e->moves[k].index);
+		BoundsSet(&bounds, e->moves[k].index, w.bounds);
+		Journal((JournalOp){ JOURNAL_SET, e->moves[k].index, 0, w });
+	}
+}
+
+//Remember where the widgets of `subtrees` start from, they follow the mouse until EndDrag()
+static void BeginDrag(Vector2 mouse) {
+	dragOffset = (Vector2){0, 0};
+	dragStart = mouse;
+	if(SelectionMoves(&subtrees, &widgets, &dragMoves) != VEE_OK) return;
+	if(BoundsCopy(&dragFrom, &bounds) != VEE_OK) {
+		dragMoves.size = 0;
+		return;
+	}
+	for(ArrayIt k=0; k<Array_size(&dragMoves); ++k) {
+		Rectangle r = NormalizeRec(Array_at(&widgets, Array_at(&dragMoves, k).index).bounds);
+		dragExtent = (k == 0) ? r : UnionRec(dragExtent, r);
+	}
+	mode = MODE_MOVE_WIDGET;
+}
+
+typedef struct {
+	int root;      //dragged widget that isn't inside another dragged one
+	int container; //the topmost container it was dropped on, above it
+} DropTarget;
+
+static int CompareDepth(const void* a, const void* b) {
+	uint64_t x = DepthKey(&order, *(const int*)a), y = DepthKey(&order, *(const int*)b);
+	return (x > y) - (x < y);
+}
+
+static int CompareDropTargets(const void* a, const void* b) {
+	return -CompareDepth(&((const DropTarget*)a)->root, &((const DropTarget*)b)->root);
+}
+
+//The dragged widgets (`subtrees`) dropped on a container that is above them go right above
+//it, with everything inside them, so they end up inside it.
+static void RaiseIntoContainers() {
+	const Hierarchy* h = GetHierarchy();
+	size_t n = 0;
+	DropTarget* targets = (subtrees.count > 0) ? arena_alloc(&frameArena, subtrees.count*sizeof(DropTarget)) : NULL;
+	int* list = (subtrees.count > 0) ? arena_alloc(&frameArena, subtrees.count*sizeof(int)) : NULL;
+	if(targets == NULL || list == NULL || Array_size(&h->parent) != Array_size(&widgets)) return;
+
+	for(int i = SelectionNext(&subtrees, 0); i != -1; i = SelectionNext(&subtrees, i+1)) {
+		int parent = HierarchyParent(h, i);
+		if(parent != -1 && SelectionHas(&subtrees, parent)) continue;
+		int top = -1;
+		for(ArrayIt k = Array_size(&h->containers); k-- > 0 && top == -1;) {
+			int c = Array_at(&h->containers, k);
+			if(!SelectionHas(&subtrees, c) && ContainerHolds(Array_at(&widgets, c), Array_at(&widgets, i).bounds)) top = c;
+		}
+		if(top != -1 && DepthKey(&order, top) > DepthKey(&order, i)) targets[n++] = (DropTarget){ i, top };
+	}
+
+	//from the top down, each one goes right below the one raised before it
+	qsort(targets, n, sizeof(DropTarget), CompareDropTargets);
+	for(size_t t=0; t<n; ++t) {
+		//the dragged widgets inside the root, in the hierarchy from before any of them was raised
+		size_t count = 0;
+		list[count++] = targets[t].root;
+		for(size_t k=0; k<count; ++k) {
+			const int* c = HierarchyChildren(h, list[k]);
+			for(int j=0; j<HierarchyChildCount(h, list[k]); ++j)
+				if(SelectionHas(&subtrees, c[j])) list[count++] = c[j];
+		}
+		qsort(list, count, sizeof(int), CompareDepth);
+		int below = targets[t].container;
+		for(size_t k=0; k<count; ++k) {
+			MoveWidget(list[k], below);
+			below = list[k];
+		}
+	}
+}
+
+static void EndDrag() {
+	size_t n = Array_size(&dragMoves);
+	dragMoves.size = 0;
+	if(n == 0 || (dragOffset.x == 0 && dragOffset.y == 0)) return;
+	HistoryEntry e = { .op = HISTORY_TRANSLATE, .count = n, .moves = Array_data(&dragMoves), .offset = dragOffset };
+	HistoryRecordTranslate(&history, e.moves, n, dragOffset);
+	BeginJournalBatch();
+	ApplyTranslate(&e);
+	RaiseIntoContainers();
+	EndJournalBatch();
+}
+
+static inline const char* GetWidgetLabel(int i) {
+	Widget w = Array_at(&widgets, i);
+	if(Array_size(&labels) < Array_size(&widgets)) {
+		size_t n = Array_size(&labels);
+		if(Array_reserve(&labels, Array_size(&widgets)) != VEE_OK) 
+			return TextFormat("%s%03i", WidgetName[w.type], w.id);
+		for(; n<Array_size(&widgets); ++n) Array_at(&labels, n).type = -1;
+		labels.size = Array_size(&widgets);
+	}
+	
+	WidgetLabel* l = &Array_at(&labels, i);
+	if(l->type != (int)w.type || l->id != w.id) {
+		//the image button label is padded so it doesn't overlap the image
+		snprintf(l->text, sizeof(l->text), (w.type == WIDGET_ImageButton) ? "  %s%03i" : "%s%03i", WidgetName[w.type], w.id);
+		l->type = w.type;
+		l->id = w.id;
+	}
+	return l->text;
+}
+
+//widgets that fill their whole bounds and hide everything below them
+static inline bool IsOpaqueWidget(Widget w) {
+	return (w.type == WIDGET_WindowBox || w.type == WIDGET_Panel) && w.bounds.width > 0 && w.bounds.height > 0;
+}
+
+static inline bool IsRecInside(Rectangle r, Rectangle o) {
+	return r.x >= o.x && r.y >= o.y && r.x+r.width <= o.x+o.width && r.y+r.height <= o.y+o.height;
+}
+
+//Set the bit in `onScreen` of every widget overlapping `view`, going down the hierarchy from
+//the top level widgets. The widgets inside a container that is off screen are never looked at:
+//they are inside it, or for a ScrollPanel start inside it and go right and down.
+static void MarkOnScreen(const Hierarchy* h, Rectangle view, uint64_t* onScreen) {
+	int* stack = arena_alloc(&frameArena, Array_size(&widgets)*sizeof(int));
+	if(stack == NULL) {
+		BoundsOverlap(&bounds, view, onScreen);
+		return;
+	}
+	size_t n = Array_size(&h->roots);
+	memcpy(stack, Array_data(&h->roots), n*sizeof(int));
+	while(n > 0) {
+		int i = stack[--n];
 		Widget w = Array_at(&widgets, i);
-		if(CheckCollisionPointRec(mouse, w.bounds)) {
-			return i;
+		Rectangle r = w.bounds;
+		if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+		if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+		bool overlaps = r.x <= view.x+view.width && r.y <= view.y+view.height && r.x+r.width >= view.x && r.y+r.height >= view.y;
+		if(overlaps) onScreen[i/64] |= 1ull << (i%64);
+		
+		bool open = overlaps || (w.type == WIDGET_ScrollPanel && r.x <= view.x+view.width && r.y <= view.y+view.height);
+		if(!open) continue;
+		int count = HierarchyChildCount(h, i);
+		memcpy(&stack[n], HierarchyChildren(h, i), count*sizeof(int));
+		n += count;
+	}
+}
+
+//Fill the draw list with the widgets that need to be drawn this frame. Widgets outside
+//the screen or fully covered by an opaque widget above them are skipped.
+static void CullWidgets() {
+	PROFILE_ZONE("CullWidgets");
+	const Vector2 corner = ScreenToWorld((Vector2){0, 0});
+	const Rectangle view = {corner.x, corner.y, screenWidth/camera.zoom, screenHeight/camera.zoom};
+	Rectangle occluders[MAX_OCCLUDERS];
+	int occluderCount = 0;
+	//built again once the edits are over (and an import batch is in), while dragging the widgets move away from it
+	const Hierarchy* h = (mode == MODE_NORMAL && !Merging()) ? GetHierarchy() : NULL;
+	bool nested = h != NULL && !hierarchyDirty && Array_size(&h->roots) < Array_size(&widgets)/2;
+	
+	//room for every widget, so the pushes below never reallocate
+	drawList.size = 0;
+	Array_reserve(&drawList, Array_size(&widgets));
+	culledCount = 0;
+	
+	//everything on screen in one pass, the walk below only looks at the occluders. When most
+	//widgets are in containers the hierarchy skips the ones in containers off screen instead.
+	size_t words = (BoundsSize(&bounds)+63)/64;
+	uint64_t* onScreen = (words > 0) ? arena_alloc(&frameArena, words*sizeof(uint64_t)) : NULL;
+	if(onScreen != NULL) {
+		memset(onScreen, 0, words*sizeof(uint64_t));
+		if(nested) MarkOnScreen(h, view, onScreen);
+		else BoundsOverlap(&bounds, view, onScreen);
+	}
+	
+	for(int i=order.top; i != DEPTH_NONE; i = DepthBelow(&order, i)) {
+		Widget w = Array_at(&widgets, i);
+		Rectangle r = w.bounds;
+		//widgets resized past the opposite edge have negative sizes
+		if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+		if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+		
+		bool visible = onScreen != NULL && ((onScreen[i/64] >> (i%64)) & 1);
+		for(int j=0; visible && j<occluderCount; ++j)
+			if(IsRecInside(r, occluders[j])) visible = false;
+		
+		if(!visible || Array_push(&drawList, i) != VEE_OK) {
+			++culledCount;
+			continue;
 		}
+		if(IsOpaqueWidget(w) && occluderCount < MAX_OCCLUDERS) occluders[occluderCount++] = w.bounds;
 	}
-	return -1;
+	drawnCount = Array_size(&drawList);
+}
+
+int SelectWidget() {
+	Vector2 mouse = WorldMouse();
+	if(Array_size(&widgets) == 0) return -1;
+	return SpatialIndexPick(&spatial, &widgets, &order, mouse);
 }
 
 void SaveUI() {
+	PROFILE_ZONE("SaveUI");
 	int count = Array_size(&widgets);
 	if(count == 0) return;
-	const char* file = "project.ui";
-	remove(file);
-	//WRITE THE BINARY `*.ui` FILE
-	FILE* f = fopen(file, "wb");
-	if(f == NULL) {
-		TraceLog(LOG_WARNING,TextFormat("Failed to save UI to file `%s`", file));
-		return;
+	//the `*.ui` and the C source file are written by the journal thread
+	JournalExport(&widgets, &order, &widgetStrings, codeStyle);
+}
+
+void SaveProject() {
+	JournalSnapshot(&widgets, &order, &widgetStrings);
+}
+
+int RecordEditor(const char* trace) {
+	return InputRecord(trace, &widgets, &order, &widgetStrings);
+}
+
+//Take the next import batch that was read completely. The widget array gets room for all of it
+//at once, so it isn't moved while the batch is added.
+static bool BeginMerge() {
+	if(!ImportTake(&merge.batch)) return false;
+	ImportPlace(&merge.batch, importPlacement);
+	merge.file = merge.next = merge.total = merge.added = 0;
+	merge.files = 0;
+	for(ArrayIt i=0; i<Array_size(&merge.batch); ++i) {
+		ImportFile* f = Array_at(&merge.batch, i);
+		if(f->result < 0) TraceLog(LOG_WARNING,TextFormat("Failed to load UI from file `%s`", f->path));
+		if(f->result <= 0) continue;
+		merge.total += f->result;
+		++merge.files;
 	}
 	
-	const char* magic = "UIF"; //write magic
-	fwrite(magic, sizeof(char), strlen(magic), f);
-	//write widget count
-	fwrite(&count, 1, sizeof(int), f);
-	//dump all the widgets
-	for(ArrayIt i=0; i<count; ++i) {
-		Widget w = Array_at(&widgets, i);
-		fwrite(&w, 1, sizeof(Widget), f); //FIXME: this is dangerous fix later
+	merge.first = Array_size(&widgets);
+	if(merge.total > 0 && (merge.first + merge.total > INT32_MAX || Array_reserve(&widgets, merge.first + merge.total) != VEE_OK)) {
+		TraceLog(LOG_WARNING, "Out of memory, %zu widgets weren't loaded", merge.total);
+		merge.total = 0;
+	}
+	if(merge.total == 0) {
+		ImportRelease(&merge.batch);
+		return false;
+	}
+	return true;
+}
+
+//Add up to `n` widgets of the batch on top of the ones added before it, with new ids. The strings
+//of a file go to the editor's table once each, the workers left them there without duplicates.
+//Returns false when memory ran out, the widgets added so far are kept.
+static bool MergeStep(size_t n) {
+	size_t start = Array_size(&widgets);
+	Widget* out = &Array_at(&widgets, start);
+	for(size_t k=0; k<n && merge.file < Array_size(&merge.batch); ++merge.file, merge.next = 0) {
+		ImportFile* f = Array_at(&merge.batch, merge.file);
+		if(f->result <= 0) continue;
+		//a file whose strings can't be kept shows the defaults
+		if(merge.next == 0 && StringTableLoad(&widgetStrings, StringTableData(&f->strings), StringTableSize(&f->strings), &merge.strings) < 0) 
+			merge.strings.size = 0;
+		const Widget* in = Array_data(&f->widgets);
+		for(; k<n && merge.next<(size_t)f->result; ++k, ++merge.next, ++out) {
+			*out = in[merge.next];
+			out->bounds.x += f->offset.x;
+			out->bounds.y += f->offset.y;
+			out->id = nextWidgetId++;
+			WidgetProps* p = &out->props;
+			if((p->set & PROP_TEXT) && !StringRemapFind(&merge.strings, p->text, &p->text)) p->set &= ~PROP_TEXT;
+			if((p->set & PROP_ITEMS) && !StringRemapFind(&merge.strings, p->items, &p->items)) p->set &= ~PROP_ITEMS;
+		}
+		if(merge.next < (size_t)f->result) break;
 	}
-	fclose(f);
 	
-	//WRITE THE C SOURCE FILE
-	const char* cfile = TextFormat("%s.c", file);
-	remove(cfile);
-	f = fopen(cfile, "wb");
-	if(f == NULL) {
-		TraceLog(LOG_WARNING, TextFormat("Failed to save UI to file `%s`", cfile));
-		return;
+	//every file in its own draw order, the ones dropped later above, all of them below the existing widgets
+	size_t end = out - Array_data(&widgets);
+	int below = (merge.added == 0) ? DEPTH_NONE : (int)(start - 1);
+	if(DepthOrderAppend(&order, end - start, NULL, below) != VEE_OK) return false;
+	widgets.size = end;
+	bool reload = false;
+	for(size_t i=start; i<end; ++i) {
+		Rectangle r = Array_at(&widgets, i).bounds;
+		RedrawRegion(r);
+		SpatialIndexInsert(&spatial, i, r);
+		if(!reload) reload = BoundsSwapInsert(&bounds, i, r) != VEE_OK;
 	}
-	const char* header = "#include <raylib.h>\n"\
-	"#define RAYGUI_IMPLEMENTATION\n"\
-	"#include <raygui.h>\n\n"\
-	"void DrawGUI() {\n";
-	fwrite(header, 1, strlen(header), f);
-	for(ArrayIt i = 0; i<Array_size(&widgets); ++i){
-		Widget w = Array_at(&widgets, i);
-		char text[1024] = {0};
-		switch(w.type) {
-			case WIDGET_WindowBox:
-			case WIDGET_GroupBox:
-			case WIDGET_Button:
-			case WIDGET_LabelButton:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, \"%s%i\");\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_Dummy:
-				sprintf(text, "    Gui%sRec((Rectangle){%i,%i,%i,%i}, \"%s%i\");\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_Line:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, 1);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_Panel:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i});\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_ScrollPanel:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, (Rectangle){0,0,0,0}, (Vector2){0,0});\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_Label:
-				sprintf(text, "    Gui%sEx((Rectangle){%i,%i,%i,%i}, \"%s%i\", 0, 4);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_ImageButton:
-				sprintf(text, "    Gui%sEx((Rectangle){%i,%i,%i,%i}, (Texture){0}, (Rectangle){0,0,20,20}, \"%s%i\");\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height, 
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_Toggle:
-			case WIDGET_CheckBox:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, \"%s%i\", true);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_ToggleGroup:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, \"%s%i\", true, 4, 1);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_ComboBox:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, \"%s%i\", 0);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_DropdownBox:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, \"%s%i\", &(int){0}, false);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_Spinner:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i},&(int){0}, 0, 100, 20, true);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_ValueBox:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i},&(int){0}, 0, 100, true);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_TextBox:
-			case WIDGET_TextBoxMulti:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, (char*)&(char[32]){\"%s%i\"}, 32, true);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_Slider:
-			case WIDGET_SliderBar:
-				sprintf(text, "    Gui%sEx((Rectangle){%i,%i,%i,%i}, \"%s%i\", 0.f, 0.f, 100.f, true);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_ProgressBar:
-				sprintf(text, "    Gui%sEx((Rectangle){%i,%i,%i,%i}, 0.f, 0.f, 100.f, true);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_StatusBar:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, \"%s%i\", 4);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			
-			case WIDGET_ListView:
-				sprintf(text, "    Gui%sEx((Rectangle){%i,%i,%i,%i}, (const char**)&(char*[]){\"ItemA\", \"ItemB\"}, NULL,"\
-					"2, &(int){0}, &(int){0}, NULL, true);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_ColorPicker:
-			case WIDGET_ColorPanel:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, DARKBLUE);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_MessageBox:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, \"%s%i\", \"MESSAGE HERE\");\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height,
-					WidgetName[w.type], (int)i);
-			break;
-			
-			case WIDGET_ColorBarAlpha:
-			case WIDGET_ColorBarHue:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, 0.5f);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			case WIDGET_Grid:
-				sprintf(text, "    Gui%s((Rectangle){%i,%i,%i,%i}, 10, 1);\n",
-					WidgetName[w.type], (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height);
-			break;
-			
-			default:
-			break;
+	if(reload) BoundsLoad(&bounds, &widgets);
+	merge.added += end - start;
+	return true;
+}
+
+//Once the alignment index has the whole batch and the journal a copy of it, the widgets can change again
+static void EndMerge() {
+	JournalSnapshotTaken(true);
+	if(merge.aligning) AlignAppendEnd(&merge.alignment, &alignment);
+	merge.aligning = false;
+	lintDirty = true;
+	ImportRelease(&merge.batch);
+	Array_destroy(&merge.strings);
+}
+
+//A batch can only start outside of a mouse action: a drag or resize standing still is a held
+//button without any input, and the batch would join its undo group.
+static inline bool MergeAllowed() {
+	return mode == MODE_NORMAL && !InputMouseButtonDown(MOUSE_LEFT_BUTTON) && 
+		!InputMouseButtonDown(MOUSE_RIGHT_BUTTON) && !InputMouseButtonDown(MOUSE_MIDDLE_BUTTON);
+}
+
+//Add the files of an import batch that was read completely, IMPORT_MERGE_STEP widgets per frame
+//(all of them when `finish` is set). Nothing else changes the widgets until it's done: the
+//editor finishes the batch first when there's input. The batch is undone and journaled as one.
+static void MergeImports(bool finish) {
+	if(Array_size(&merge.batch) == 0 && !BeginMerge()) return;
+	PROFILE_ZONE("MergeImports");
+	
+	if(merge.added < merge.total) {
+		bool ok = true;
+		do ok = MergeStep(finish ? merge.total - merge.added : IMPORT_MERGE_STEP);
+		while(ok && finish && merge.added < merge.total);
+		if(ok && merge.added < merge.total) {
+			hierarchyDirty = true;
+			return;
 		}
+		if(!ok) TraceLog(LOG_WARNING, "Out of memory, %zu widgets weren't loaded", merge.total - merge.added);
 		
-		if(text[0] != '\0') fwrite(text, 1, strlen(text), f);
-	}
-	const char* footer = "}\n"\
-	"int main(int argc, char **argv) {\n"\
-	"    InitWindow(800, 450, \"GUI Test\");\n"\
-	"    SetTargetFPS(60);\n\n"\
-	"    while(!WindowShouldClose())\n"\
-	"    {\n"\
-	"        BeginDrawing();\n"\
-	"        DrawGUI();\n"\
-	"        EndDrawing();\n"\
-	"    }\n"\
-	"    CloseWindow();\n"\
-	"    return 0;\n"\
-	"}\n\n";
-	
-	fwrite(footer,1,strlen(footer),f);
-	fclose(f);
-	TraceLog(LOG_INFO,TextFormat("UI saved to `%s` and `%s.c`", file, file));
+		if(merge.added > 0) {
+			hierarchyDirty = true;
+			HistoryRecordRange(&history, merge.first, merge.added, DEPTH_NONE);
+			JournalSnapshotShared(&widgets, &order, &widgetStrings);
+			if(merge.files == 1) TraceLog(LOG_INFO,TextFormat("Loaded %i widgets from `%s`", (int)merge.added, Array_at(&merge.batch, 0)->path));
+			else TraceLog(LOG_INFO,TextFormat("Loaded %i widgets from %i files", (int)merge.added, merge.files));
+			AlignAppendBegin(&merge.alignment, &alignment, &widgets, merge.first);
+			merge.aligning = true;
+		}
+	}
+	if(finish || ((!merge.aligning || AlignAppendDone(&merge.alignment)) && JournalSnapshotTaken(false))) EndMerge();
 }
 
 void LoadUI() {
+	PROFILE_ZONE("LoadUI");
 	int count = 0;
-	char** files = GetDroppedFiles(&count);
+	char** files = InputDroppedFiles(&count);
 	if(count == 0) return;
 	
-	FILE* f = fopen(files[0], "rb");
-	ClearDroppedFiles();
-	if(f == NULL) {
-		TraceLog(LOG_WARNING,TextFormat("Failed to load UI from file `%s`", files[0]));
-		return;
+	//a style is applied to the preview and reloaded whenever it's saved again
+	int layouts = 0;
+	char** layoutFiles = arena_alloc(&frameArena, count*sizeof(char*));
+	for(int i=0; i<count; ++i) {
+		if(!IsFileExtension(files[i], ".rgs")) {
+			if(layoutFiles != NULL) layoutFiles[layouts++] = files[i];
+			continue;
+		}
+		int r = headless ? VEE_OK : StyleWatch(files[i]);
+		RedrawAll();
+		if(r != VEE_OK) TraceLog(LOG_WARNING, TextFormat("Failed to load style from file `%s`", files[i]));
+		else if(!headless) TraceLog(LOG_INFO, TextFormat("Loaded style from `%s`", files[i]));
 	}
 	
-	char magic[4] = {0};
-	fread(&magic,1,3,f);
-	if(strncmp((const char*)&magic, "UIF\0", sizeof(magic)) == 0) {
-		fread(&count,1,sizeof(int), f);
-		if(count < 1000) {
-			void* tmp = malloc(count*sizeof(Widget));
-			fread(tmp, sizeof(Widget), count, f);
-			Array_insert(&widgets, 0, tmp, count);
-			free(tmp);
-		}
+	//the layouts are read in the background and added by MergeImports() once they're all there
+	if(layoutFiles == NULL || (layouts > 0 && ImportFiles(layoutFiles, layouts) != VEE_OK)) 
+		TraceLog(LOG_WARNING, "Failed to load the dropped UI files");
+	//a replay has to see them in the frame they were dropped in (or the first one they can be added in)
+	if(headless) {
+		ImportWait();
+		if(MergeAllowed()) MergeImports(true);
 	}
-	fclose(f);
+	InputClearDroppedFiles();
+}
+
+//Bring everything that mirrors the widget array up to date after an undo/redo applied `c`.
+//The widgets it touched are added to the selection.
+static void ApplyHistoryChange(HistoryEntry c) {
+	switch(c.op) {
+		case HISTORY_INSERT: {
+			//the widget that was at the index moved to the end
+			int last = Array_size(&widgets)-1;
+			if((int)c.index != last) {
+				SpatialIndexRename(&spatial, c.index, last, Array_at(&widgets, last).bounds);
+				AlignIndexRename(&alignment, c.index, last, Array_at(&widgets, last).bounds);
+				if(SelectionHas(&selection, c.index)) SelectionAdd(&selection, last);
+				SelectionRemove(&selection, c.index);
+				if(selectedWidget == (int)c.index) selectedWidget = last;
+			}
+			SpatialIndexInsert(&spatial, c.index, c.widget.bounds);
+			AlignIndexInsert(&alignment, c.index, c.widget.bounds);
+			if(BoundsSwapInsert(&bounds, c.index, c.widget.bounds) != VEE_OK) BoundsLoad(&bounds, &widgets);
+			Journal((JournalOp){ JOURNAL_INSERT, c.index, c.below, c.widget });
+			if(SelectionAdd(&selection, c.index) == VEE_OK) selectedWidget = c.index;
+		} break;
+		case HISTORY_REMOVE: {
+			//the last widget took the index
+			int last = Array_size(&widgets);
+			SpatialIndexRemove(&spatial, c.index, c.widget.bounds);
+			AlignIndexRemove(&alignment, c.index, c.widget.bounds);
+			if((int)c.index != last) {
+				SpatialIndexRename(&spatial, last, c.index, Array_at(&widgets, c.index).bounds);
+				AlignIndexRename(&alignment, last, c.index, Array_at(&widgets, c.index).bounds);
+			}
+			BoundsSwapRemove(&bounds, c.index);
+			SelectionSwapRemove(&selection, c.index, last);
+			if(selectedWidget == (int)c.index) selectedWidget = -1;
+			else if(selectedWidget == last) selectedWidget = c.index;
+			Journal((JournalOp){ JOURNAL_REMOVE, c.index });
+		} break;
+		case HISTORY_SET:
+			SpatialIndexUpdate(&spatial, c.index, c.before.bounds, c.widget.bounds);
+			AlignIndexUpdate(&alignment, c.index, c.before.bounds, c.widget.bounds);
+			BoundsSet(&bounds, c.index, c.widget.bounds);
+			Journal((JournalOp){ JOURNAL_SET, c.index, 0, c.widget });
+			if(SelectionAdd(&selection, c.index) == VEE_OK) selectedWidget = c.index;
+		break;
+		case HISTORY_MOVE:
+			Journal((JournalOp){ JOURNAL_MOVE, c.index, c.below });
+			if(SelectionAdd(&selection, c.index) == VEE_OK) selectedWidget = c.index;
+		break;
+		case HISTORY_TRANSLATE:
+			ApplyTranslate(&c);
+			for(size_t k=0; k<c.count; ++k)
+				if(SelectionAdd(&selection, c.moves[k].index) == VEE_OK) selectedWidget = c.moves[k].index;
+		break;
+		case HISTORY_INSERT_RANGE:
+		case HISTORY_REMOVE_RANGE:
+			SpatialIndexRebuild(&spatial, &widgets);
+			AlignIndexRebuild(&alignment, &widgets);
+			BoundsLoad(&bounds, &widgets);
+			//the whole array is written by the snapshot taken at the end of the batch
+			journalBatchFull = true;
+			hierarchyDirty = true;
+			lintDirty = true;
+			SelectOnly(-1);
+		break;
+	}
+}
+
+//Undo (or redo) the last group of edits
+static void StepHistory(bool undo) {
+	HistoryEntry c;
+	SelectOnly(-1);
+	BeginJournalBatch();
+	while(undo ? HistoryUndo(&history, &widgets, &order, &c) : HistoryRedo(&history, &widgets, &order, &c)) {
+		ApplyHistoryChange(c);
+		if(undo ? !c.joined : !HistoryRedoJoined(&history)) break;
+	}
+	EndJournalBatch();
+	//where the widgets were before isn't kept around
+	RedrawAll();
+	mode = MODE_NORMAL;
+	if(selectedWidget != -1) RecalculateResizePoints();
+}
+
+static inline void Undo() { StepHistory(true); }
+static inline void Redo() { StepHistory(false); }
+
+//Nudge the drag `offset` so the closest line (edge or center) of the dragged widgets meets the
+//closest line of another widget within ALIGN_TOLERANCE screen pixels. The dragged widgets are
+//still indexed where the drag started, they are skipped.
+static Vector2 AlignDrag(Vector2 offset) {
+	alignGuides[ALIGN_AXIS_X].widget = alignGuides[ALIGN_AXIS_Y].widget = -1;
+	if(!align) return offset;
+	Rectangle r = { dragExtent.x + offset.x, dragExtent.y + offset.y, dragExtent.width, dragExtent.height };
+	AlignRect(&alignment, r, (1u << ALIGN_LINE_COUNT)-1, ALIGN_TOLERANCE/camera.zoom, &subtrees, alignGuides);
+	offset.x += alignGuides[ALIGN_AXIS_X].delta;
+	offset.y += alignGuides[ALIGN_AXIS_Y].delta;
+	alignSubject = (Rectangle){ dragExtent.x + offset.x, dragExtent.y + offset.y, dragExtent.width, dragExtent.height };
+	return offset;
+}
+
+//Line up the edges of `r` that the resizer point `p` moves with the closest line of a widget
+//outside the selection
+static void AlignResize(ResizerPoint p, Rectangle* r) {
+	bool west = p == RESIZER_POINT_W || p == RESIZER_POINT_NW || p == RESIZER_POINT_SW;
+	bool east = p == RESIZER_POINT_E || p == RESIZER_POINT_NE || p == RESIZER_POINT_SE;
+	bool north = p == RESIZER_POINT_N || p == RESIZER_POINT_NE || p == RESIZER_POINT_NW;
+	bool south = p == RESIZER_POINT_S || p == RESIZER_POINT_SE || p == RESIZER_POINT_SW;
+	float tolerance = ALIGN_TOLERANCE/camera.zoom;
+	AlignMatch* x = &alignGuides[ALIGN_AXIS_X];
+	AlignMatch* y = &alignGuides[ALIGN_AXIS_Y];
+	x->widget = y->widget = -1;
+	if(west || east) *x = AlignNearest(&alignment, ALIGN_AXIS_X, west ? r->x : r->x + r->width, tolerance, &selection);
+	if(north || south) *y = AlignNearest(&alignment, ALIGN_AXIS_Y, north ? r->y : r->y + r->height, tolerance, &selection);
+	if(west) { r->x += x->delta; r->width -= x->delta; }
+	else if(east) r->width += x->delta;
+	if(north) { r->y += y->delta; r->height -= y->delta; }
+	else if(south) r->height += y->delta;
+	alignSubject = *r;
 }
 
 static inline void ResizeWidget() {
 	if(resizerPointActive != -1) //should not happen but still check to be safe
 	{
-		Vector2 mouse = GetMousePosition();
+		Vector2 mouse = WorldMouse();
 		if(snap) { //snap to grid if enabled
 			mouse.x = ((int)(mouse.x/snapDistance))*snapDistance;
 			mouse.y = ((int)(mouse.y/snapDistance))*snapDistance;
@@ -458,7 +1107,8 @@ static inline void ResizeWidget() {
 		}
 		
 		ResizerPoint p = resizerPointActive;
-		Rectangle* r = &(Array_at(&widgets, selectedWidget).bounds);
+		Rectangle b = Array_at(&widgets, selectedWidget).bounds;
+		Rectangle* r = &b;
 		switch(p) {
 			case RESIZER_POINT_N:
 				r->height = r->height + r->y - mouse.y;
@@ -497,44 +1147,454 @@ static inline void ResizeWidget() {
 			
 			default: break;
 		}
+		if(align) AlignResize(p, r);
 		
+		SetWidgetBounds(selectedWidget, b);
 		lastMousePosition = mouse;
 	}
 	
 }
 
-void UpdateEditor() {
-	Vector2 mouse = GetMousePosition();
-	if(IsMouseButtonPressed(MOUSE_RIGHT_BUTTON)) {
+//Finish whatever the left mouse button was doing
+static void EndMouseAction() {
+	alignGuides[ALIGN_AXIS_X].widget = alignGuides[ALIGN_AXIS_Y].widget = -1;
+	if(mode == MODE_MOVE_WIDGET) EndDrag();
+	else if(mode == MODE_SELECT_BOX) {
+		SelectionAddRect(&selection, &bounds, selectBox);
+		if(selectedWidget == -1) selectedWidget = SelectionNext(&selection, 0);
+		if(selectedWidget != -1) RecalculateResizePoints();
+	}
+	HistoryEndGroup(&history);
+	mode = MODE_NORMAL;
+}
+
+static inline void BeginSelectBox(Vector2 mouse) {
+	selectBox = (Rectangle){mouse.x, mouse.y, 0, 0};
+	mode = MODE_SELECT_BOX;
+}
+
+// -------
+// PROPERTIES
+// -------
+
+//The panel with the properties of the selected widget, toggled with E. It's in screen
+//coordinates in the bottom right corner. Like the menu the raygui controls are drawn by
+//DrawProperties() and what they changed is applied by UpdateProperties(), which is all a
+//replay runs.
+#define PROPERTIES_WIDTH 230
+#define PROPERTIES_ROW 24
+#define PROPERTIES_PICKER 100
+#define PROPERTIES_LABEL 50
+#define PROPERTIES_TEXT_SIZE 128
+
+typedef enum {
+	PROPERTY_EDIT_NONE = 0,
+	PROPERTY_EDIT_TEXT,
+	PROPERTY_EDIT_ITEMS,
+	PROPERTY_EDIT_MIN,
+	PROPERTY_EDIT_MAX,
+	PROPERTY_EDIT_VALUE,
+} PropertyEdit;
+
+struct {
+	bool shown;
+	int edit;   //PropertyEdit of the control being typed into, the editor's keys are off meanwhile
+	int commit; //PROPERTY_EDIT_TEXT or _ITEMS when that text was entered this frame
+	char text[PROPERTIES_TEXT_SIZE], items[PROPERTIES_TEXT_SIZE];
+	//the values of the controls this frame
+	int min, max;
+	float value;
+	Color color;
+} properties = {0};
+
+static inline bool PropertiesVisible() {
+	return properties.shown && selection.count == 1 && selectedWidget != -1 && mode != MODE_SHOW_MENU;
+}
+
+static inline bool TypingProperty() {
+	return properties.edit != PROPERTY_EDIT_NONE;
+}
+
+static Rectangle PropertiesBounds() {
+	uint16_t p = WidgetDescs[Array_at(&widgets, selectedWidget).type].props;
+	int rows = 1 + ((p & PROP_TEXT) != 0) + ((p & PROP_ITEMS) != 0) + 2*((p & PROP_RANGE) != 0) + ((p & PROP_VALUE) != 0);
+	float height = 8 + rows*PROPERTIES_ROW + ((p & PROP_COLOR) ? PROPERTIES_PICKER + 4 : 0);
+	return (Rectangle){ screenWidth - PROPERTIES_WIDTH - 8, screenHeight - height - 16, PROPERTIES_WIDTH, height };
+}
+
+static inline int ClampInt(float v) {
+	return (v >= (float)INT32_MAX) ? INT32_MAX : (v <= (float)INT32_MIN) ? INT32_MIN : (int)v;
+}
+
+//the controls start from the values of the selected widget
+static WidgetValues BeginProperties() {
+	Widget w = Array_at(&widgets, selectedWidget);
+	WidgetValues v = WidgetValuesOf(w, &widgetStrings, GetWidgetLabel(selectedWidget));
+	properties.min = ClampInt(v.min);
+	properties.max = ClampInt(v.max);
+	properties.value = v.value;
+	properties.color = v.color;
+	return v;
+}
+
+//Give the selected widget the text entered in the text box `properties.commit`.
+static void CommitPropertyText() {
+	bool items = properties.commit == PROPERTY_EDIT_ITEMS;
+	char* text = items ? properties.items : properties.text;
+	properties.commit = PROPERTY_EDIT_NONE;
+	InputGuiText(text, PROPERTIES_TEXT_SIZE);
+	
+	WidgetValues v = BeginProperties();
+	if(strcmp(text, items ? v.items : v.text) == 0) return;
+	//a new string has to be in the journal before the edit that uses it
+	WidgetProps p = Array_at(&widgets, selectedWidget).props;
+	size_t size = StringTableSize(&widgetStrings);
+	if(StringIntern(&widgetStrings, text, items ? &p.items : &p.text) != VEE_OK) return;
+	if(StringTableSize(&widgetStrings) != size) JournalString(text, items ? p.items : p.text);
+	p.set |= items ? PROP_ITEMS : PROP_TEXT;
+	HistoryBreak(&history);
+	SetWidgetProps(selectedWidget, p);
+}
+
+//Start typing into `edit` (or stop if it's already the one), the text box left is committed
+static void ToggleProperty(int edit) {
+	if(properties.edit == PROPERTY_EDIT_TEXT || properties.edit == PROPERTY_EDIT_ITEMS) properties.commit = properties.edit;
+	properties.edit = (properties.edit == edit) ? PROPERTY_EDIT_NONE : edit;
+}
+
+//Apply what the controls changed this frame (or what a replay says they changed)
+static void UpdateProperties() {
+	InputGuiValue(&properties.edit);
+	InputGuiValue(&properties.commit);
+	InputGuiValue(&properties.min);
+	InputGuiValue(&properties.max);
+	int value, color = properties.color.r | properties.color.g << 8 | properties.color.b << 16 | (uint32_t)properties.color.a << 24;
+	memcpy(&value, &properties.value, sizeof(value));
+	InputGuiValue(&value);
+	InputGuiValue(&color);
+	memcpy(&properties.value, &value, sizeof(value));
+	Color c = { color & 0xff, (color >> 8) & 0xff, (color >> 16) & 0xff, ((uint32_t)color >> 24) & 0xff };
+	if(properties.commit != PROPERTY_EDIT_NONE) CommitPropertyText();
+	
+	//only what was changed gets set, the rest keeps following the defaults
+	Widget w = Array_at(&widgets, selectedWidget);
+	uint16_t shown = WidgetDescs[w.type].props;
+	WidgetValues v = WidgetValuesOf(w, &widgetStrings, GetWidgetLabel(selectedWidget));
+	WidgetProps p = w.props;
+	if((shown & PROP_RANGE) && (properties.min != ClampInt(v.min) || properties.max != ClampInt(v.max))) {
+		p.min = (properties.min != ClampInt(v.min)) ? properties.min : v.min;
+		p.max = (properties.max != ClampInt(v.max)) ? properties.max : v.max;
+		p.set |= PROP_RANGE;
+	}
+	if((shown & PROP_VALUE) && properties.value != v.value && isfinite(properties.value)) {
+		p.value = properties.value;
+		p.set |= PROP_VALUE;
+	}
+	if((shown & PROP_COLOR) && (c.r != v.color.r || c.g != v.color.g || c.b != v.color.b || c.a != v.color.a)) {
+		p.color = c;
+		p.set |= PROP_COLOR;
+	}
+	SetWidgetProps(selectedWidget, p);
+}
+
+//a control of the panel with its name in front, `*y` goes to the next row
+static Rectangle PropertyRow(Rectangle b, float* y, const char* name, float height) {
+	GuiLabel((Rectangle){ b.x + 6, *y, PROPERTIES_LABEL, PROPERTIES_ROW - 4 }, name);
+	Rectangle r = { b.x + 6 + PROPERTIES_LABEL, *y, b.width - 12 - PROPERTIES_LABEL, height - 4 };
+	*y += height;
+	return r;
+}
+
+//a text box that isn't typed into shows the text of the widget
+static inline void FillPropertyText(char* text, const char* from, int edit) {
+	if(properties.edit == edit) return;
+	//raygui doesn't terminate what it adds
+	memset(text, 0, PROPERTIES_TEXT_SIZE);
+	strncpy(text, from, PROPERTIES_TEXT_SIZE-1);
+}
+
+static void DrawProperties() {
+	PROFILE_ZONE("DrawProperties");
+	Widget w = Array_at(&widgets, selectedWidget);
+	uint16_t shown = WidgetDescs[w.type].props;
+	WidgetValues v = BeginProperties();
+	Rectangle b = PropertiesBounds();
+	GuiPanel(b);
+	float y = b.y + 4;
+	GuiLabel(PropertyRow(b, &y, "Type", PROPERTIES_ROW), WidgetName[w.type]);
+	if(shown & PROP_TEXT) {
+		FillPropertyText(properties.text, v.text, PROPERTY_EDIT_TEXT);
+		if(GuiTextBox(PropertyRow(b, &y, "Text", PROPERTIES_ROW), properties.text, PROPERTIES_TEXT_SIZE, properties.edit == PROPERTY_EDIT_TEXT))
+			ToggleProperty(PROPERTY_EDIT_TEXT);
+	}
+	if(shown & PROP_ITEMS) {
+		FillPropertyText(properties.items, v.items, PROPERTY_EDIT_ITEMS);
+		if(GuiTextBox(PropertyRow(b, &y, "Items", PROPERTIES_ROW), properties.items, PROPERTIES_TEXT_SIZE, properties.edit == PROPERTY_EDIT_ITEMS))
+			ToggleProperty(PROPERTY_EDIT_ITEMS);
+	}
+	if(shown & PROP_RANGE) {
+		if(GuiValueBox(PropertyRow(b, &y, "Min", PROPERTIES_ROW), &properties.min, INT32_MIN, INT32_MAX, properties.edit == PROPERTY_EDIT_MIN))
+			ToggleProperty(PROPERTY_EDIT_MIN);
+		if(GuiValueBox(PropertyRow(b, &y, "Max", PROPERTIES_ROW), &properties.max, INT32_MIN, INT32_MAX, properties.edit == PROPERTY_EDIT_MAX))
+			ToggleProperty(PROPERTY_EDIT_MAX);
+	}
+	if(shown & PROP_VALUE) {
+		Rectangle r = PropertyRow(b, &y, "Value", PROPERTIES_ROW);
+		if(w.type == WIDGET_Toggle || w.type == WIDGET_CheckBox) {
+			r.width = r.height;
+			properties.value = GuiCheckBox(r, "", properties.value != 0);
+		}
+		else if(shown & (PROP_RANGE | PROP_ITEMS)) {
+			//a whole number: the entry of a list or the value of a spinner
+			int lo = ClampInt(v.min), hi = ClampInt(v.max), value = ClampInt(v.value);
+			if(shown & PROP_ITEMS) {
+				lo = hi = 0;
+				for(const char* s = strchr(v.items, ';'); s != NULL; s = strchr(s+1, ';')) ++hi;
+			}
+			if(GuiSpinner(r, &value, lo, hi, 20, properties.edit == PROPERTY_EDIT_VALUE)) ToggleProperty(PROPERTY_EDIT_VALUE);
+			if(value != ClampInt(v.value)) properties.value = value;
+		}
+		else properties.value = GuiSliderEx(r, "", properties.value, v.min, v.max, true);
+	}
+	if(shown & PROP_COLOR) properties.color = GuiColorPicker(PropertyRow(b, &y, "Color", PROPERTIES_PICKER), properties.color);
+	UpdateProperties();
+}
+
+
+// -------
+// LAYOUT LINT
+// -------
+
+static inline Rectangle CanvasBounds() {
+	return (Rectangle){ 0, 0, screenWidth, screenHeight };
+}
+
+static void UpdateLint() {
+	//the alignment index only has the widgets of an import batch once it's done
+	if(!lintDirty || Merging()) return;
+	if(LintLayout(&lint, &widgets, &alignment, CanvasBounds()) != VEE_OK)
+		TraceLog(LOG_WARNING, "Failed to check the layout");
+	lintDirty = false;
+}
+
+//Write what the lint finds to `<project>.lint.json`
+static void SaveLintReport() {
+	UpdateLint();
+	char file[1040];
+	snprintf(file, sizeof(file), "%s.lint.json", projectFile);
+	FILE* f = fopen(file, "w");
+	int r = (f != NULL) ? LintWrite(&lint, &widgets, CanvasBounds(), f) : VEE_IO_ERROR;
+	if(f != NULL && fclose(f) != 0) r = VEE_IO_ERROR;
+	if(r == VEE_OK) TraceLog(LOG_INFO, TextFormat("Lint report (%zu issues) written to `%s`", LintIssueCount(&lint), file));
+	else TraceLog(LOG_WARNING, TextFormat("Failed to write the lint report to `%s`", file));
+}
+
+//The overlaps filled, the widgets off the canvas or without a proper size outlined, the
+//ones out of view are skipped
+static void DrawLint() {
+	Vector2 from = ScreenToWorld((Vector2){ 0, 0 }), to = ScreenToWorld((Vector2){ screenWidth, screenHeight });
+	Rectangle view = { from.x, from.y, to.x - from.x, to.y - from.y };
+	for(ArrayIt k=0; k<Array_size(&lint.issues); ++k) {
+		LintIssue e = Array_at(&lint.issues, k);
+		//the report can be a few frames behind the widgets (see UpdateEditor())
+		if(e.a >= (int)Array_size(&widgets) || e.b >= (int)Array_size(&widgets)) continue;
+		Rectangle r = NormalizeRec(Array_at(&widgets, e.a).bounds);
+		if(e.kind == LINT_OVERLAP) r = LintOverlap(r, Array_at(&widgets, e.b).bounds);
+		if(r.x > view.x + view.width || r.y > view.y + view.height || r.x + r.width < view.x || r.y + r.height < view.y) continue;
+		r = WorldToScreenRec(r);
+		switch(e.kind) {
+			case LINT_OVERLAP:
+				DrawRectangleRec(r, Fade(lintColor[e.kind], 0.3f));
+				DrawRectangleLinesEx(r, 1, lintColor[e.kind]);
+			break;
+			case LINT_EMPTY:
+			case LINT_NEGATIVE:
+				//an empty widget would have no outline at all
+				DrawRectangleLinesEx((Rectangle){ r.x - 2, r.y - 2, r.width + 4, r.height + 4 }, 1, lintColor[e.kind]);
+			break;
+			default:
+				DrawRectangleLinesEx(r, 1, lintColor[e.kind]);
+			break;
+		}
+	}
+	DrawText(TextFormat("LINT: %zu overlap | %zu clipped | %zu outside | %zu empty | %zu negative%s | SHIFT+L: report", 
+		lint.counts[LINT_OVERLAP], lint.counts[LINT_CLIPPED], lint.counts[LINT_OUTSIDE], lint.counts[LINT_EMPTY], 
+		lint.counts[LINT_NEGATIVE], lint.truncated ? " (not all shown)" : ""), 4, 16, 10, MAROON);
+}
+
+//The keyboard shortcuts
+static void UpdateKeys(bool shift) {
+	//they work on the whole selection, which can't change while it's being dragged
+	if(selectedWidget != -1 && mode != MODE_MOVE_WIDGET){
+		bool up = InputKeyPressed(KEY_KP_ADD) || InputKeyPressed(KEY_UP);
+		bool down = InputKeyPressed(KEY_KP_SUBTRACT) || InputKeyPressed(KEY_DOWN);
+		bool top = InputKeyPressed(KEY_HOME) || InputKeyPressed(KEY_PAGE_UP);
+		bool bottom = InputKeyPressed(KEY_END) || InputKeyPressed(KEY_PAGE_DOWN);
+		bool remove = InputKeyPressed(KEY_DELETE) || InputKeyPressed(KEY_X);
+		bool duplicate = InputKeyPressed(KEY_D);
+		//a container takes everything inside it along
+		if((up || down || top || bottom || remove || duplicate) && SelectSubtrees() == VEE_OK) {
+			HistoryBeginGroup(&history);
+			BeginJournalBatch();
+			if(up) BringToFront(&subtrees);
+			else if(down) SendToBack(&subtrees);
+			else if(top) MoveSelection(&subtrees, order.top);
+			else if(bottom) MoveSelection(&subtrees, DEPTH_NONE);
+			else if(remove) {
+				RemoveSelection(&subtrees);
+				mode = MODE_NORMAL;
+			}
+			else if(duplicate) {
+				DuplicateSelection(&subtrees);
+				if(selectedWidget != -1) RecalculateResizePoints();
+			}
+			EndJournalBatch();
+			HistoryEndGroup(&history);
+		}
+	}
+	
+	//profiler overlay and a trace of the last seconds
+	if(InputKeyPressed(KEY_F1)) ProfileToggleOverlay();
+	if(InputKeyPressed(KEY_F2)) ProfileDump("profile.json", PROFILE_DUMP_SECONDS);
+	
+	//grid spacing
+	if(InputKeyPressed(KEY_LEFT_BRACKET) && snapDistance > MIN_SNAP_DISTANCE) --snapDistance;
+	if(InputKeyPressed(KEY_RIGHT_BRACKET) && snapDistance < MAX_SNAP_DISTANCE) ++snapDistance;
+	
+	if(InputKeyPressed(KEY_E)) {
+		//show or hide the properties of the selected widget
+		properties.shown = !properties.shown;
+	}
+	
+	if(InputKeyPressed(KEY_A)) {
+		//toggle snapping to the edges and centers of the other widgets
+		align = !align;
+	}
+	
+	if(InputKeyPressed(KEY_L)) {
+		//show or hide what the layout lint found, write its report with shift
+		if(shift) SaveLintReport();
+		else lintShown = !lintShown;
+	}
+	
+	if(InputKeyPressed(KEY_SPACE)) {
+		//toggle snap
+		snap = !snap;
+	}
+	else if(InputKeyPressed(KEY_S)) {
+		//save UI to file
+		SaveUI();
+	}
+	else if(InputKeyPressed(KEY_T)) {
+		//switch how the C code is generated
+		codeStyle = (codeStyle+1) % CODE_STYLE_COUNT;
+	}
+	else if(InputKeyPressed(KEY_P)) {
+		//switch how the files dropped together are placed
+		importPlacement = (importPlacement+1) % IMPORT_PLACEMENT_COUNT;
+	}
+	else if(InputFileDropped()) {
+		//load UI from file
+		LoadUI();
+	}
+	else if(mode == MODE_NORMAL && InputKeyPressed(KEY_Z)) {
+		//undo (redo with shift)
+		if(shift) Redo();
+		else Undo();
+	}
+	else if(mode == MODE_NORMAL && InputKeyPressed(KEY_Y)) {
+		//redo
+		Redo();
+	}
+}
+
+bool UpdateEditor() {
+	PROFILE_ZONE("UpdateEditor");
+	arena_reset(&frameArena);
+	if(!headless && StyleUpdate()) RedrawAll();
+	//the input only ever edits a layout with the whole batch in it. A new batch starts in a frame without
+	//any input (see MergeAllowed()), until then it stays queued.
+	bool input = InputChanged();
+	if(Merging()) MergeImports(input);
+	else if(!input && MergeAllowed()) MergeImports(false);
+	Vector2 screen = InputMousePosition();
+	if(!PropertiesVisible()) properties.edit = PROPERTY_EDIT_NONE;
+	bool overProperties = PropertiesVisible() && CheckCollisionPointRec(screen, PropertiesBounds());
+	//clicking anywhere else enters the text being typed, before the click changes the selection
+	if(!overProperties && InputMouseButtonPressed(MOUSE_LEFT_BUTTON) && TypingProperty()) {
+		ToggleProperty(PROPERTY_EDIT_NONE);
+		if(properties.commit != PROPERTY_EDIT_NONE) CommitPropertyText();
+	}
+	UpdateView(screen);
+	Vector2 mouse = ScreenToWorld(screen);
+	bool shift = InputKeyDown(KEY_LEFT_SHIFT) || InputKeyDown(KEY_RIGHT_SHIFT);
+	bool ctrl = InputKeyDown(KEY_LEFT_CONTROL) || InputKeyDown(KEY_RIGHT_CONTROL);
+	bool alt = InputKeyDown(KEY_LEFT_ALT) || InputKeyDown(KEY_RIGHT_ALT);
+	if(InputMouseButtonPressed(MOUSE_RIGHT_BUTTON)) {
+			if(mode != MODE_SHOW_MENU) EndMouseAction();
 			mode = MODE_SHOW_MENU;
-			selectedWidget = -1;
+			SelectOnly(-1);
 			addWidget = -1;
-			menu = (Rectangle){mouse.x, mouse.y, 200, 320};
+			menu = (Rectangle){screen.x, screen.y, 200, 320};
 	}else{
-		if(mode != MODE_SHOW_MENU) {
-			if(IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-				if(selectedWidget == -1) 
-					selectedWidget = SelectWidget();
+		if(overProperties && mode == MODE_NORMAL) {
+			//the panel's controls take the mouse, every click on them is an edit of its own
+			if(InputMouseButtonPressed(MOUSE_LEFT_BUTTON)) HistoryBreak(&history);
+		}
+		else if(mode != MODE_SHOW_MENU) {
+			if(InputMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+				//everything until the button is released is undone at once
+				HistoryBeginGroup(&history);
+				int hit = SelectWidget();
+				if(alt) {
+					//alt+click adds every widget under the mouse, not just the one on top
+					if(!shift) SelectOnly(-1);
+					if(SelectionAddPoint(&selection, &bounds, mouse) == VEE_OK && selectedWidget == -1) 
+						selectedWidget = (hit != -1) ? hit : SelectionNext(&selection, 0);
+				}
+				else if(ctrl) {
+					//ctrl+click on another widget puts the selection right above it (below it with shift)
+					if(hit != -1 && SelectSubtrees() == VEE_OK && !SelectionHas(&subtrees, hit)) {
+						BeginJournalBatch();
+						MoveSelection(&subtrees, shift ? DepthBelow(&order, hit) : hit);
+						EndJournalBatch();
+					}
+				}
+				else if(shift) {
+					//shift+click adds or removes a widget, shift+drag adds a box of widgets
+					if(hit == -1) BeginSelectBox(mouse);
+					else if(SelectionHas(&selection, hit)) {
+						SelectionRemove(&selection, hit);
+						if(selectedWidget == hit) selectedWidget = SelectionNext(&selection, 0);
+					}
+					else if(SelectionAdd(&selection, hit) == VEE_OK) selectedWidget = hit;
+				}
+				else if(selectedWidget == -1) {
+					if(hit != -1) SelectOnly(hit);
+					else BeginSelectBox(mouse);
+				}
 				else {
-					resizerPointActive = CheckCollisionWithResizerPoints();
+					//the resize points are only there for a single widget
+					resizerPointActive = (selection.count == 1) ? CheckCollisionWithResizerPoints() : -1;
 					if( resizerPointActive != -1) {
 						mode = MODE_RESIZE_WIDGET;
 					}
-					else if(mode != MODE_RESIZE_WIDGET) {
-						selectedWidget = SelectWidget();
-						if(selectedWidget == -1) mode = MODE_NORMAL;
-						else {
+					else if(hit == -1) {
+						SelectOnly(-1);
+						BeginSelectBox(mouse);
+					}
+					else {
+						//clicking a widget outside of the selection selects only that one
+						if(!SelectionHas(&selection, hit)) SelectOnly(hit);
+						selectedWidget = hit;
+						//the containers are dragged with everything inside them
+						if(SelectSubtrees() == VEE_OK) {
 							if(snap) {
-								//realign widget to snap grid 
-								//happens when we added/moved a widget when snap was off
-								Rectangle* r = &(Array_at(&widgets, selectedWidget).bounds);
-								r->x = ((int)(r->x/snapDistance))*snapDistance;
-								r->y = ((int)(r->y/snapDistance))*snapDistance;
-								r->width = ((int)(r->width/snapDistance))*snapDistance;
-								r->height = ((int)(r->height/snapDistance))*snapDistance;
+								BeginJournalBatch();
+								SnapSelection(&subtrees);
+								EndJournalBatch();
 							}
-							mode = MODE_MOVE_WIDGET; 
-							lastMousePosition = mouse;
+							BeginDrag(mouse);
 						}
 					}
 				}
@@ -542,83 +1602,124 @@ void UpdateEditor() {
 				if(selectedWidget != -1) RecalculateResizePoints();
 			}
 			
-			if(IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+			if(InputMouseButtonDown(MOUSE_LEFT_BUTTON)) {
 				if(mode == MODE_MOVE_WIDGET) {
-					if(selectedWidget != -1) {
-						Rectangle* r = &(Array_at(&widgets, selectedWidget).bounds);
-						if(snap) {
-							mouse.x = ((int)(mouse.x/snapDistance))*snapDistance;
-							mouse.y = ((int)(mouse.y/snapDistance))*snapDistance;
-							lastMousePosition.x = ((int)(lastMousePosition.x/snapDistance))*snapDistance;
-							lastMousePosition.y = ((int)(lastMousePosition.y/snapDistance))*snapDistance;
-						}
-						r->x += mouse.x - lastMousePosition.x;
-						r->y += mouse.y - lastMousePosition.y;
-						RecalculateResizePoints();
-						lastMousePosition = mouse;
+					Vector2 start = dragStart;
+					if(snap) {
+						mouse.x = ((int)(mouse.x/snapDistance))*snapDistance;
+						mouse.y = ((int)(mouse.y/snapDistance))*snapDistance;
+						start.x = ((int)(start.x/snapDistance))*snapDistance;
+						start.y = ((int)(start.y/snapDistance))*snapDistance;
 					}
+					//the whole selection moves in one pass, the spatial index catches up in EndDrag()
+					Vector2 offset = AlignDrag((Vector2){ mouse.x - start.x, mouse.y - start.y });
+					if(offset.x != dragOffset.x || offset.y != dragOffset.y) {
+						RedrawRegion((Rectangle){ dragExtent.x + dragOffset.x, dragExtent.y + dragOffset.y, dragExtent.width, dragExtent.height });
+						RedrawRegion((Rectangle){ dragExtent.x + offset.x, dragExtent.y + offset.y, dragExtent.width, dragExtent.height });
+					}
+					dragOffset = offset;
+					BoundsTranslate(&bounds, &dragFrom, Array_data(&subtrees.words), Array_size(&subtrees.words), dragOffset);
+					TranslateWidgets(&widgets, Array_data(&dragMoves), Array_size(&dragMoves), dragOffset);
+					if(selectedWidget != -1) RecalculateResizePoints();
 				} else if(mode == MODE_RESIZE_WIDGET) {
 					if(selectedWidget != -1) {
 						ResizeWidget();
 						RecalculateResizePoints();
 					}
+				} else if(mode == MODE_SELECT_BOX) {
+					selectBox.width = mouse.x - selectBox.x;
+					selectBox.height = mouse.y - selectBox.y;
 				}
-			} else if(IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) mode = MODE_NORMAL;
+			} else if(InputMouseButtonReleased(MOUSE_LEFT_BUTTON)) EndMouseAction();
 		}
 	}
 	
-	//KEYS
-	if(selectedWidget != -1){
-		if(IsKeyPressed(KEY_KP_ADD) || IsKeyPressed(KEY_UP)) BringToFront();
-		else if(IsKeyPressed(KEY_KP_SUBTRACT) || IsKeyPressed(KEY_DOWN)) SendToBack();
-		else if(IsKeyPressed(KEY_DELETE)||IsKeyPressed(KEY_X)) {
-			Array_remove(&widgets, selectedWidget, 1);
-			selectedWidget = -1;
-			mode = MODE_NORMAL;
-		}
-		else if(IsKeyPressed(KEY_D)) {
-			//duplicate widget
-			Widget w = Array_at(&widgets, selectedWidget);
-			Array_push(&widgets, w);
-		}
-	}
+	//none of the keys while a property is typed in
+	if(!TypingProperty()) UpdateKeys(shift);
 	
-	if(IsKeyPressed(KEY_SPACE)) {
-		//toggle snap
-		snap = !snap;
-	}
-	else if(IsKeyPressed(KEY_S)) {
-		//save UI to file
-		SaveUI();
-	}
-	else if(IsFileDropped()) {
-		//load UI from file
-		LoadUI();
-	}
+	//not in the middle of a drag or resize, the alignment index the sweep goes by is behind then
+	if(lintShown && mode == MODE_NORMAL) UpdateLint();
+	
+	//keep the journal short, a snapshot taken in the middle of a drag would be outdated right away
+	if(mode == MODE_NORMAL && JournalShouldCompact()) JournalSnapshot(&widgets, &order, &widgetStrings);
 	
+	//the grid depends on these too
+	if(camera.zoom != canvasCamera.zoom || camera.offset.x != canvasCamera.offset.x || camera.offset.y != canvasCamera.offset.y ||
+		snap != canvasSnap || snapDistance != canvasSnapDistance) RedrawAll();
+	//the editor's own UI only changes with the input, the menu and the properties also with the mouse over them
+	return redrawCanvas || redrawRegion || InputChanged() || ((mode == MODE_SHOW_MENU || PropertiesVisible()) && InputMouseMoved()) || 
+		TypingProperty() || ImportBusy(NULL) || Merging() || ProfileOverlayVisible();
 }
 
 void InitializeEditor() {
+	arena_create(&frameArena, 64*1024);
 	Array_create(&widgets, 2); //initialize the widget array
+	StringTableCreate(&widgetStrings, NULL);
+	DepthOrderCreate(&order);
+	SelectionCreate(&selection);
+	SelectionCreate(&subtrees);
+	HierarchyCreate(&hierarchy);
+	hierarchyDirty = true;
+	SpatialIndexCreate(&spatial, snapDistance*16);
+	AlignIndexCreate(&alignment, NULL);
+	LintCreate(&lint, NULL);
+	BoundsCreate(&bounds, NULL);
+	BoundsCreate(&dragFrom, NULL);
+	HistoryCreate(&history, HISTORY_DEFAULT_BUDGET);
+	
+	//restore the last session (including edits that were never saved)
+	if(JournalOpen(projectFile, &widgets, &order, &widgetStrings) > 0) {
+		SpatialIndexRebuild(&spatial, &widgets);
+		AlignIndexRebuild(&alignment, &widgets);
+	}
+	BoundsLoad(&bounds, &widgets);
+	for(ArrayIt i=0; i<Array_size(&widgets); ++i)
+		if(Array_at(&widgets, i).id >= nextWidgetId) nextWidgetId = Array_at(&widgets, i).id + 1;
 	
 	//generate the dummy texture required by some widgets (image button)
+	if(headless) return;
 	Image tmp = GenImageChecked(100,100,5,5, RAYWHITE, GRAY);
 	texture = LoadTextureFromImage(tmp);
 	UnloadImage(tmp);
 }
 
 void FinalizeEditor() {
+	if(Merging()) MergeImports(true);
+	JournalClose();
+	StyleClose();
+	ImportClose();
 	Array_destroy(&widgets);
-	UnloadTexture(texture);
+	StringTableDestroy(&widgetStrings);
+	SpatialIndexDestroy(&spatial);
+	AlignIndexDestroy(&alignment);
+	LintDestroy(&lint);
+	BoundsDestroy(&bounds);
+	BoundsDestroy(&dragFrom);
+	HistoryDestroy(&history);
+	Array_destroy(&labels);
+	Array_destroy(&drawList);
+	DepthOrderDestroy(&order);
+	SelectionDestroy(&selection);
+	SelectionDestroy(&subtrees);
+	HierarchyDestroy(&hierarchy);
+	Array_destroy(&dragMoves);
+	Array_destroy(&journalBatch);
+	TextCacheDestroy();
+	arena_destroy(&frameArena);
+	if(!headless) UnloadTexture(texture);
+	if(gridLayer.id != 0) UnloadRenderTexture(gridLayer);
+	if(canvasLayer.id != 0) UnloadRenderTexture(canvasLayer);
 }
 
 
 void AddWidget() 
 {
-	int x = menu.x, y = menu.y;
+	//the widget goes where the menu was opened
+	Vector2 at = ScreenToWorld((Vector2){menu.x, menu.y});
+	int x = at.x, y = at.y;
 	if(snap) {
-		x = ((int)(menu.x/snapDistance))*snapDistance;
-		y = ((int)(menu.y/snapDistance))*snapDistance;
+		x = ((int)(at.x/snapDistance))*snapDistance;
+		y = ((int)(at.y/snapDistance))*snapDistance;
 	}
 	Widget w={0};
 	w.type = addWidget;
@@ -683,16 +1784,18 @@ void AddWidget()
 		default:
 			return;
 	}
-	Array_append(&widgets, w);
+	int i = AddWidgetOnTop(w);
+	if(i == -1) return;
 	addWidget = -1;
-	selectedWidget = Array_size(&widgets)-1;
+	selectedWidget = i;
 	RecalculateResizePoints();
 }
 
-void DrawMenu() {
-	GuiListView(menu, (const char**)WidgetName, WIDGET_COUNT, &scrollIndex, &addWidget, true); 
+//the part of the menu that doesn't draw anything, `addWidget` is set by the list view
+static void UpdateMenu() {
+	InputGuiValue(&addWidget);
 	//hack to make the ListView behave like a menu
-	if(IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
+	if(InputMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
 		if(addWidget >=0 && addWidget < WIDGET_COUNT) {
 			TraceLog(LOG_INFO, TextFormat("ADDING:%s", WidgetName[addWidget]));
 			AddWidget();
@@ -701,9 +1804,25 @@ void DrawMenu() {
 	}
 }
 
+void DrawMenu() {
+	PROFILE_ZONE("DrawMenu");
+	GuiListView(menu, (const char**)WidgetName, WIDGET_COUNT, &scrollIndex, &addWidget, true); 
+	UpdateMenu();
+}
+
+void UpdateEditorHeadless() {
+	CullWidgets();
+	if(mode == MODE_SHOW_MENU) UpdateMenu();
+	else if(PropertiesVisible()) {
+		BeginProperties();
+		UpdateProperties();
+	}
+}
+
 
 void DrawResizePoints() {
-	Rectangle r = Array_at(&widgets, selectedWidget).bounds;
+	PROFILE_ZONE("DrawResizePoints");
+	Rectangle r = WorldToScreenRec(Array_at(&widgets, selectedWidget).bounds);
 	r.x-=resizerPointSize/2; r.y-=resizerPointSize/2; 
 	r.width+=resizerPointSize; r.height+=resizerPointSize;
 	DrawRectangleLinesEx(r, 1, resizerColor);
@@ -712,181 +1831,209 @@ void DrawResizePoints() {
 	}
 }
 
-void DrawEditor() {
-	//DRAW GRID
-	if(snap){
-		DrawSnapGrid(snapDistance*4, gridLineColor[1]);
-		DrawSnapGrid(snapDistance, gridLineColor[0]);
+//Zoomed out: a flat rectangle in the widget's color for every widget, no text and no
+//raygui, raylib batches all of them into a few draw calls
+static void DrawWidgetsLod(const int* list, size_t n) {
+	PROFILE_ZONE("DrawWidgetsLod");
+	for(size_t k = n; k-- > 0;) {
+		Widget w = Array_at(&widgets, list[k]);
+		DrawRectangleRec(NormalizeRec(w.bounds), WidgetDescs[w.type].lod);
 	}
+}
+
+//`list` is topmost first
+static void DrawWidgets(const int* list, size_t n) {
+	BeginMode2D(camera);
+	if(camera.zoom < LOD_ZOOM) DrawWidgetsLod(list, n);
+	else {
+		PROFILE_ZONE("DrawWidgets");
+		GuiLock(); //lock so widgets won't get focused
+		for(size_t k = n; k-- > 0;) {
+			Widget w = Array_at(&widgets, list[k]);
+			const WidgetDesc* d = &WidgetDescs[w.type];
+			if(d->draw == NULL) continue;
+			WidgetValues v = WidgetValuesOf(w, &widgetStrings, GetWidgetLabel(list[k]));
+			d->draw(w, &v);
+		}
+		GuiUnlock();
+	}
+	EndMode2D();
+}
+
+//The dirty region grown until every widget overlapping it is inside it, so drawing them again
+//doesn't draw over the widgets left out. `list` gets them (topmost first) and `region` the part
+//of the screen to draw again. Returns false when drawing everything is cheaper.
+static bool GrowDirtyRegion(Rectangle* region, int** list, size_t* n) {
+	const Vector2 corner = ScreenToWorld((Vector2){0, 0});
+	const Rectangle view = {corner.x, corner.y, screenWidth/camera.zoom, screenHeight/camera.zoom};
+	const float margin = REDRAW_MARGIN/camera.zoom;
+	size_t words = (BoundsSize(&bounds)+63)/64;
+	uint64_t* mask = (words > 0) ? arena_alloc(&frameArena, words*sizeof(uint64_t)) : NULL;
+	if(words > 0 && mask == NULL) return false;
 	
-	//DRAW WIDGETS
-	GuiLock(); //lock so widgets won't get focused
-	for(ArrayIt i = 0; i< Array_size(&widgets); ++i) {
-		Widget w = Array_at(&widgets, i);
-		switch(w.type) {
-			case WIDGET_WindowBox:
-				GuiWindowBox(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i));
-			break;
-			
-			case WIDGET_GroupBox:
-				GuiGroupBox(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i));
-			break;
-			
-			case WIDGET_Line:
-				GuiLine(w.bounds, 1);
-			break;
-			
-			case WIDGET_Panel:
-				GuiPanel(w.bounds);
-			break;
-			
-			case WIDGET_ScrollPanel:
-				GuiScrollPanel(w.bounds,(Rectangle){0,0,0,0},(Vector2){0,0});
-			break;
-			
-			case WIDGET_Label:
-				GuiLabelEx(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), 0, 4);
-			break;
-			
-			case WIDGET_Button:
-				GuiButton(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i));
-			break;
-			
-			case WIDGET_LabelButton:
-				GuiLabelButton(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i));
-			break;
-			
-			case WIDGET_ImageButton:
-				GuiImageButtonEx(w.bounds, texture, (Rectangle){0,0,20,20}, 
-					TextFormat("  %s%03i", WidgetName[w.type], i));
-			break;
-			
-			case WIDGET_Toggle:
-				GuiToggle(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), true);
-			break;
-			
-			case WIDGET_ToggleGroup:
-				GuiToggleGroupEx(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i),true, 4, 1);
-			break;
-			
-			case WIDGET_CheckBox:
-				GuiCheckBox(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), true);
-			break;
-			
-			case WIDGET_ComboBox:
-				GuiComboBox(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), 0);
-			break;
-			
-			case WIDGET_DropdownBox:{
-				int active = 0;
-				GuiDropdownBox(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), &active, false);
-			}
-			break;
-			
-			case WIDGET_Spinner:{
-				int value = 30;
-				GuiSpinner(w.bounds,&value,0,100,20,true);
-			}
-			break;
-			
-			case WIDGET_ValueBox:{
-				int value = 80;
-				GuiValueBox(w.bounds,&value,0,100,true);
-			}
-			break;
-			
-			case WIDGET_TextBox:
-				GuiTextBox(w.bounds, (char*)TextFormat("%s%03i", WidgetName[w.type], i), 32, true);
-			break;
-			
-			case WIDGET_TextBoxMulti:
-				GuiTextBoxMulti(w.bounds, (char*)TextFormat("%s%03i", WidgetName[w.type], i), 32, true);
-			break;
-			
-			case WIDGET_Slider:
-				GuiSliderEx(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), 70.f, 0.f, 100.f, true);
-			break;
-			
-			case WIDGET_SliderBar:
-				GuiSliderBarEx(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), 70.f, 0.f, 100.f, true);
-			break;
-			
-			case WIDGET_ProgressBar:
-				GuiProgressBarEx(w.bounds, 40.f, 0.f, 100.f, true);
-			break;
-			
-			case WIDGET_StatusBar:
-				GuiStatusBar(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), 4);
-			break;
-			
-			case WIDGET_Dummy:
-				GuiDummyRec(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i));
-			break;
-			
-			case WIDGET_ListView:{
-				int scroll = 0, active = 2;
-				static const char *entries[] = { "Cowboy Bebop", "Evangelion", "Slayers", "Trigun", "Dragon Ball" };
-				GuiListViewEx(w.bounds, entries, NULL, sizeof(entries)/sizeof(entries[0]), &scroll, &active, NULL, true);
-			}
-			break;
-			
-			case WIDGET_ColorPicker:
-				GuiColorPicker(w.bounds, DARKBLUE);
-			break;
-			
-			case WIDGET_MessageBox:{
-				const char* msg = "Hi, how are you today?";
-				GuiMessageBox(w.bounds, TextFormat("%s%03i", WidgetName[w.type], i), msg);
+	Rectangle r = { dirtyRegion.x - margin, dirtyRegion.y - margin, dirtyRegion.width + 2*margin, dirtyRegion.height + 2*margin };
+	for(int step=0;; ++step) {
+		//the widgets only matter as far as they're on the screen
+		float x0 = fmaxf(r.x, view.x), y0 = fmaxf(r.y, view.y);
+		float x1 = fminf(r.x+r.width, view.x+view.width), y1 = fminf(r.y+r.height, view.y+view.height);
+		if(x1 <= x0 || y1 <= y0) {
+			*n = 0;
+			*region = (Rectangle){0};
+			return true;
+		}
+		r = (Rectangle){ x0, y0, x1-x0, y1-y0 };
+		if(r.width*r.height > MAX_REDRAW_AREA*view.width*view.height || step == MAX_REDRAW_STEPS) return false;
+		
+		if(words > 0) {
+			memset(mask, 0, words*sizeof(uint64_t));
+			BoundsOverlap(&bounds, r, mask);
+		}
+		Rectangle grown = r;
+		for(size_t k=0; k<words; ++k) {
+			for(uint64_t bits = mask[k]; bits != 0; bits &= bits-1) {
+				Rectangle b = NormalizeRec(Array_at(&widgets, k*64 + __builtin_ctzll(bits)).bounds);
+				grown = UnionRec(grown, (Rectangle){ b.x - margin, b.y - margin, b.width + 2*margin, b.height + 2*margin });
 			}
-			break;
-			
-			//NEWER CONTROLS IN RAYGUI?
-			case WIDGET_ColorPanel:
-				GuiColorPanel(w.bounds, GOLD);
-			break;
-			
-			case WIDGET_ColorBarAlpha:
-				GuiColorBarAlpha(w.bounds, 0.3f);
-			break;
-			
-			case WIDGET_ColorBarHue:
-				GuiColorBarHue(w.bounds, 0.2f);
-			break;
-			
-			case WIDGET_Grid:
-				GuiGrid(w.bounds, 10, 1);
-			break;
-			
-			default:
-			break;
 		}
+		if(grown.x >= r.x && grown.y >= r.y && grown.x+grown.width <= r.x+r.width && grown.y+grown.height <= r.y+r.height) break;
+		r = grown;
 	}
-	GuiUnlock();
 	
+	*n = 0;
+	*list = arena_alloc(&frameArena, Array_size(&widgets)*sizeof(int));
+	if(*list == NULL && Array_size(&widgets) > 0) return false;
+	for(int i=order.top; i != DEPTH_NONE; i = DepthBelow(&order, i))
+		if((mask[i/64] >> (i%64)) & 1) (*list)[(*n)++] = i;
 	
+	//whole pixels, so nothing is blended twice along the edges
+	Rectangle s = WorldToScreenRec(r);
+	float x0 = floorf(s.x), y0 = floorf(s.y);
+	*region = (Rectangle){ x0, y0, ceilf(s.x + s.width) - x0, ceilf(s.y + s.height) - y0 };
+	return true;
+}
+
+//Bring `canvasLayer` up to date (see RedrawRegion()) and draw it
+static void DrawCanvas() {
+	if(canvasLayer.id == 0) {
+		canvasLayer = LoadRenderTexture(screenWidth, screenHeight);
+		redrawCanvas = true;
+	}
+	
+	Vector2 gridAt;
+	bool grid = snap && PrepareSnapGrid(&gridAt);
+	int* list = NULL;
+	size_t n = 0;
+	Rectangle region;
+	if(!redrawCanvas && redrawRegion && !GrowDirtyRegion(&region, &list, &n)) redrawCanvas = true;
+	
+	if(redrawCanvas) {
+		PROFILE_ZONE("RedrawCanvas");
+		CullWidgets();
+		BeginTextureMode(canvasLayer);
+			ClearBackground(RAYWHITE);
+			if(grid) DrawSnapGrid(gridAt, (Rectangle){ 0, 0, screenWidth, screenHeight });
+			DrawWidgets(Array_data(&drawList), Array_size(&drawList));
+		EndTextureMode();
+		ProfileRedraw(PROFILE_REDRAW_FULL);
+	} else if(redrawRegion) {
+		PROFILE_ZONE("RedrawRegion");
+		//the outlines of the selection need to know what's on the screen
+		CullWidgets();
+		BeginTextureMode(canvasLayer);
+			DrawRectangleRec(region, RAYWHITE);
+			if(grid) DrawSnapGrid(gridAt, region);
+			DrawWidgets(list, n);
+		EndTextureMode();
+		ProfileRedraw(PROFILE_REDRAW_PARTIAL);
+	}
+	canvasCamera = camera;
+	canvasSnap = snap;
+	canvasSnapDistance = snapDistance;
+	redrawCanvas = redrawRegion = false;
+	
+	//render textures are upside down
+	DrawTextureRec(canvasLayer.texture, (Rectangle){ 0, 0, screenWidth, -screenHeight }, (Vector2){ 0, 0 }, WHITE);
+}
+
+//A line through what was lined up and what it was lined up with, on every axis that matched
+static void DrawAlignGuides() {
+	Rectangle s = NormalizeRec(alignSubject);
+	for(int axis=ALIGN_AXIS_X; axis<=ALIGN_AXIS_Y; ++axis) {
+		AlignMatch m = alignGuides[axis];
+		if(m.widget < 0 || m.widget >= (int)Array_size(&widgets)) continue;
+		Rectangle t = NormalizeRec(Array_at(&widgets, m.widget).bounds);
+		Vector2 a, b;
+		if(axis == ALIGN_AXIS_X) {
+			a = WorldToScreen((Vector2){ m.at, fminf(s.y, t.y) });
+			b = WorldToScreen((Vector2){ m.at, fmaxf(s.y + s.height, t.y + t.height) });
+		} else {
+			a = WorldToScreen((Vector2){ fminf(s.x, t.x), m.at });
+			b = WorldToScreen((Vector2){ fmaxf(s.x + s.width, t.x + t.width), m.at });
+		}
+		DrawLineV(a, b, guideColor);
+		DrawRectangleLinesEx(WorldToScreenRec(t), 1, Fade(guideColor, 0.5f));
+	}
+}
+
+void DrawEditor() {
+	PROFILE_ZONE("DrawEditor");
+	DrawCanvas();
 	
 	//DRAW OWN UI ABOVE THE WIDGETS
-	if(selectedWidget != -1 && mode != MODE_SHOW_MENU)
+	if(selection.count > 1) {
+		//only the selected widgets that were drawn get an outline
+		for(ArrayIt k = 0; k < Array_size(&drawList); ++k) {
+			int i = Array_at(&drawList, k);
+			if(SelectionHas(&selection, i)) DrawRectangleLinesEx(WorldToScreenRec(Array_at(&widgets, i).bounds), 1, resizerColor);
+		}
+	}
+	else if(selectedWidget != -1 && mode != MODE_SHOW_MENU)
 		DrawResizePoints();
+	
+	if(lintShown) DrawLint();
+	if(mode == MODE_MOVE_WIDGET || mode == MODE_RESIZE_WIDGET) DrawAlignGuides();
+	
+	if(mode == MODE_SELECT_BOX) {
+		Rectangle r = selectBox;
+		if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+		if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+		r = WorldToScreenRec(r);
+		DrawRectangleRec(r, Fade(resizerColor, 0.1f));
+		DrawRectangleLinesEx(r, 1, resizerColor);
+	}
 		
-	if(selectedWidget != -1) {
-		Widget w = Array_at(&widgets, selectedWidget);
-		char* const tsnap = snap?"ON":"OFF";
-		DrawText(TextFormat("DEPTH:%03i | SNAP:%s | %i widgets | BOUNDS:[%i %i %i %i] | %s", selectedWidget, tsnap, 
-			Array_size(&widgets), (int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height, 
-			EditorModeName[mode]), 4, 4, 10, BLACK);
-	} else {
-		char* const tsnap = snap?"ON":"OFF";
-		DrawText(TextFormat("SNAP:%s | %s | %i widgets", tsnap, EditorModeName[mode], Array_size(&widgets)), 4, 4, 10, BLACK);
+	{
+		PROFILE_ZONE("DrawStatus");
+		//TextFormat() has only one buffer
+		char importStatus[96] = "";
+		ImportProgress progress;
+		if(ImportBusy(&progress)) 
+			snprintf(importStatus, sizeof(importStatus), " | LOADING %i/%i files (%zu widgets)", progress.done, progress.files, progress.widgets);
+		if(selectedWidget != -1) {
+			Widget w = Array_at(&widgets, selectedWidget);
+			char* const tsnap = snap?"ON":"OFF";
+			DrawText(TextFormat("ID:%03i (%i selected) | SNAP:%s %ipx | ALIGN:%s | ZOOM:%i%% | CODE:%s | DROP:%s | %i widgets (%i drawn, %i culled) | BOUNDS:[%i %i %i %i] | %s%s", 
+				w.id, (int)selection.count, tsnap, snapDistance, align?"ON":"OFF", (int)roundf(camera.zoom*100), CodeStyleName[codeStyle], 
+				ImportPlacementName[importPlacement], Array_size(&widgets), drawnCount, culledCount, 
+				(int)w.bounds.x, (int)w.bounds.y, (int)w.bounds.width, (int)w.bounds.height, EditorModeName[mode], importStatus), 4, 4, 10, BLACK);
+		} else {
+			char* const tsnap = snap?"ON":"OFF";
+			DrawText(TextFormat("SNAP:%s %ipx | ALIGN:%s | ZOOM:%i%% | CODE:%s | DROP:%s | %s | %i widgets (%i drawn, %i culled)%s", tsnap, snapDistance, align?"ON":"OFF", 
+				(int)roundf(camera.zoom*100), CodeStyleName[codeStyle], ImportPlacementName[importPlacement], EditorModeName[mode], 
+				Array_size(&widgets), drawnCount, culledCount, importStatus), 4, 4, 10, BLACK);
+		}
 	}
 	
 	//SHOW MENU
 	if(mode == MODE_SHOW_MENU) {
 		DrawMenu();
 	}
+	else if(PropertiesVisible()) DrawProperties();
 	
 	//DRAW GRADIENTS
 	DrawRectangleGradientV(0,0,screenWidth, 10, (Color){0,0,0,80}, (Color){0,0,0,0});
 	DrawRectangleGradientV(0,screenHeight-10,screenWidth, 10, (Color){0,0,0,0}, (Color){0,0,0,80});
+	
+	ProfileDrawOverlay();
 }
 
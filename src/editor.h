@@ -3,13 +3,90 @@
 
 #include <raylib.h>
 #include "../external/array.h"
+#include "stringtable.h"
 
 static const int screenWidth = 800;
 static const int screenHeight = 450;
 
+typedef enum {
+	WIDGET_WindowBox=0,
+	WIDGET_GroupBox,
+	WIDGET_Line,
+	WIDGET_Panel,
+	WIDGET_ScrollPanel,
+	WIDGET_Label,
+	WIDGET_Button,
+	WIDGET_LabelButton,
+	WIDGET_ImageButton,
+	WIDGET_Toggle,
+	WIDGET_ToggleGroup,
+	WIDGET_CheckBox,
+	WIDGET_ComboBox,
+	WIDGET_DropdownBox,
+	WIDGET_Spinner,
+	WIDGET_ValueBox,
+	WIDGET_TextBox,
+	WIDGET_TextBoxMulti,
+	WIDGET_Slider,
+	WIDGET_SliderBar,
+	WIDGET_ProgressBar,
+	WIDGET_StatusBar,
+	WIDGET_Dummy,
+	WIDGET_ListView,
+	WIDGET_ColorPicker,
+	WIDGET_MessageBox,
+	WIDGET_ColorPanel,
+	WIDGET_ColorBarAlpha,
+	WIDGET_ColorBarHue,
+	WIDGET_Grid,
+	WIDGET_COUNT
+} WidgetType;
+
+extern char* WidgetName[];
+
+//which properties of a widget are set, the others are the defaults of its type (see widgets.h)
+typedef enum {
+	PROP_TEXT  = 1 << 0,  //the label, the title of a container or a MessageBox
+	PROP_ITEMS = 1 << 1,  //the entries of a list ("one;two;three"), the message of a MessageBox
+	PROP_RANGE = 1 << 2,  //min and max
+	PROP_VALUE = 1 << 3,  //the value, the active entry of a list or the alpha/hue of a color bar
+	PROP_COLOR = 1 << 4,
+	PROP_ALL   = (1 << 5) - 1
+} WidgetProp;
+
+//what a widget shows, the strings are in the editor's string table
+typedef struct {
+	StringHandle text, items;
+	float min, max, value;
+	Color color;
+	uint16_t set; //WidgetProp flags
+} WidgetProps;
+
+typedef struct {
+	WidgetType type;
+	Rectangle bounds;
+	int id; //stays the same for the life of the widget, used for its default label
+	WidgetProps props;
+} Widget;
+
+typedef Array(Widget) ArrayWidget;
+
+extern Texture2D texture; //a dummy texture used as a placeholder (some widgets require a texture)
+extern const char* projectFile; //autosaved by the journal, set before InitializeEditor()
+extern bool headless; //set before InitializeEditor() to run without a window (replays)
+extern StringTable widgetStrings; //the texts of every widget (WidgetProps)
+
 extern void InitializeEditor();
 extern void DrawEditor();
-extern void UpdateEditor();
+/** Returns false when nothing DrawEditor() draws changed, the last frame can be shown again. */
+extern bool UpdateEditor();
 extern void FinalizeEditor();
+/** Changes DrawEditor() makes to the editor, without drawing. Called instead of it when headless. */
+extern void UpdateEditorHeadless();
+/** Write the widgets to the project file now, the journal thread does the writing. */
+extern void SaveProject();
+/** Record the input of every frame to `trace`, starting from the widgets as they are now.
+ * Returns VEE_OK[0] on success. */
+extern int RecordEditor(const char* trace);
 
-#endif
\ No newline at end of file
+#endif
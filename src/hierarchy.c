@@ -0,0 +1,137 @@
+#include "hierarchy.h"
+#include <math.h>
+
+void HierarchyCreate(Hierarchy* h) {
+	*h = (Hierarchy){0};
+}
+
+void HierarchyDestroy(Hierarchy* h) {
+	Array_destroy(&h->parent);
+	Array_destroy(&h->first);
+	Array_destroy(&h->children);
+	Array_destroy(&h->roots);
+	Array_destroy(&h->containers);
+	for(int i=0; i<HIERARCHY_BUCKET_COUNT; ++i)
+		Array_destroy(&h->buckets[i]);
+	Array_destroy(&h->large);
+}
+
+//widgets resized past the opposite edge have negative sizes
+static inline Rectangle Normalize(Rectangle r) {
+	if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+	if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+	return r;
+}
+
+bool ContainerHolds(Widget c, Rectangle r) {
+	Rectangle o = Normalize(c.bounds);
+	r = Normalize(r);
+	if(c.type == WIDGET_ScrollPanel) return r.x >= o.x && r.y >= o.y && r.x < o.x+o.width && r.y < o.y+o.height;
+	return r.x >= o.x && r.y >= o.y && r.x+r.width <= o.x+o.width && r.y+r.height <= o.y+o.height;
+}
+
+static inline int Cell(float v) {
+	return (int)floorf(v/HIERARCHY_CELL_SIZE);
+}
+
+static inline ArrayInt* GetBucket(Hierarchy* h, int cx, int cy) {
+	unsigned int k = ((unsigned int)cx*73856093u) ^ ((unsigned int)cy*19349663u);
+	return &h->buckets[k & (HIERARCHY_BUCKET_COUNT-1)];
+}
+
+//highest depth rank in `b` of a container holding `r`, `best` if there is none above it
+static inline int FindHolder(const ArrayInt* b, const ArrayWidget* w, const int* byDepth, Rectangle r, int best) {
+	//the ranks were pushed bottom first, the first match from the end is the closest one
+	for(ArrayIt k = Array_size(b); k-- > 0;) {
+		int rank = Array_at(b, k);
+		if(rank <= best) break;
+		if(ContainerHolds(Array_at(w, byDepth[rank]), r)) return rank;
+	}
+	return best;
+}
+
+static int AddContainer(Hierarchy* h, Rectangle r, int rank) {
+	r = Normalize(r);
+	int x0 = Cell(r.x), y0 = Cell(r.y), x1 = Cell(r.x+r.width), y1 = Cell(r.y+r.height);
+	if((long)(x1-x0+1)*(y1-y0+1) > HIERARCHY_MAX_CELLS) return Array_push(&h->large, rank);
+	for(int y=y0; y<=y1; ++y) {
+		for(int x=x0; x<=x1; ++x) {
+			//a container can hash to the same bucket from two of its cells
+			ArrayInt* b = GetBucket(h, x, y);
+			if(Array_size(b) > 0 && Array_at(b, Array_size(b)-1) == rank) continue;
+			if(Array_push(b, rank) != VEE_OK) return VEE_OUT_OF_MEMORY;
+		}
+	}
+	return VEE_OK;
+}
+
+static void Reset(Hierarchy* h) {
+	h->parent.size = h->first.size = h->children.size = h->roots.size = h->containers.size = 0;
+}
+
+int HierarchyBuild(Hierarchy* h, const ArrayWidget* w, const int* byDepth) {
+	Reset(h);
+	for(int i=0; i<HIERARCHY_BUCKET_COUNT; ++i)
+		h->buckets[i].size = 0;
+	h->large.size = 0;
+
+	size_t n = Array_size(w);
+	if(Array_reserve_exact(&h->parent, n) != VEE_OK || Array_reserve_exact(&h->first, n+1) != VEE_OK
+		|| Array_reserve_exact(&h->children, n) != VEE_OK || Array_reserve_exact(&h->roots, n) != VEE_OK)
+		return VEE_OUT_OF_MEMORY;
+	h->parent.size = n;
+	h->first.size = n+1;
+	memset(Array_data(&h->first), 0, (n+1)*sizeof(int));
+
+	//the parent of every widget, the children are counted in `first`
+	for(size_t rank=0; rank<n; ++rank) {
+		int slot = byDepth[rank];
+		Widget widget = Array_at(w, slot);
+		Rectangle r = Normalize(widget.bounds);
+		int holder = FindHolder(GetBucket(h, Cell(r.x), Cell(r.y)), w, byDepth, r, -1);
+		holder = FindHolder(&h->large, w, byDepth, r, holder);
+
+		int parent = (holder == -1) ? -1 : byDepth[holder];
+		Array_at(&h->parent, slot) = parent;
+		if(parent == -1) Array_at(&h->roots, h->roots.size++) = slot;
+		else ++Array_at(&h->first, parent+1);
+
+		if(IsContainerWidget(widget.type) && (Array_push(&h->containers, slot) != VEE_OK || AddContainer(h, r, rank) != VEE_OK)) {
+			Reset(h);
+			return VEE_OUT_OF_MEMORY;
+		}
+	}
+
+	//children lists, bottom first
+	for(size_t i=0; i<n; ++i)
+		Array_at(&h->first, i+1) += Array_at(&h->first, i);
+	h->children.size = Array_at(&h->first, n);
+	for(size_t rank=0; rank<n; ++rank) {
+		int slot = byDepth[rank], parent = Array_at(&h->parent, slot);
+		//`first` of the parent is used as the fill position and put back below
+		if(parent != -1) Array_at(&h->children, Array_at(&h->first, parent)++) = slot;
+	}
+	for(size_t i=n; i-- > 0;)
+		Array_at(&h->first, i+1) = Array_at(&h->first, i);
+	Array_at(&h->first, 0) = 0;
+	return VEE_OK;
+}
+
+int HierarchyAddDescendants(const Hierarchy* h, Selection* s) {
+	ArrayInt stack = {0};
+	int r = VEE_OK;
+	for(int i = SelectionNext(s, 0); i != -1 && r == VEE_OK; i = SelectionNext(s, i+1))
+		if((size_t)i < Array_size(&h->parent)) r = Array_push(&stack, i);
+	while(Array_size(&stack) > 0 && r == VEE_OK) {
+		int i = Array_at(&stack, Array_size(&stack)-1);
+		Array_pop(&stack);
+		const int* c = HierarchyChildren(h, i);
+		for(int k=0; k<HierarchyChildCount(h, i) && r == VEE_OK; ++k) {
+			if(SelectionHas(s, c[k])) continue;
+			r = SelectionAdd(s, c[k]);
+			if(r == VEE_OK) r = Array_push(&stack, c[k]);
+		}
+	}
+	Array_destroy(&stack);
+	return r;
+}
@@ -0,0 +1,64 @@
+#ifndef GE_HIERARCHY_H
+#define GE_HIERARCHY_H
+
+#include "editor.h"
+#include "spatial.h"
+#include "selection.h"
+
+/* HIERARCHY
+ * WindowBox, GroupBox, Panel and ScrollPanel hold the widgets that are inside them. A widget
+ * is a child of the closest container below it (in depth) that contains it: fully for most
+ * containers, only the top-left corner for a ScrollPanel (its content may go past the bottom
+ * and right edges, that's what the scrolling is for).
+ *
+ * The hierarchy isn't stored anywhere, it follows from the bounds and the depth order and is
+ * built again after the widgets changed. Dropping a widget inside a container (or out of it)
+ * is all it takes to reparent it, and the files, the journal and the undo history don't need
+ * to know about it. Building it is one walk over the widgets from the bottom up, with the
+ * containers seen so far kept in a hashed grid so a widget is only tested against the
+ * containers around its top-left corner. */
+
+//grid the containers are kept in while building
+#define HIERARCHY_CELL_SIZE 128
+#define HIERARCHY_BUCKET_COUNT 1024 //power of 2
+//containers covering more cells than this are tested against every widget instead
+#define HIERARCHY_MAX_CELLS 256
+
+typedef struct {
+	ArrayInt parent;    //slot of the parent of every slot, -1 at the top
+	ArrayInt first;     //the children of slot `i` are children[first[i]] to children[first[i+1]-1]
+	ArrayInt children;  //bottom first
+	ArrayInt roots;     //widgets without a parent, bottom first
+	ArrayInt containers; //every container, bottom first
+
+	//scratch memory of HierarchyBuild(), depth ranks of the containers
+	ArrayInt buckets[HIERARCHY_BUCKET_COUNT];
+	ArrayInt large;
+} Hierarchy;
+
+extern void HierarchyCreate(Hierarchy* h);
+extern void HierarchyDestroy(Hierarchy* h);
+
+/** Build the hierarchy of the widgets `w`. `byDepth` has the slots of all of them from the
+ * bottom to the top. Returns VEE_OK[0] on success, the hierarchy is empty otherwise. */
+extern int HierarchyBuild(Hierarchy* h, const ArrayWidget* w, const int* byDepth);
+
+/** Add the descendants of every widget in `s` to `s`. Returns VEE_OK[0] on success. */
+extern int HierarchyAddDescendants(const Hierarchy* h, Selection* s);
+
+/** True when the container `c` would hold a widget with bounds `r` (if it was above it). */
+extern bool ContainerHolds(Widget c, Rectangle r);
+
+static inline bool IsContainerWidget(WidgetType t) {
+	return t == WIDGET_WindowBox || t == WIDGET_GroupBox || t == WIDGET_Panel || t == WIDGET_ScrollPanel;
+}
+
+static inline int HierarchyParent(const Hierarchy* h, int slot) { return Array_at(&h->parent, slot); }
+static inline int HierarchyChildCount(const Hierarchy* h, int slot) {
+	return Array_at(&h->first, slot+1) - Array_at(&h->first, slot);
+}
+static inline const int* HierarchyChildren(const Hierarchy* h, int slot) {
+	return &Array_at(&h->children, Array_at(&h->first, slot));
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include "history.h"
+
+static inline size_t EntryBytes(const HistoryEntry* e) {
+	size_t n = sizeof(HistoryEntry);
+	//the copy of a range is counted before it's taken, see HistoryRecordRange()
+	if(e->op == HISTORY_INSERT_RANGE) n += e->count*sizeof(Widget);
+	if(e->moves != NULL) n += e->count*sizeof(WidgetMove);
+	return n;
+}
+
+static inline void FreeEntry(History* h, HistoryEntry* e) {
+	h->bytes -= EntryBytes(e);
+	free(e->range);
+	free(e->moves);
+}
+
+//drop everything from `p` on
+static void Truncate(History* h, ArrayIt p) {
+	for(ArrayIt i=p; i<Array_size(&h->entries); ++i)
+		FreeEntry(h, &Array_at(&h->entries, i));
+	h->entries.size = p;
+	if(h->cursor > p) h->cursor = p;
+}
+
+//drop the oldest entries until the history fits the budget again. Goes a bit below it
+//so the entries don't have to be shifted after every edit. Groups are dropped as a whole.
+static void Trim(History* h) {
+	if(h->bytes <= h->budget) return;
+	size_t target = h->budget - h->budget/4, n = 0;
+	while(n < Array_size(&h->entries) && (h->bytes > target || Array_at(&h->entries, n).joined))
+		FreeEntry(h, &Array_at(&h->entries, n++));
+	Array_remove(&h->entries, 0, n);
+	h->cursor = h->cursor > n ? h->cursor - n : 0;
+}
+
+void HistoryCreate(History* h, size_t budget) {
+	*h = (History){0};
+	h->budget = budget;
+}
+
+void HistoryDestroy(History* h) {
+	Truncate(h, 0);
+	Array_destroy(&h->entries);
+	h->bytes = 0;
+}
+
+void HistoryClear(History* h) {
+	Truncate(h, 0);
+	h->merge = false;
+	h->joinNext = false;
+}
+
+void HistoryBreak(History* h) {
+	h->merge = false;
+}
+
+void HistoryBeginGroup(History* h) {
+	h->merge = false;
+	h->group = true;
+	h->joinNext = false;
+}
+
+void HistoryEndGroup(History* h) {
+	h->group = false;
+	h->joinNext = false;
+}
+
+void HistoryRecord(History* h, HistoryEntry e) {
+	Truncate(h, h->cursor);
+
+	if(e.op == HISTORY_SET && h->merge && h->cursor > 0) {
+		HistoryEntry* last = &Array_at(&h->entries, h->cursor-1);
+		if(last->op == HISTORY_SET && last->index == e.index) {
+			last->widget = e.widget;
+			return;
+		}
+	}
+	h->merge = (e.op == HISTORY_SET);
+	e.joined = h->joinNext;
+	h->joinNext = h->group;
+
+	if(Array_push(&h->entries, e) != VEE_OK) {
+		//can't remember this edit so older ones can't be undone safely either
+		free(e.range);
+		free(e.moves);
+		HistoryClear(h);
+		return;
+	}
+	h->cursor = Array_size(&h->entries);
+	h->bytes += EntryBytes(&e);
+	Trim(h);
+}
+
+void HistoryRecordRange(History* h, ArrayIt p, size_t n, int below) {
+	HistoryRecord(h, (HistoryEntry){ .op = HISTORY_INSERT_RANGE, .index = p, .count = n, .below = below });
+}
+
+int HistoryRecordTranslate(History* h, const WidgetMove* m, size_t n, Vector2 offset) {
+	WidgetMove* moves = malloc(n*sizeof(WidgetMove));
+	if(moves == NULL) {
+		HistoryClear(h);
+		return VEE_OUT_OF_MEMORY;
+	}
+	memcpy(moves, m, n*sizeof(WidgetMove));
+	HistoryRecord(h, (HistoryEntry){ .op = HISTORY_TRANSLATE, .count = n, .moves = moves, .offset = offset });
+	return VEE_OK;
+}
+
+//apply `e` to `w` and `d` if it fits the array
+static bool Apply(ArrayWidget* w, DepthOrder* d, const HistoryEntry* e) {
+	size_t n = Array_size(w);
+	switch(e->op) {
+		case HISTORY_INSERT:
+			if(e->index > n || WidgetSwapInsert(w, e->index, e->widget) != VEE_OK) return false;
+			if(DepthOrderSwapInsert(d, e->index, e->below) != VEE_OK) {
+				WidgetSwapRemove(w, e->index);
+				return false;
+			}
+			return true;
+		case HISTORY_REMOVE:
+			if(e->index >= n) return false;
+			WidgetSwapRemove(w, e->index);
+			DepthOrderSwapRemove(d, e->index);
+			return true;
+		case HISTORY_SET:
+			if(e->index >= n) return false;
+			Array_at(w, e->index) = e->widget;
+			return true;
+		case HISTORY_MOVE:
+			if(e->index >= n) return false;
+			DepthOrderMove(d, e->index, e->below);
+			return true;
+		case HISTORY_INSERT_RANGE:
+			if(e->index != n || Array_reserve_exact(w, n + e->count) != VEE_OK) return false;
+			if(DepthOrderAppend(d, e->count, NULL, e->below) != VEE_OK) return false;
+			memcpy(&Array_at(w, n), e->range, e->count*sizeof(Widget));
+			w->size += e->count;
+			return true;
+		case HISTORY_REMOVE_RANGE:
+			if(e->index + e->count != n) return false;
+			for(size_t i = n; i-- > e->index;) DepthOrderSwapRemove(d, i);
+			w->size = e->index;
+			return true;
+		case HISTORY_TRANSLATE:
+			for(size_t i=0; i<e->count; ++i)
+				if(e->moves[i].index >= n) return false;
+			TranslateWidgets(w, e->moves, e->count, e->reverse ? (Vector2){0, 0} : e->offset);
+			return true;
+	}
+	return false;
+}
+
+static HistoryEntry Invert(HistoryEntry e) {
+	switch(e.op) {
+		case HISTORY_INSERT: e.op = HISTORY_REMOVE; break;
+		case HISTORY_REMOVE: e.op = HISTORY_INSERT; break;
+		case HISTORY_SET: {
+			Widget tmp = e.before;
+			e.before = e.widget;
+			e.widget = tmp;
+		} break;
+		case HISTORY_MOVE: {
+			int tmp = e.below;
+			e.below = e.oldBelow;
+			e.oldBelow = tmp;
+		} break;
+		case HISTORY_INSERT_RANGE: e.op = HISTORY_REMOVE_RANGE; break;
+		case HISTORY_REMOVE_RANGE: e.op = HISTORY_INSERT_RANGE; break;
+		case HISTORY_TRANSLATE: e.reverse = !e.reverse; break;
+	}
+	return e;
+}
+
+bool HistoryUndo(History* h, ArrayWidget* w, DepthOrder* d, HistoryEntry* change) {
+	if(h->cursor == 0) return false;
+	HistoryEntry* last = &Array_at(&h->entries, h->cursor-1);
+	//everything after the range was undone, so the widgets are the ones that were added
+	if(last->op == HISTORY_INSERT_RANGE && last->range == NULL) {
+		if(last->index + last->count != Array_size(w)) return false;
+		last->range = malloc(last->count*sizeof(Widget));
+		if(last->range == NULL) return false;
+		memcpy(last->range, &Array_at(w, last->index), last->count*sizeof(Widget));
+	}
+	HistoryEntry e = Invert(*last);
+	if(!Apply(w, d, &e)) return false;
+	h->cursor -= 1;
+	h->merge = false;
+	HistoryEndGroup(h);
+	if(change != NULL) *change = e;
+	return true;
+}
+
+bool HistoryRedo(History* h, ArrayWidget* w, DepthOrder* d, HistoryEntry* change) {
+	if(h->cursor == Array_size(&h->entries)) return false;
+	HistoryEntry e = Array_at(&h->entries, h->cursor);
+	if(!Apply(w, d, &e)) return false;
+	h->cursor += 1;
+	h->merge = false;
+	HistoryEndGroup(h);
+	if(change != NULL) *change = e;
+	return true;
+}
+
+bool HistoryRedoJoined(const History* h) {
+	return h->cursor < Array_size(&h->entries) && Array_at(&h->entries, h->cursor).joined;
+}
@@ -0,0 +1,93 @@
+#ifndef GE_HISTORY_H
+#define GE_HISTORY_H
+
+#include "editor.h"
+#include "depth.h"
+#include "selection.h"
+
+/* UNDO/REDO HISTORY
+ * Every edit is stored as a small delta (the index and the widget values it touched)
+ * instead of a copy of the widget array, so undo and redo cost as much as the edit did.
+ * Only bulk loads keep a copy, and only of the widgets they inserted (taken on the first undo).
+ * Edits made together (e.g. on a whole selection) are grouped and undone/redone as one. */
+
+//default amount of memory the history may use before the oldest entries are dropped
+#define HISTORY_DEFAULT_BUDGET (8*1024*1024)
+
+//widgets are added and removed with WidgetSwapInsert()/WidgetSwapRemove() and the
+//matching DepthOrder functions, see depth.h
+typedef enum {
+	HISTORY_INSERT = 0,    //`widget` was put at `index` right above `below`
+	HISTORY_REMOVE,        //`widget` (right above `below`) was removed from `index`
+	HISTORY_SET,           //widget `index` changed from `before` to `widget`
+	HISTORY_MOVE,          //widget `index` moved from above `oldBelow` to above `below`
+	HISTORY_INSERT_RANGE,  //`count` widgets from `range` were added at `index` (the end), stacked above `below`
+	HISTORY_REMOVE_RANGE,  //the `count` widgets from `index` on (the end) were removed
+	HISTORY_TRANSLATE,     //the `count` widgets in `moves` went from their `from` position by `offset`
+} HistoryOpType;
+
+typedef struct {
+	HistoryOpType op;
+	uint32_t index;
+	uint32_t count;
+	int below;
+	int oldBelow;
+	Widget before;
+	Widget widget;
+	Widget* range;  //owned by the history
+	WidgetMove* moves;  //owned by the history
+	Vector2 offset;
+	bool reverse;   //set on an undone HISTORY_TRANSLATE, the widgets went back to `from`
+	bool joined;    //undone/redone together with the entry before it
+} HistoryEntry;
+
+//position of move `m` of the HISTORY_TRANSLATE `e` after (or before when `before` is set) it was applied
+static inline Vector2 HistoryMovedTo(const HistoryEntry* e, WidgetMove m, bool before) {
+	if(e->reverse == before) m.from.x += e->offset.x, m.from.y += e->offset.y;
+	return m.from;
+}
+
+typedef Array(HistoryEntry) ArrayHistoryEntry;
+
+typedef struct {
+	ArrayHistoryEntry entries;  //entries before `cursor` can be undone, the rest redone
+	ArrayIt cursor;
+	size_t bytes;               //memory held by the entries
+	size_t budget;
+	bool merge;                 //the next HISTORY_SET may be merged into the last entry
+	bool group;                 //between HistoryBeginGroup() and HistoryEndGroup()
+	bool joinNext;              //the next entry is joined to the last one
+} History;
+
+extern void HistoryCreate(History* h, size_t budget);
+extern void HistoryDestroy(History* h);
+extern void HistoryClear(History* h);
+
+/** Record an edit that was just applied. Drops everything that could be redone.
+ * Consecutive HISTORY_SET entries of the same widget are merged into one until
+ * HistoryBreak() is called. */
+extern void HistoryRecord(History* h, HistoryEntry e);
+/** Record that `n` widgets were added to the end of the array at `p` and stacked above `below`.
+ * They're copied when the range is undone, until then they're the ones in the array. */
+extern void HistoryRecordRange(History* h, ArrayIt p, size_t n, int below);
+/** Record that the `n` widgets in `m` were moved by `offset` from their `from` position (copies `m`).
+ * Returns VEE_OK[0] on success. */
+extern int HistoryRecordTranslate(History* h, const WidgetMove* m, size_t n, Vector2 offset);
+/** Start a new entry with the next edit (e.g. when a new drag begins). */
+extern void HistoryBreak(History* h);
+/** Everything recorded until HistoryEndGroup() is undone and redone together. Undo and redo
+ * end the group. Groups don't nest. */
+extern void HistoryBeginGroup(History* h);
+extern void HistoryEndGroup(History* h);
+
+/** Revert the last edit in `w` and `d`. The change that was applied is stored in `change`
+ * (its `range` and `moves` are still owned by the history). Returns false if there is nothing to undo.
+ * One entry is reverted per call, keep calling while `change->joined` is set to undo a whole group. */
+extern bool HistoryUndo(History* h, ArrayWidget* w, DepthOrder* d, HistoryEntry* change);
+/** Apply the last undone edit to `w` and `d` again. Same as HistoryUndo() otherwise,
+ * keep calling while HistoryRedoJoined() is true to redo a whole group. */
+extern bool HistoryRedo(History* h, ArrayWidget* w, DepthOrder* d, HistoryEntry* change);
+/** True if the next entry to redo belongs to the group of the one redone last. */
+extern bool HistoryRedoJoined(const History* h);
+
+#endif
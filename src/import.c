@@ -0,0 +1,210 @@
+#include "import.h"
+#include "uifile.h"
+#include "profile.h"
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h> //for sysconf()
+
+static struct {
+	pthread_t threads[IMPORT_MAX_WORKERS];
+	int workers;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;    //a file was queued or the workers have to quit
+	pthread_cond_t idle;    //a file was read
+	ArrayImportFile files;  //guarded by `lock`, the current batch
+	size_t next;            //guarded by `lock`, first file no worker took yet
+	size_t done;            //guarded by `lock`
+	size_t widgets;         //guarded by `lock`, decoded so far
+	bool quit;              //guarded by `lock`
+} import = { .lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER, .idle = PTHREAD_COND_INITIALIZER };
+
+
+// -------
+// WORKERS
+// -------
+
+//Leave the widgets of `f` in their draw order and find their extent
+static void ReadFile(ImportFile* f) {
+	PROFILE_ZONE("ImportFile");
+	ArrayWidget loaded = {0};
+	ArrayDepthRank depth = {0};
+	if(StringTableCreate(&f->strings, NULL) != VEE_OK) {
+		f->result = VEE_OUT_OF_MEMORY;
+		return;
+	}
+	f->result = ReadUIFile(f->path, &loaded, 0, &depth, &f->strings);
+	//files saved without reordering anything are in draw order already
+	bool ordered = true;
+	for(int i=0; i<f->result && ordered; ++i) ordered = Array_at(&depth, i) == (uint32_t)i;
+	if(f->result > 0 && ordered) {
+		f->widgets = loaded;
+		loaded = (ArrayWidget){0};
+	} else if(f->result > 0 && Array_reserve_exact(&f->widgets, f->result) != VEE_OK) {
+		f->result = VEE_OUT_OF_MEMORY;
+	}
+	if(f->result > 0) {
+		Widget* out = Array_data(&f->widgets);
+		float x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+		for(int i=0; i<f->result; ++i) {
+			Widget w = ordered ? out[i] : Array_at(&loaded, i);
+			if(!ordered) out[Array_at(&depth, i)] = w;
+			//the size can be negative after a resize, the decoder let only finite bounds through
+			float l = w.bounds.x, r = w.bounds.x + w.bounds.width, t = w.bounds.y, b = w.bounds.y + w.bounds.height;
+			if(r < l) { float tmp = l; l = r; r = tmp; }
+			if(b < t) { float tmp = t; t = b; b = tmp; }
+			x0 = (l < x0) ? l : x0;
+			y0 = (t < y0) ? t : y0;
+			x1 = (r > x1) ? r : x1;
+			y1 = (b > y1) ? b : y1;
+		}
+		f->widgets.size = f->result;
+		f->extent = (Rectangle){ x0, y0, x1 - x0, y1 - y0 };
+	}
+	Array_destroy(&loaded);
+	Array_destroy(&depth);
+}
+
+static void* ImportThread(void* arg) {
+	pthread_mutex_lock(&import.lock);
+	for(;;) {
+		while(import.next == Array_size(&import.files) && !import.quit)
+			pthread_cond_wait(&import.wake, &import.lock);
+		if(import.quit) break;
+
+		//the batch can grow while the file is read, the file itself stays where it is
+		ImportFile* f = Array_at(&import.files, import.next++);
+		pthread_mutex_unlock(&import.lock);
+		ReadFile(f);
+		pthread_mutex_lock(&import.lock);
+
+		++import.done;
+		if(f->result > 0) import.widgets += f->result;
+		pthread_cond_broadcast(&import.idle);
+	}
+	pthread_mutex_unlock(&import.lock);
+	return NULL;
+}
+
+//started on the first drop, one per core
+static void StartWorkers() {
+	if(import.workers > 0) return;
+	import.quit = false;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	int n = (cores < 1) ? 1 : (cores > IMPORT_MAX_WORKERS) ? IMPORT_MAX_WORKERS : cores;
+	for(int i=0; i<n; ++i) {
+		if(pthread_create(&import.threads[import.workers], NULL, ImportThread, NULL) != 0) break;
+		++import.workers;
+	}
+}
+
+
+// -------
+// EDITOR SIDE
+// -------
+
+static void FreeFile(ImportFile* f) {
+	free(f->path);
+	Array_destroy(&f->widgets);
+	StringTableDestroy(&f->strings);
+	free(f);
+}
+
+int ImportFiles(char** files, int count) {
+	pthread_mutex_lock(&import.lock);
+	StartWorkers();
+	int r = (import.workers > 0) ? Array_reserve(&import.files, Array_size(&import.files) + count) : VEE_BAD_ARG;
+	for(int i=0; i<count && r == VEE_OK; ++i) {
+		ImportFile* f = calloc(1, sizeof(ImportFile));
+		char* path = strdup(files[i]);
+		if(f == NULL || path == NULL) {
+			free(f);
+			free(path);
+			r = VEE_OUT_OF_MEMORY;
+			break;
+		}
+		f->path = path;
+		Array_push(&import.files, f);
+	}
+	pthread_cond_broadcast(&import.wake);
+	pthread_mutex_unlock(&import.lock);
+	return r;
+}
+
+bool ImportBusy(ImportProgress* p) {
+	pthread_mutex_lock(&import.lock);
+	bool busy = import.done < Array_size(&import.files);
+	if(p != NULL) *p = (ImportProgress){ Array_size(&import.files), import.done, import.widgets };
+	pthread_mutex_unlock(&import.lock);
+	return busy;
+}
+
+void ImportWait() {
+	pthread_mutex_lock(&import.lock);
+	while(import.done < Array_size(&import.files) && import.workers > 0)
+		pthread_cond_wait(&import.idle, &import.lock);
+	pthread_mutex_unlock(&import.lock);
+}
+
+bool ImportTake(ArrayImportFile* batch) {
+	pthread_mutex_lock(&import.lock);
+	bool ready = Array_size(&import.files) > 0 && import.done == Array_size(&import.files);
+	if(ready) {
+		*batch = import.files;
+		import.files = (ArrayImportFile){0};
+		import.next = import.done = import.widgets = 0;
+	}
+	pthread_mutex_unlock(&import.lock);
+	return ready;
+}
+
+void ImportPlace(ArrayImportFile* batch, ImportPlacement placement) {
+	//rows about as wide as the batch is tall
+	float area = 0, widest = 0;
+	for(ArrayIt i=0; i<Array_size(batch); ++i) {
+		ImportFile* f = Array_at(batch, i);
+		if(f->result <= 0) continue;
+		area += (f->extent.width + IMPORT_TILE_GAP)*(f->extent.height + IMPORT_TILE_GAP);
+		widest = fmaxf(widest, f->extent.width);
+	}
+	float rowWidth = fmaxf(widest, sqrtf(area));
+
+	int placed = 0;
+	Vector2 origin = {0}, at = {0};
+	float rowHeight = 0;
+	for(ArrayIt i=0; i<Array_size(batch); ++i) {
+		ImportFile* f = Array_at(batch, i);
+		if(f->result <= 0) continue;
+		if(placed == 0) origin = at = (Vector2){ f->extent.x, f->extent.y };
+
+		if(placement == IMPORT_TILE) {
+			if(at.x > origin.x && at.x - origin.x + f->extent.width > rowWidth) {
+				at = (Vector2){ origin.x, at.y + rowHeight + IMPORT_TILE_GAP };
+				rowHeight = 0;
+			}
+			f->offset = (Vector2){ at.x - f->extent.x, at.y - f->extent.y };
+			at.x += f->extent.width + IMPORT_TILE_GAP;
+			rowHeight = fmaxf(rowHeight, f->extent.height);
+		} else {
+			f->offset = (Vector2){ placed*IMPORT_OFFSET_STEP, placed*IMPORT_OFFSET_STEP };
+		}
+		++placed;
+	}
+}
+
+void ImportRelease(ArrayImportFile* batch) {
+	for(ArrayIt i=0; i<Array_size(batch); ++i) FreeFile(Array_at(batch, i));
+	Array_destroy(batch);
+}
+
+void ImportClose() {
+	pthread_mutex_lock(&import.lock);
+	import.quit = true;
+	pthread_cond_broadcast(&import.wake);
+	pthread_mutex_unlock(&import.lock);
+	for(int i=0; i<import.workers; ++i) pthread_join(import.threads[i], NULL);
+	import.workers = 0;
+
+	//whatever a worker didn't finish is dropped
+	ImportRelease(&import.files);
+	import.next = import.done = import.widgets = 0;
+}
@@ -0,0 +1,63 @@
+#ifndef GE_IMPORT_H
+#define GE_IMPORT_H
+
+#include "editor.h"
+
+/* IMPORT
+ * Files dropped on the editor are read and decoded by a pool of IMPORT_MAX_WORKERS threads
+ * at most (one per core), so a batch of big layouts never holds up a frame. Files dropped
+ * while a batch is still being read join that batch. Once every file of the batch is done,
+ * ImportTake() hands all of them to the editor at once and it adds them to the widget
+ * array IMPORT_MERGE_STEP widgets per frame. The workers leave the strings of a file in its
+ * own table, the editor interns each of them once.
+ *
+ * A worker leaves the widgets of a file in their draw order (the first one is drawn first)
+ * and works out their extent, ImportPlace() uses it to keep the files from landing on top
+ * of each other. */
+
+#define IMPORT_MAX_WORKERS 8
+//widgets of a batch the editor adds per frame
+#define IMPORT_MERGE_STEP 16384
+//distance between the files of a batch placed with IMPORT_OFFSET
+#define IMPORT_OFFSET_STEP 20
+//space between the files of a batch placed with IMPORT_TILE
+#define IMPORT_TILE_GAP 40
+
+typedef enum {
+	IMPORT_OFFSET = 0,  //every file where it was saved, the next one a step further down and right
+	IMPORT_TILE,        //the files side by side in rows, from where the first one was saved
+	IMPORT_PLACEMENT_COUNT
+} ImportPlacement;
+
+typedef struct {
+	char* path;
+	int result;         //number of widgets or a negative VEE_* error code
+	ArrayWidget widgets;//in draw order
+	StringTable strings;//of the widgets, their handles point here
+	Rectangle extent;   //of the widgets
+	Vector2 offset;     //set by ImportPlace()
+} ImportFile;
+
+typedef Array(ImportFile*) ArrayImportFile;
+
+typedef struct {
+	int files, done;    //in the current batch
+	size_t widgets;     //decoded so far
+} ImportProgress;
+
+/** Queue `files` to be read. Returns VEE_OK[0] on success. */
+extern int ImportFiles(char** files, int count);
+/** True while a batch is being read, `p` (can be NULL) gets how far it got. */
+extern bool ImportBusy(ImportProgress* p);
+/** Block until the current batch is read. */
+extern void ImportWait();
+/** Move the files of a batch that was read completely to `batch`, in the order they were
+ * queued. Returns false when there is no such batch. Release it with ImportRelease(). */
+extern bool ImportTake(ArrayImportFile* batch);
+/** Set the offset of every file of `batch` that was read. */
+extern void ImportPlace(ArrayImportFile* batch, ImportPlacement placement);
+extern void ImportRelease(ArrayImportFile* batch);
+/** Stop the workers, anything still queued is dropped. */
+extern void ImportClose();
+
+#endif
@@ -0,0 +1,463 @@
+#include "input.h"
+#include "uifile.h"
+
+typedef Array(uint8_t) ArrayByte;
+typedef Array(char) ArrayChar;
+typedef Array(char*) ArrayString;
+
+//every key the editor looks at, new keys go at the end so older traces still map
+static const int InputKeys[] = {
+	KEY_LEFT_SHIFT, KEY_RIGHT_SHIFT, KEY_LEFT_CONTROL, KEY_RIGHT_CONTROL, KEY_LEFT_ALT, KEY_RIGHT_ALT,
+	KEY_KP_ADD, KEY_UP, KEY_KP_SUBTRACT, KEY_DOWN, KEY_HOME, KEY_PAGE_UP, KEY_END, KEY_PAGE_DOWN,
+	KEY_DELETE, KEY_X, KEY_D, KEY_SPACE, KEY_S, KEY_Z, KEY_Y, KEY_F1, KEY_F2,
+	KEY_LEFT_BRACKET, KEY_RIGHT_BRACKET, KEY_ZERO, KEY_T, KEY_P, KEY_E, KEY_A, KEY_L,
+};
+#define INPUT_KEY_COUNT (int)(sizeof(InputKeys)/sizeof(InputKeys[0]))
+#define INPUT_BUTTON_COUNT 3 //left, right, middle
+
+typedef struct {
+	Vector2 mouse;
+	uint8_t down, pressed, released;  //bit per mouse button
+	int wheel;
+	uint32_t keysDown, keysPressed;   //bit per entry of InputKeys
+	char** dropped;
+	int droppedCount;
+	int gui[INPUT_MAX_GUI_VALUES];
+	int guiCount, guiNext;
+	bool guiText;                     //the text is in `input.text`
+} InputFrame;
+
+typedef enum {
+	INPUT_LIVE,
+	INPUT_RECORDING,
+	INPUT_REPLAYING,
+} InputMode;
+
+static struct {
+	InputMode mode;
+	InputFrame frame, last;
+
+	FILE* file;        //recording only
+	ArrayByte record;  //the frame being recorded
+
+	ArrayByte trace;   //replaying only, the whole file
+	size_t at;         //start of the next frame in `trace`
+	int keyMap[32];    //bit of the trace -> entry of InputKeys (-1 if it's not tracked anymore)
+	int traceKeys;
+	ArrayChar names;   //dropped files of the current frame
+	ArrayString dropped;
+	ArrayChar text;    //gui text of the current frame
+} input;
+
+static inline int KeyIndex(int key) {
+	for(int i=0; i<INPUT_KEY_COUNT; ++i)
+		if(InputKeys[i] == key) return i;
+	return -1;
+}
+
+
+// -------
+// RECORDING
+// -------
+
+static int Put(const void* p, size_t n) {
+	if(Array_reserve(&input.record, Array_size(&input.record)+n) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	memcpy(&Array_at(&input.record, Array_size(&input.record)), p, n);
+	input.record.size += n;
+	return VEE_OK;
+}
+
+static inline void PutU16(uint16_t v) { uint8_t b[2]; put_u16le(b, v); Put(b, 2); }
+static inline void PutU32(uint32_t v) { uint8_t b[4]; put_u32le(b, v); Put(b, 4); }
+static inline void PutF32(float v) { uint8_t b[4]; put_f32le(b, v); Put(b, 4); }
+
+int InputRecord(const char* trace, const ArrayWidget* w, const DepthOrder* d, const StringTable* strings) {
+	InputClose();
+	ArrayDepthRank depth = {0};
+	if(DepthOrderRanks(d, &depth) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	input.file = fopen(trace, "wb");
+	if(input.file == NULL) {
+		Array_destroy(&depth);
+		return VEE_IO_ERROR;
+	}
+
+	input.record.size = 0;
+	Put(INPUT_TRACE_MAGIC, 4);
+	PutU16(INPUT_TRACE_VERSION);
+	PutU16(INPUT_KEY_COUNT);
+	PutU32(Array_size(w));
+	for(int i=0; i<INPUT_KEY_COUNT; ++i) PutU16(InputKeys[i]);
+	for(ArrayIt i=0; i<Array_size(w); ++i) {
+		Widget widget = Array_at(w, i);
+		PutU16(widget.type);
+		PutU32(widget.id);
+		PutU32(Array_at(&depth, i));
+		PutF32(widget.bounds.x);
+		PutF32(widget.bounds.y);
+		PutF32(widget.bounds.width);
+		PutF32(widget.bounds.height);
+		uint8_t props[UIF_PROPS_SIZE];
+		PutU16(widget.props.set);
+		PutWidgetProps(props, widget.props);
+		Put(props, UIF_PROPS_SIZE);
+	}
+	Array_destroy(&depth);
+	PutU32(StringTableSize(strings));
+	Put(StringTableData(strings), StringTableSize(strings));
+
+	size_t size = INPUT_TRACE_HEADER_SIZE + INPUT_KEY_COUNT*2 + Array_size(w)*INPUT_TRACE_WIDGET_SIZE + 4 + StringTableSize(strings);
+	if(Array_size(&input.record) != size || fwrite(Array_data(&input.record), 1, size, input.file) != size) {
+		fclose(input.file);
+		input.file = NULL;
+		return VEE_IO_ERROR;
+	}
+	input.mode = INPUT_RECORDING;
+	input.last = (InputFrame){0};
+	return VEE_OK;
+}
+
+//everything but the gui values, those are added by InputEndFrame()
+static void RecordFrame(const InputFrame* f, const InputFrame* last) {
+	uint8_t flags = 0;
+	input.record.size = 0;
+	Put(&flags, 1);
+	if(f->mouse.x != last->mouse.x || f->mouse.y != last->mouse.y) {
+		flags |= INPUT_MOUSE;
+		PutF32(f->mouse.x);
+		PutF32(f->mouse.y);
+	}
+	if(f->down != last->down || f->pressed != 0 || f->released != 0) {
+		flags |= INPUT_BUTTONS;
+		Put(&f->down, 1);
+		Put(&f->pressed, 1);
+		Put(&f->released, 1);
+	}
+	if(f->keysDown != last->keysDown) {
+		flags |= INPUT_KEYS_DOWN;
+		PutU32(f->keysDown);
+	}
+	if(f->keysPressed != 0) {
+		flags |= INPUT_KEYS_PRESSED;
+		PutU32(f->keysPressed);
+	}
+	if(f->droppedCount > 0) {
+		flags |= INPUT_DROP;
+		PutU16(f->droppedCount);
+		for(int i=0; i<f->droppedCount; ++i) {
+			size_t n = strlen(f->dropped[i]);
+			PutU16(n);
+			Put(f->dropped[i], n);
+		}
+	}
+	if(f->wheel != 0) {
+		flags |= INPUT_WHEEL;
+		PutU16((int16_t)f->wheel);
+	}
+	if(Array_size(&input.record) > 0) Array_at(&input.record, 0) = flags;
+}
+
+
+// -------
+// REPLAYING
+// -------
+
+int InputReplay(const char* trace, ArrayWidget* w, ArrayDepthRank* depth, StringTable* strings) {
+	InputClose();
+	FILE* f = fopen(trace, "rb");
+	if(f == NULL) return VEE_IO_ERROR;
+	long size = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+	int r = VEE_OK;
+	if(size < 0 || fseek(f, 0, SEEK_SET) != 0) r = VEE_IO_ERROR;
+	else if(Array_reserve_exact(&input.trace, size) != VEE_OK) r = VEE_OUT_OF_MEMORY;
+	else if(fread(Array_data(&input.trace), 1, size, f) != (size_t)size) r = VEE_IO_ERROR;
+	fclose(f);
+	if(r != VEE_OK) return r;
+	input.trace.size = size;
+
+	const uint8_t* p = Array_data(&input.trace);
+	if(size < INPUT_TRACE_HEADER_SIZE || memcmp(p, INPUT_TRACE_MAGIC, 4) != 0 || get_u16le(p+4) < 1 ||
+		get_u16le(p+4) > INPUT_TRACE_VERSION || get_u16le(p+6) > 32) return VEE_BAD_FORMAT;
+	bool props = get_u16le(p+4) >= 2;
+	size_t recordSize = props ? INPUT_TRACE_WIDGET_SIZE : INPUT_TRACE_V1_WIDGET_SIZE;
+	input.traceKeys = get_u16le(p+6);
+	size_t count = get_u32le(p+8);
+	size_t widgets = INPUT_TRACE_HEADER_SIZE + input.traceKeys*2;
+	if((size_t)size < widgets + count*recordSize) return VEE_BAD_FORMAT;
+	size_t frames = widgets + count*recordSize;
+	if(props) {
+		if((size_t)size < frames + 4 || (size_t)size - frames - 4 < get_u32le(p + frames)) return VEE_BAD_FORMAT;
+		size_t n = get_u32le(p + frames);
+		if(StringTableLoad(strings, (const char*)p + frames + 4, n, NULL) < 0) return VEE_BAD_FORMAT;
+		frames += 4 + n;
+	}
+
+	for(int i=0; i<input.traceKeys; ++i) input.keyMap[i] = KeyIndex(get_u16le(p + INPUT_TRACE_HEADER_SIZE + i*2));
+
+	size_t n = Array_size(w);
+	if(Array_reserve(w, n+count) != VEE_OK || Array_reserve(depth, Array_size(depth)+count) != VEE_OK)
+		return VEE_OUT_OF_MEMORY;
+	for(size_t i=0; i<count; ++i) {
+		const uint8_t* rec = p + widgets + i*recordSize;
+		Widget widget = { get_u16le(rec), { get_f32le(rec+10), get_f32le(rec+14), get_f32le(rec+18), get_f32le(rec+22) }, get_u32le(rec+2) };
+		if(props) widget.props = GetWidgetProps(rec+28, get_u16le(rec+26));
+		if(widget.type >= WIDGET_COUNT || !WidgetPropsValid(widget.props, strings)) return VEE_BAD_FORMAT;
+		Array_at(w, n+i) = widget;
+		Array_at(depth, Array_size(depth)+i) = get_u32le(rec+6);
+	}
+	w->size += count;
+	depth->size += count;
+
+	input.at = frames;
+	input.mode = INPUT_REPLAYING;
+	input.last = (InputFrame){0};
+	return VEE_OK;
+}
+
+//map the key bits of the trace to the ones of InputKeys
+static inline uint32_t MapKeys(uint32_t bits) {
+	uint32_t keys = 0;
+	for(; bits != 0; bits &= bits-1) {
+		int k = input.keyMap[__builtin_ctz(bits)];
+		if(k != -1) keys |= (uint32_t)1 << k;
+	}
+	return keys;
+}
+
+//Decode the next frame on top of `last`, returns false at the end of the trace
+static bool ReplayFrame(InputFrame* f) {
+	const uint8_t* p = &Array_at(&input.trace, input.at);
+	const uint8_t* end = Array_data(&input.trace) + Array_size(&input.trace);
+	#define NEED(n) if((size_t)(end - p) < (size_t)(n)) return false
+
+	NEED(1);
+	uint8_t flags = *p++;
+	f->mouse = input.last.mouse;
+	f->down = input.last.down;
+	f->keysDown = input.last.keysDown;
+	if(flags & INPUT_MOUSE) {
+		NEED(8);
+		f->mouse = (Vector2){ get_f32le(p), get_f32le(p+4) };
+		p += 8;
+	}
+	if(flags & INPUT_BUTTONS) {
+		NEED(3);
+		f->down = p[0]; f->pressed = p[1]; f->released = p[2];
+		p += 3;
+	}
+	if(flags & INPUT_KEYS_DOWN) {
+		NEED(4);
+		f->keysDown = MapKeys(get_u32le(p));
+		p += 4;
+	}
+	if(flags & INPUT_KEYS_PRESSED) {
+		NEED(4);
+		f->keysPressed = MapKeys(get_u32le(p));
+		p += 4;
+	}
+	if(flags & INPUT_DROP) {
+		NEED(2);
+		int count = get_u16le(p);
+		p += 2;
+		input.names.size = 0;
+		for(int i=0; i<count; ++i) {
+			NEED(2);
+			size_t n = get_u16le(p);
+			NEED(2+n);
+			if(Array_reserve(&input.names, Array_size(&input.names)+n+1) != VEE_OK) return false;
+			memcpy(&Array_at(&input.names, Array_size(&input.names)), p+2, n);
+			Array_at(&input.names, Array_size(&input.names)+n) = '\0';
+			input.names.size += n+1;
+			p += 2+n;
+		}
+		//the names don't move anymore
+		if(Array_reserve(&input.dropped, count) != VEE_OK) return false;
+		char* name = Array_data(&input.names);
+		for(int i=0; i<count; ++i, name += strlen(name)+1) Array_at(&input.dropped, i) = name;
+		f->dropped = Array_data(&input.dropped);
+		f->droppedCount = count;
+	}
+	if(flags & INPUT_WHEEL) {
+		NEED(2);
+		f->wheel = (int16_t)get_u16le(p);
+		p += 2;
+	}
+	if(flags & INPUT_GUI) {
+		NEED(1);
+		f->guiCount = *p++;
+		NEED(f->guiCount*4);
+		if(f->guiCount > INPUT_MAX_GUI_VALUES) return false;
+		for(int i=0; i<f->guiCount; ++i) f->gui[i] = (int32_t)get_u32le(p + i*4);
+		p += f->guiCount*4;
+	}
+	if(flags & INPUT_GUI_TEXT) {
+		NEED(2);
+		size_t n = get_u16le(p);
+		NEED(2+n);
+		if(Array_reserve(&input.text, n+1) != VEE_OK) return false;
+		memcpy(Array_data(&input.text), p+2, n);
+		Array_at(&input.text, n) = '\0';
+		input.text.size = n+1;
+		f->guiText = true;
+		p += 2+n;
+	}
+	#undef NEED
+
+	input.at = p - Array_data(&input.trace);
+	return true;
+}
+
+
+// -------
+// FRAMES
+// -------
+
+void InputClose() {
+	if(input.file != NULL) fclose(input.file);
+	input.file = NULL;
+	Array_destroy(&input.record);
+	Array_destroy(&input.trace);
+	Array_destroy(&input.names);
+	Array_destroy(&input.dropped);
+	Array_destroy(&input.text);
+	input.mode = INPUT_LIVE;
+	input.at = 0;
+	input.frame = input.last = (InputFrame){0};
+}
+
+static void PollFrame(InputFrame* f) {
+	f->mouse = GetMousePosition();
+	f->wheel = GetMouseWheelMove();
+	for(int b=0; b<INPUT_BUTTON_COUNT; ++b) {
+		if(IsMouseButtonDown(b)) f->down |= 1 << b;
+		if(IsMouseButtonPressed(b)) f->pressed |= 1 << b;
+		if(IsMouseButtonReleased(b)) f->released |= 1 << b;
+	}
+	for(int i=0; i<INPUT_KEY_COUNT; ++i) {
+		if(IsKeyDown(InputKeys[i])) f->keysDown |= (uint32_t)1 << i;
+		if(IsKeyPressed(InputKeys[i])) f->keysPressed |= (uint32_t)1 << i;
+	}
+	if(IsFileDropped()) f->dropped = GetDroppedFiles(&f->droppedCount);
+}
+
+bool InputBeginFrame() {
+	InputFrame f = {0};
+	if(input.mode == INPUT_REPLAYING) {
+		if(!ReplayFrame(&f)) return false;
+	} else {
+		PollFrame(&f);
+		if(input.mode == INPUT_RECORDING) RecordFrame(&f, &input.last);
+	}
+	input.frame = f;
+	return true;
+}
+
+void InputEndFrame() {
+	InputFrame* f = &input.frame;
+	if(input.mode == INPUT_RECORDING) {
+		if(f->guiCount > 0) {
+			uint8_t n = f->guiCount;
+			Array_at(&input.record, 0) |= INPUT_GUI;
+			Put(&n, 1);
+			for(int i=0; i<f->guiCount; ++i) PutU32(f->gui[i]);
+		}
+		if(f->guiText) {
+			Array_at(&input.record, 0) |= INPUT_GUI_TEXT;
+			PutU16(Array_size(&input.text)-1);
+			Put(Array_data(&input.text), Array_size(&input.text)-1);
+		}
+		if(fwrite(Array_data(&input.record), 1, Array_size(&input.record), input.file) != Array_size(&input.record)) {
+			TraceLog(LOG_WARNING, "Failed to write the input trace, recording stopped");
+			InputClose();
+		}
+	}
+	//the dropped files belong to raylib or to the frame being replayed
+	f->dropped = NULL;
+	f->droppedCount = 0;
+	f->guiText = false;
+	input.last = *f;
+}
+
+Vector2 InputMousePosition() {
+	return input.frame.mouse;
+}
+
+bool InputMouseButtonPressed(int button) {
+	return (input.frame.pressed >> button) & 1;
+}
+
+bool InputMouseButtonDown(int button) {
+	return (input.frame.down >> button) & 1;
+}
+
+bool InputMouseButtonReleased(int button) {
+	return (input.frame.released >> button) & 1;
+}
+
+int InputMouseWheelMove() {
+	return input.frame.wheel;
+}
+
+bool InputKeyPressed(int key) {
+	int k = KeyIndex(key);
+	return k != -1 && ((input.frame.keysPressed >> k) & 1);
+}
+
+bool InputKeyDown(int key) {
+	int k = KeyIndex(key);
+	return k != -1 && ((input.frame.keysDown >> k) & 1);
+}
+
+bool InputMouseMoved() {
+	const InputFrame *f = &input.frame, *l = &input.last;
+	return f->mouse.x != l->mouse.x || f->mouse.y != l->mouse.y;
+}
+
+bool InputChanged() {
+	const InputFrame *f = &input.frame, *l = &input.last;
+	return f->pressed != 0 || f->released != 0 || f->wheel != 0 || f->keysPressed != 0 || f->droppedCount > 0 ||
+		f->down != l->down || f->keysDown != l->keysDown || (f->down != 0 && InputMouseMoved());
+}
+
+bool InputFileDropped() {
+	return input.frame.droppedCount > 0;
+}
+
+char** InputDroppedFiles(int* count) {
+	*count = input.frame.droppedCount;
+	return input.frame.dropped;
+}
+
+void InputClearDroppedFiles() {
+	if(input.mode != INPUT_REPLAYING) ClearDroppedFiles();
+	input.frame.dropped = NULL;
+	input.frame.droppedCount = 0;
+}
+
+void InputGuiValue(int* value) {
+	InputFrame* f = &input.frame;
+	if(input.mode == INPUT_REPLAYING) {
+		if(f->guiNext < f->guiCount) *value = f->gui[f->guiNext++];
+	}
+	else if(f->guiCount < INPUT_MAX_GUI_VALUES) f->gui[f->guiCount++] = *value;
+}
+
+void InputGuiText(char* text, int size) {
+	InputFrame* f = &input.frame;
+	if(input.mode == INPUT_REPLAYING) {
+		if(!f->guiText || size <= 0) return;
+		size_t n = Array_size(&input.text)-1;
+		if(n > (size_t)size-1) n = size-1;
+		memcpy(text, Array_data(&input.text), n);
+		text[n] = '\0';
+		f->guiText = false;
+	}
+	else if(!f->guiText && input.mode == INPUT_RECORDING) {
+		size_t n = strnlen(text, size);
+		if(n > UINT16_MAX) n = UINT16_MAX;
+		if(Array_reserve(&input.text, n+1) != VEE_OK) return;
+		memcpy(Array_data(&input.text), text, n);
+		Array_at(&input.text, n) = '\0';
+		input.text.size = n+1;
+		f->guiText = true;
+	}
+}
@@ -0,0 +1,97 @@
+#ifndef GE_INPUT_H
+#define GE_INPUT_H
+
+#include "editor.h"
+#include "depth.h"
+
+/* INPUT
+ * The editor reads its input from here instead of from raylib. Every frame starts with
+ * InputBeginFrame(), which either polls raylib (and records what it saw when a trace is
+ * being recorded) or takes the next frame from a trace being replayed, and ends with
+ * InputEndFrame(). A replay needs no window and runs as fast as the editor can go.
+ *
+ * Only the keys in the table in input.c are tracked, a key missing from it is never down.
+ * Values that come from raygui controls (which read raylib directly) go through
+ * InputGuiValue() and InputGuiText() so a replay gets them without drawing anything.
+ *
+ * TRACE FILE LAYOUT
+ * All the fields are little-endian.
+ *
+ *   offset  size  field
+ *        0     4  magic "GEIT"
+ *        4     2  version
+ *        6     2  number of tracked keys (32 at most)
+ *        8     4  widget count
+ *       12        raylib key code of every tracked key (2 each), bit `i` of the key fields
+ *                 of the frames is key `i`
+ *                 widget records, the layout the session started from
+ *                 string table size (4) and the string table of the widgets
+ *                 frame records until the end of the file
+ *
+ * A widget record is 52 bytes: type (2), id (4), depth rank (4), bounds x, y, width and
+ * height as floats (16), property flags (2) and the properties (24) like in a `.ui` file
+ * (see uifile.h). Version 1 traces have 26 byte records without the properties and no
+ * string table.
+ *
+ * A frame record starts with a byte of InputFrameFlags and has the fields of the flags
+ * that are set, in the order of the flags except for the gui values and text, which
+ * always come last. Whatever isn't there is the same as in the frame before (mouse, buttons and keys
+ * down) or empty (presses, wheel, drops, gui values), so a frame without input is a
+ * single byte. A torn record at the end of the file is ignored. */
+
+#define INPUT_TRACE_MAGIC "GEIT"
+#define INPUT_TRACE_VERSION 2
+#define INPUT_TRACE_HEADER_SIZE 12
+#define INPUT_TRACE_WIDGET_SIZE 52
+#define INPUT_TRACE_V1_WIDGET_SIZE 26
+
+typedef enum {
+	INPUT_MOUSE         = 1 << 0,  //mouse x, y as floats (8)
+	INPUT_BUTTONS       = 1 << 1,  //mouse buttons down, pressed, released (1 each, bit per button)
+	INPUT_KEYS_DOWN     = 1 << 2,  //bit per tracked key (4)
+	INPUT_KEYS_PRESSED  = 1 << 3,  //bit per tracked key (4)
+	INPUT_DROP          = 1 << 4,  //file count (2), then length (2) and path for each file
+	INPUT_GUI           = 1 << 5,  //value count (1), then the values (4 each)
+	INPUT_WHEEL         = 1 << 6,  //mouse wheel move (2, signed)
+	INPUT_GUI_TEXT      = 1 << 7,  //length (2) and text, after the gui values
+} InputFrameFlags;
+
+#define INPUT_MAX_GUI_VALUES 16
+
+/** Start writing every frame to `trace`. The trace starts from the widgets `w` in the depth
+ * order `d` with their strings in `strings`. Returns VEE_OK[0] on success. */
+extern int InputRecord(const char* trace, const ArrayWidget* w, const DepthOrder* d, const StringTable* strings);
+/** Take the input from `trace` instead of raylib. The widgets the session started from are
+ * added to `w` and their depth ranks to `depth`, their strings to `strings`, which has to be
+ * empty so the handles stay the same. Returns VEE_OK[0] on success. */
+extern int InputReplay(const char* trace, ArrayWidget* w, ArrayDepthRank* depth, StringTable* strings);
+/** Stop recording or replaying. */
+extern void InputClose();
+
+/** Returns false when a replay has no frames left. */
+extern bool InputBeginFrame();
+extern void InputEndFrame();
+
+extern Vector2 InputMousePosition();
+extern bool InputMouseButtonPressed(int button);
+extern bool InputMouseButtonDown(int button);
+extern bool InputMouseButtonReleased(int button);
+extern int InputMouseWheelMove();
+extern bool InputKeyPressed(int key);
+extern bool InputKeyDown(int key);
+/** True when the mouse moved since the last frame. */
+extern bool InputMouseMoved();
+/** True when there is input this frame that the editor could react to: a button or key that
+ * was pressed, released or let go, the wheel, a drop or the mouse moving while a button is
+ * down. The mouse moving alone doesn't count, see InputMouseMoved(). */
+extern bool InputChanged();
+extern bool InputFileDropped();
+extern char** InputDroppedFiles(int* count);
+extern void InputClearDroppedFiles();
+
+/** Record `*value`, set by a raygui control this frame, or replace it with the recorded one. */
+extern void InputGuiValue(int* value);
+/** Same for the text of a raygui text box (`size` bytes with the `\0`), at most one per frame. */
+extern void InputGuiText(char* text, int size);
+
+#endif
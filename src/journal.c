@@ -0,0 +1,517 @@
+#include "journal.h"
+#include "uifile.h"
+#include "codegen.h"
+#include "profile.h"
+#include <math.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h> //for fsync()
+
+typedef struct {
+	JournalOp op;           //used when `snapshot` is NULL
+	char* text;             //of a JOURNAL_STRING, `op.below` bytes
+	ArrayWidget* snapshot;  //copy of the widgets owned by the writer thread
+	const ArrayWidget* shared; //widgets to copy on the writer thread, see JournalSnapshotShared()
+	const DepthOrder* sharedOrder;
+	const StringTable* sharedStrings;
+	ArrayDepthRank depth;   //depth ranks of the snapshot widgets
+	ArrayStringText strings;//copy of the string table of the snapshot
+	bool exportCode;
+	CodeStyle style;        //of the exported code
+} JournalItem;
+
+typedef Array(JournalItem) ArrayJournalItem;
+typedef Array(uint8_t) ArrayByte;
+
+static struct {
+	char project[1024];
+	char journal[1024];
+
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t taken;   //the copy of a shared snapshot was taken
+	ArrayJournalItem queue; //guarded by `lock`
+	bool quit;              //guarded by `lock`
+	bool sharing;           //guarded by `lock`, a shared snapshot wasn't copied yet
+	bool running;
+
+	int opsSinceSnapshot;   //main thread only
+	StringTable* strings;   //main thread only, of the widgets replayed by JournalOpen()
+
+	FILE* file;             //writer thread only, opened on the first write after a snapshot
+	bool unsynced;          //writer thread only, `file` has edits that weren't synced yet
+	struct timespec synced; //writer thread only, when `file` was synced last (CLOCK_REALTIME)
+	uint32_t checksum;      //checksum of the current snapshot (writer thread only after JournalOpen())
+} journal = { .lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER, .taken = PTHREAD_COND_INITIALIZER };
+
+
+// -------
+// RECORDS
+// -------
+
+static void EncodeOp(uint8_t* p, JournalOp op) {
+	put_u16le(p, op.op);
+	put_u16le(p+2, op.widget.type);
+	put_u32le(p+4, op.index);
+	put_u32le(p+8, (uint32_t)op.below);
+	put_u32le(p+12, op.widget.id);
+	put_f32le(p+16, op.widget.bounds.x);
+	put_f32le(p+20, op.widget.bounds.y);
+	put_f32le(p+24, op.widget.bounds.width);
+	put_f32le(p+28, op.widget.bounds.height);
+	put_u16le(p+32, op.widget.props.set);
+	put_u16le(p+34, 0);
+	PutWidgetProps(p+36, op.widget.props);
+	put_u32le(p+60, fnv32_1a((char*)p, 60));
+}
+
+static void EncodeString(uint8_t* p, const JournalItem* it) {
+	memset(p, 0, JOURNAL_RECORD_SIZE);
+	put_u16le(p, JOURNAL_STRING);
+	put_u32le(p+4, it->op.index);
+	put_u32le(p+8, (uint32_t)it->op.below);
+	put_u32le(p+12, fnv32_1a(it->text, it->op.below));
+	put_u32le(p+60, fnv32_1a((char*)p, 60));
+	memcpy(p+JOURNAL_RECORD_SIZE, it->text, it->op.below);
+}
+
+//Read the string of the JOURNAL_STRING record `p` from `f` and add it to `t`, where it has to
+//get the handle it had when it was recorded
+static bool ReplayString(const uint8_t* p, FILE* f, StringTable* t) {
+	if(fnv32_1a((char*)p, 60) != get_u32le(p+60)) return false;
+	uint32_t handle = get_u32le(p+4), length = get_u32le(p+8);
+	char* text = malloc(length + 1);
+	if(text == NULL || fread(text, 1, length, f) != length || fnv32_1a(text, length) != get_u32le(p+12) ||
+		memchr(text, '\0', length) != NULL || handle != StringTableSize(t))
+	{
+		free(text);
+		return false;
+	}
+	StringHandle h;
+	bool added = StringInternN(t, text, length, &h) == VEE_OK && h == handle;
+	free(text);
+	return added;
+}
+
+//`size` is JOURNAL_RECORD_SIZE or JOURNAL_V2_RECORD_SIZE, the strings have to be in `t`
+static bool DecodeOp(const uint8_t* p, size_t size, const StringTable* t, JournalOp* op) {
+	if(fnv32_1a((char*)p, size-4) != get_u32le(p+size-4)) return false;
+	bool props = size == JOURNAL_RECORD_SIZE;
+	*op = (JournalOp) {
+		get_u16le(p), get_u32le(p+4), (int32_t)get_u32le(p+8),
+		{ get_u16le(p+2), { get_f32le(p+16), get_f32le(p+20), get_f32le(p+24), get_f32le(p+28) }, get_u32le(p+12),
+			props ? GetWidgetProps(p+36, get_u16le(p+32)) : (WidgetProps){0} }
+	};
+	Rectangle b = op->widget.bounds;
+	return op->op >= JOURNAL_INSERT && op->op < JOURNAL_OP_COUNT && op->widget.type < WIDGET_COUNT &&
+		op->widget.id >= 0 && isfinite(b.x) && isfinite(b.y) && isfinite(b.width) && isfinite(b.height) &&
+		WidgetPropsValid(op->widget.props, t);
+}
+
+bool JournalApply(ArrayWidget* w, DepthOrder* d, JournalOp op) {
+	size_t n = Array_size(w);
+	switch(op.op) {
+		case JOURNAL_INSERT:
+			//`below` counts the widget moved out of the way to the end
+			if(op.index > n || op.below < DEPTH_NONE || op.below > (int64_t)n || op.below == (int64_t)op.index || 
+				(op.below == (int64_t)n && op.index == n)) return false;
+			if(WidgetSwapInsert(w, op.index, op.widget) != VEE_OK) return false;
+			if(DepthOrderSwapInsert(d, op.index, op.below) != VEE_OK) {
+				WidgetSwapRemove(w, op.index);
+				return false;
+			}
+			return true;
+		case JOURNAL_REMOVE:
+			if(op.index >= n) return false;
+			WidgetSwapRemove(w, op.index);
+			DepthOrderSwapRemove(d, op.index);
+			return true;
+		case JOURNAL_SET:
+			if(op.index >= n) return false;
+			Array_at(w, op.index) = op.widget;
+			return true;
+		case JOURNAL_MOVE:
+			if(op.index >= n || op.below < DEPTH_NONE || op.below >= (int64_t)n) return false;
+			DepthOrderMove(d, op.index, op.below);
+			return true;
+		default:
+			return false;
+	}
+}
+
+//Apply the journal on top of `w` and `d`. `stale` is set when the journal doesn't match the snapshot
+//or couldn't be replayed completely, in both cases it should be replaced by a new snapshot.
+static int Replay(ArrayWidget* w, DepthOrder* d, bool* stale) {
+	*stale = false;
+	FILE* f = fopen(journal.journal, "rb");
+	if(f == NULL) return 0;
+
+	int applied = 0;
+	uint8_t rec[JOURNAL_RECORD_SIZE];
+	bool header = fread(rec, 1, JOURNAL_HEADER_SIZE, f) == JOURNAL_HEADER_SIZE;
+	bool v2 = header && memcmp(rec, JOURNAL_V2_MAGIC, 4) == 0;
+	if(!header || (memcmp(rec, JOURNAL_MAGIC, 4) != 0 && !v2) || get_u32le(rec+4) != journal.checksum) {
+		*stale = true;
+		fclose(f);
+		return 0;
+	}
+
+	size_t n, size = v2 ? JOURNAL_V2_RECORD_SIZE : JOURNAL_RECORD_SIZE;
+	JournalOp op;
+	while((n = fread(rec, 1, size, f)) == size) {
+		if(!v2 && get_u16le(rec) == JOURNAL_STRING) {
+			if(!ReplayString(rec, f, journal.strings)) {
+				*stale = true;
+				n = 0;
+				break;
+			}
+			continue;
+		}
+		if(!DecodeOp(rec, size, journal.strings, &op) || !JournalApply(w, d, op)) {
+			*stale = true;
+			break;
+		}
+		++applied;
+	}
+	if(n != 0) *stale = true; //torn write at the end
+	fclose(f);
+	return applied;
+}
+
+
+// -------
+// WRITER THREAD
+// -------
+
+static void WriteOps(const JournalItem* items, size_t count, ArrayByte* buf) {
+	PROFILE_ZONE("WriteJournal");
+	buf->size = 0;
+	size_t bytes = count*JOURNAL_RECORD_SIZE;
+	for(size_t i=0; i<count; ++i) if(items[i].text != NULL) bytes += items[i].op.below;
+	if(Array_reserve(buf, bytes) != VEE_OK) {
+		TraceLog(LOG_WARNING, "Out of memory, autosave skipped some edits");
+		return;
+	}
+	for(size_t i=0; i<count; ++i) {
+		JournalOp op = items[i].op;
+		if(items[i].text != NULL) {
+			EncodeString(Array_data(buf) + Array_size(buf), &items[i]);
+			buf->size += JOURNAL_RECORD_SIZE + op.below;
+			continue;
+		}
+		//a drag sets the same widget every frame, only the last one matters
+		if(op.op == JOURNAL_SET && i+1 < count && items[i+1].op.op == JOURNAL_SET && items[i+1].op.index == op.index)
+			continue;
+		EncodeOp(Array_data(buf) + Array_size(buf), op);
+		buf->size += JOURNAL_RECORD_SIZE;
+	}
+
+	if(journal.file == NULL) {
+		journal.file = fopen(journal.journal, "wb");
+		if(journal.file == NULL) {
+			TraceLog(LOG_WARNING, "Failed to open autosave journal `%s`", journal.journal);
+			return;
+		}
+		uint8_t header[JOURNAL_HEADER_SIZE];
+		memcpy(header, JOURNAL_MAGIC, 4);
+		put_u32le(header+4, journal.checksum);
+		fwrite(header, 1, sizeof(header), journal.file);
+	}
+	fwrite(Array_data(buf), 1, Array_size(buf), journal.file);
+	fflush(journal.file);
+	journal.unsynced = true;
+}
+
+//a drag writes every frame, syncing each batch would keep the writer in fsync()
+static void Sync() {
+	if(journal.file != NULL && journal.unsynced) {
+		PROFILE_ZONE("SyncJournal");
+		fsync(fileno(journal.file));
+	}
+	journal.unsynced = false;
+	clock_gettime(CLOCK_REALTIME, &journal.synced);
+}
+
+static struct timespec SyncDue() {
+	struct timespec t = journal.synced;
+	t.tv_sec += JOURNAL_SYNC_MS/1000;
+	t.tv_nsec += (JOURNAL_SYNC_MS%1000)*1000000L;
+	if(t.tv_nsec >= 1000000000L) { t.tv_sec += 1; t.tv_nsec -= 1000000000L; }
+	return t;
+}
+
+static bool SyncIsDue() {
+	struct timespec now, due = SyncDue();
+	clock_gettime(CLOCK_REALTIME, &now);
+	return now.tv_sec > due.tv_sec || (now.tv_sec == due.tv_sec && now.tv_nsec >= due.tv_nsec);
+}
+
+//write to a temporary file first so a crash never leaves a half written file behind
+static bool ReplaceFile(const char* tmp, const char* path) {
+#ifdef _WIN32
+	remove(path);
+#endif
+	return rename(tmp, path) == 0;
+}
+
+//TextFormat() isn't safe to use from here, it shares one buffer with the editor
+static void WriteSnapshot(ArrayWidget* w, const uint32_t* depth, const ArrayStringText* strings, bool exportCode, CodeStyle style) {
+	PROFILE_ZONE("WriteSnapshot");
+	char tmp[1040];
+	snprintf(tmp, sizeof(tmp), "%s.tmp", journal.project);
+	if(WriteUIFile(tmp, w, depth, Array_data(strings), Array_size(strings)) == VEE_OK && ReplaceFile(tmp, journal.project)) {
+		ReadUIFileChecksum(journal.project, &journal.checksum);
+		//everything in the journal is part of the snapshot now
+		if(journal.file != NULL) fclose(journal.file);
+		journal.file = NULL;
+		journal.unsynced = false;
+		remove(journal.journal);
+	} else {
+		remove(tmp);
+		TraceLog(LOG_WARNING, "Failed to save UI to file `%s`", journal.project);
+	}
+
+	if(exportCode) {
+		char cfile[1040], ctmp[1040];
+		snprintf(cfile, sizeof(cfile), "%s.c", journal.project);
+		snprintf(ctmp, sizeof(ctmp), "%s.c.tmp", journal.project);
+		//the code draws the widgets in depth order, the widgets aren't needed in slot order anymore
+		ArrayWidget ordered = {0};
+		if(Array_reserve_exact(&ordered, Array_size(w)) == VEE_OK) {
+			for(ArrayIt i=0; i<Array_size(w); ++i) Array_at(&ordered, depth[i]) = Array_at(w, i);
+			ordered.size = Array_size(w);
+		}
+		//only looked up, the copy of the strings needs no hash table
+		const StringTable t = { .text = *strings };
+		if(Array_size(&ordered) == Array_size(w) && ExportCode(ctmp, &ordered, &t, style) == VEE_OK && ReplaceFile(ctmp, cfile)) {
+			TraceLog(LOG_INFO, "UI saved to `%s` and `%s`", journal.project, cfile);
+		} else {
+			remove(ctmp);
+			TraceLog(LOG_WARNING, "Failed to save UI to file `%s`", cfile);
+		}
+		Array_destroy(&ordered);
+	}
+}
+
+//Copy `w`, `d` and `t` to the snapshot `it`. Returns false when memory ran out.
+static bool CopySnapshot(const ArrayWidget* w, const DepthOrder* d, const StringTable* t, JournalItem* it) {
+	PROFILE_ZONE("CopySnapshot");
+	ArrayWidget* copy = malloc(sizeof(ArrayWidget));
+	ArrayDepthRank depth = {0};
+	ArrayStringText strings = {0};
+	if(copy != NULL) *copy = (ArrayWidget){0};
+	if(copy == NULL || Array_reserve_exact(copy, Array_size(w)) != VEE_OK || DepthOrderRanks(d, &depth) != VEE_OK ||
+		Array_reserve_exact(&strings, StringTableSize(t)) != VEE_OK)
+	{
+		if(copy != NULL) Array_destroy(copy);
+		free(copy);
+		Array_destroy(&depth);
+		TraceLog(LOG_WARNING, "Out of memory, failed to take a snapshot");
+		return false;
+	}
+	memcpy(Array_data(copy), Array_data(w), Array_size(w)*sizeof(Widget));
+	copy->size = Array_size(w);
+	memcpy(Array_data(&strings), StringTableData(t), StringTableSize(t));
+	strings.size = StringTableSize(t);
+	it->snapshot = copy;
+	it->depth = depth;
+	it->strings = strings;
+	return true;
+}
+
+static void* JournalThread(void* arg) {
+	ArrayByte buf = {0};
+	clock_gettime(CLOCK_REALTIME, &journal.synced);
+	pthread_mutex_lock(&journal.lock);
+	for(;;) {
+		while(Array_size(&journal.queue) == 0 && !journal.quit) {
+			if(!journal.unsynced) {
+				pthread_cond_wait(&journal.wake, &journal.lock);
+				continue;
+			}
+			//the edits written last are synced once the editor leaves the journal alone for a while
+			struct timespec due = SyncDue();
+			if(pthread_cond_timedwait(&journal.wake, &journal.lock, &due) == ETIMEDOUT) {
+				pthread_mutex_unlock(&journal.lock);
+				Sync();
+				pthread_mutex_lock(&journal.lock);
+			}
+		}
+		if(Array_size(&journal.queue) == 0) break; //quit and nothing left to write
+
+		//take the whole queue and let the editor keep adding to a new one
+		ArrayJournalItem items = journal.queue;
+		journal.queue = (ArrayJournalItem){0};
+		pthread_mutex_unlock(&journal.lock);
+
+		for(size_t i=0; i<Array_size(&items);) {
+			JournalItem* it = &Array_at(&items, i);
+			if(it->shared != NULL) {
+				bool copied = CopySnapshot(it->shared, it->sharedOrder, it->sharedStrings, it);
+				pthread_mutex_lock(&journal.lock);
+				journal.sharing = false;
+				pthread_cond_broadcast(&journal.taken);
+				pthread_mutex_unlock(&journal.lock);
+				it->shared = NULL;
+				if(!copied) {
+					++i;
+					continue;
+				}
+			}
+			if(it->snapshot != NULL) {
+				WriteSnapshot(it->snapshot, Array_data(&it->depth), &it->strings, it->exportCode, it->style);
+				Array_destroy(it->snapshot);
+				Array_destroy(&it->depth);
+				Array_destroy(&it->strings);
+				free(it->snapshot);
+				++i;
+				continue;
+			}
+			//write all the edits up to the next snapshot at once
+			size_t n = 1;
+			while(i+n < Array_size(&items) && Array_at(&items, i+n).snapshot == NULL && Array_at(&items, i+n).shared == NULL) ++n;
+			WriteOps(it, n, &buf);
+			for(size_t k=0; k<n; ++k) free(it[k].text);
+			i += n;
+		}
+		Array_destroy(&items);
+		if(journal.unsynced && SyncIsDue()) Sync();
+
+		pthread_mutex_lock(&journal.lock);
+	}
+	pthread_mutex_unlock(&journal.lock);
+	Sync();
+
+	Array_destroy(&buf);
+	return NULL;
+}
+
+static void Enqueue(JournalItem item) {
+	pthread_mutex_lock(&journal.lock);
+	if(Array_push(&journal.queue, item) != VEE_OK) {
+		TraceLog(LOG_WARNING, "Out of memory, autosave skipped an edit");
+		if(item.shared != NULL) journal.sharing = false;
+		if(item.snapshot != NULL) {
+			Array_destroy(item.snapshot);
+			Array_destroy(&item.depth);
+			Array_destroy(&item.strings);
+			free(item.snapshot);
+		}
+		free(item.text);
+	}
+	pthread_cond_signal(&journal.wake);
+	pthread_mutex_unlock(&journal.lock);
+}
+
+
+// -------
+// EDITOR SIDE
+// -------
+
+int JournalOpen(const char* project, ArrayWidget* w, DepthOrder* d, StringTable* strings) {
+	snprintf(journal.project, sizeof(journal.project), "%s", project);
+	snprintf(journal.journal, sizeof(journal.journal), "%s.journal", project);
+
+	bool stale = false;
+	ArrayDepthRank depth = {0};
+	int loaded = ReadUIFile(project, w, Array_size(w), &depth, strings);
+	if(loaded >= 0 && DepthOrderAppend(d, loaded, Array_data(&depth), d->top) != VEE_OK) {
+		Array_remove(w, Array_size(w)-loaded, loaded);
+		loaded = VEE_OUT_OF_MEMORY;
+	}
+	Array_destroy(&depth);
+	if(loaded >= 0) {
+		//snapshots from older editors have no checksum, they get rewritten below
+		if(ReadUIFileChecksum(project, &journal.checksum) != VEE_OK) stale = true;
+	} else {
+		if(loaded != VEE_IO_ERROR) TraceLog(LOG_WARNING, TextFormat("Failed to load UI from file `%s`", project));
+		loaded = 0;
+	}
+
+	bool staleJournal = false;
+	journal.strings = strings;
+	int applied = Replay(w, d, &staleJournal);
+	if(applied > 0) TraceLog(LOG_INFO, TextFormat("Recovered %i edits from `%s`", applied, journal.journal));
+
+	if(pthread_create(&journal.thread, NULL, JournalThread, NULL) != 0) {
+		TraceLog(LOG_WARNING, "Failed to start the autosave thread, autosave is disabled");
+		return Array_size(w);
+	}
+	journal.running = true;
+
+	//start over from a clean snapshot and an empty journal
+	if(stale || staleJournal || applied > 0) JournalSnapshot(w, d, strings);
+	return Array_size(w);
+}
+
+void JournalClose() {
+	if(!journal.running) return;
+	pthread_mutex_lock(&journal.lock);
+	journal.quit = true;
+	pthread_cond_signal(&journal.wake);
+	pthread_mutex_unlock(&journal.lock);
+	pthread_join(journal.thread, NULL);
+	journal.running = false;
+
+	if(journal.file != NULL) fclose(journal.file);
+	journal.file = NULL;
+	Array_destroy(&journal.queue);
+}
+
+void JournalRecord(JournalOp op) {
+	if(!journal.running) return;
+	Enqueue((JournalItem){ .op = op });
+	++journal.opsSinceSnapshot;
+}
+
+void JournalString(const char* s, StringHandle h) {
+	if(!journal.running) return;
+	size_t n = strlen(s);
+	char* text = malloc(n + 1);
+	if(text == NULL) {
+		TraceLog(LOG_WARNING, "Out of memory, autosave skipped a string");
+		return;
+	}
+	memcpy(text, s, n);
+	Enqueue((JournalItem){ .op = { JOURNAL_STRING, h, (int32_t)n }, .text = text });
+	++journal.opsSinceSnapshot;
+}
+
+static void Snapshot(const ArrayWidget* w, const DepthOrder* d, const StringTable* t, bool exportCode, CodeStyle style) {
+	if(!journal.running) return;
+	JournalItem it = { .exportCode = exportCode, .style = style };
+	if(!CopySnapshot(w, d, t, &it)) return;
+	Enqueue(it);
+	journal.opsSinceSnapshot = 0;
+}
+
+void JournalSnapshot(const ArrayWidget* w, const DepthOrder* d, const StringTable* t) {
+	Snapshot(w, d, t, false, CODE_CALLS);
+}
+
+void JournalSnapshotShared(const ArrayWidget* w, const DepthOrder* d, const StringTable* t) {
+	if(!journal.running) return;
+	pthread_mutex_lock(&journal.lock);
+	journal.sharing = true;
+	pthread_mutex_unlock(&journal.lock);
+	Enqueue((JournalItem){ .shared = w, .sharedOrder = d, .sharedStrings = t });
+	journal.opsSinceSnapshot = 0;
+}
+
+bool JournalSnapshotTaken(bool wait) {
+	pthread_mutex_lock(&journal.lock);
+	while(wait && journal.sharing) pthread_cond_wait(&journal.taken, &journal.lock);
+	bool taken = !journal.sharing;
+	pthread_mutex_unlock(&journal.lock);
+	return taken;
+}
+
+void JournalExport(const ArrayWidget* w, const DepthOrder* d, const StringTable* t, CodeStyle style) {
+	Snapshot(w, d, t, true, style);
+}
+
+bool JournalShouldCompact() {
+	return journal.opsSinceSnapshot >= JOURNAL_COMPACT_OPS;
+}
@@ -0,0 +1,97 @@
+#ifndef GE_JOURNAL_H
+#define GE_JOURNAL_H
+
+#include "editor.h"
+#include "depth.h"
+#include "codegen.h"
+
+/* AUTOSAVE JOURNAL
+ * Every edit is appended to `<project>.journal` by a background thread. From time to time
+ * the whole widget array is written to `<project>` (the snapshot) and the journal starts
+ * over. On startup the snapshot is loaded and the journal is replayed on top of it.
+ *
+ * The journal starts with a 8 byte header: magic "UIJ3" and the checksum of the snapshot
+ * it belongs to (0 if there is no snapshot), so a journal left behind by a crash during
+ * compaction is never applied twice. Then come 64 byte little-endian records:
+ *
+ *   offset  size  field
+ *        0     2  operation (JournalOpType)
+ *        2     2  widget type
+ *        4     4  index
+ *        8     4  index of the widget below (-1 for the bottom)
+ *       12     4  widget id
+ *       16    16  widget bounds x, y, width, height as floats
+ *       32     2  properties that are set (WidgetProp flags)
+ *       34     2  unused (0)
+ *       36    24  widget properties, see PutWidgetProps() in uifile.h
+ *       60     4  fnv32-1a of the bytes above
+ *
+ * The strings of the properties are handles of the string table of the snapshot and of the
+ * JOURNAL_STRING records before them. A string added during a session is recorded (with
+ * JournalString()) before the first edit that uses it: a record with the handle it got at
+ * offset 4, its length at 8 and the fnv32-1a of its bytes at 12 (the rest is 0), followed by
+ * the `length` bytes of the string without its `\0`. Replay adds the strings to the table in
+ * the same order, so they get the same handles again. Journals of version 2 ("UIJ2") have 36 byte records that
+ * end after the bounds with their checksum, the widgets get no properties.
+ *
+ * Replay stops at the first record that is torn or invalid. */
+
+#define JOURNAL_MAGIC "UIJ3"
+#define JOURNAL_V2_MAGIC "UIJ2"
+#define JOURNAL_HEADER_SIZE 8
+#define JOURNAL_RECORD_SIZE 64
+#define JOURNAL_V2_RECORD_SIZE 36
+//take a new snapshot after this many edits
+#define JOURNAL_COMPACT_OPS 4096
+//the journal is synced to disk at most this often (and when closed), a crash of the system
+//loses the edits of the last JOURNAL_SYNC_MS at most
+#define JOURNAL_SYNC_MS 1000
+
+//the widget array and the depth order are changed with WidgetSwapInsert()/WidgetSwapRemove()
+//and DepthOrderSwapInsert()/DepthOrderSwapRemove()
+typedef enum {
+	JOURNAL_INSERT = 1,  //put `widget` at `index` right above `below` (index == size to add one)
+	JOURNAL_REMOVE,      //remove widget `index`
+	JOURNAL_SET,         //replace widget `index` with `widget` (move, resize)
+	JOURNAL_MOVE,        //move widget `index` right above `below` (depth change)
+	JOURNAL_STRING,      //add a string to the table that gets handle `index`, see JournalString()
+	JOURNAL_OP_COUNT
+} JournalOpType;
+
+typedef struct {
+	JournalOpType op;
+	uint32_t index;
+	int32_t below;
+	Widget widget;
+} JournalOp;
+
+/** Loads the snapshot at `project` into `w` and `d`, replays the journal on top of it and
+ * starts the writer thread. `strings` gets the strings of the snapshot, it has to be empty so
+ * they keep the handles the journal refers to them with. Returns the number of widgets loaded. */
+extern int JournalOpen(const char* project, ArrayWidget* w, DepthOrder* d, StringTable* strings);
+/** Writes everything still queued and stops the writer thread. */
+extern void JournalClose();
+
+/** Queue an edit that was just applied to the widget array. Never blocks on disk. */
+extern void JournalRecord(JournalOp op);
+/** Queue string `s` that was just added to the table of the widgets as handle `h`, before
+ * the edits that refer to it. Never blocks on disk. */
+extern void JournalString(const char* s, StringHandle h);
+/** Queue a copy of `w`, its depth order `d` and the strings `t` it refers to, to be written
+ * as the new snapshot. The copy is the only work done on the calling thread. */
+extern void JournalSnapshot(const ArrayWidget* w, const DepthOrder* d, const StringTable* t);
+/** Same as JournalSnapshot() but the writer thread takes the copy, so the calling one doesn't
+ * wait for it. `w`, `d` and `t` can be read but must not change until JournalSnapshotTaken(). */
+extern void JournalSnapshotShared(const ArrayWidget* w, const DepthOrder* d, const StringTable* t);
+/** True once the copy of the last JournalSnapshotShared() was taken, `wait` blocks until then. */
+extern bool JournalSnapshotTaken(bool wait);
+/** Same as JournalSnapshot() but the snapshot is also exported as C code in `style`. */
+extern void JournalExport(const ArrayWidget* w, const DepthOrder* d, const StringTable* t, CodeStyle style);
+/** True once enough edits were recorded since the last snapshot. */
+extern bool JournalShouldCompact();
+
+/** Apply `op` to `w` and `d`. Returns false if the operation doesn't fit the array (or is a
+ * JOURNAL_STRING, it has no widget to change). */
+extern bool JournalApply(ArrayWidget* w, DepthOrder* d, JournalOp op);
+
+#endif
@@ -0,0 +1,225 @@
+#include "lint.h"
+#include "hierarchy.h"
+#include "widgets.h"
+#include "uifile.h"
+#include "profile.h"
+#include <math.h>
+#include <time.h>
+
+//row of the widgets in the list of tall ones, and the row every widget matches
+#define LINT_ANY_ROW INT32_MIN
+//widgets ahead of the sweep that are fetched early
+#define LINT_PREFETCH 8
+
+const char* LintKindName[LINT_KIND_COUNT] = { "overlap", "clipped", "outside", "empty", "negative" };
+
+static inline Rectangle Normalize(Rectangle r) {
+	if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+	if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+	return r;
+}
+
+static inline int Row(float y) {
+	return (int)floorf(y/LINT_ROW_HEIGHT);
+}
+
+static inline ArrayLintActive* GetBucket(LintReport* r, int row) {
+	return &r->rows[((unsigned int)row*2654435761u) & (LINT_ROW_BUCKETS-1)];
+}
+
+void LintCreate(LintReport* r, Allocator* a) {
+	*r = (LintReport){0};
+	r->issues.allocator = a;
+	r->tall.allocator = a;
+	for(int i=0; i<LINT_ROW_BUCKETS; ++i) r->rows[i].allocator = a;
+}
+
+void LintDestroy(LintReport* r) {
+	Array_destroy(&r->issues);
+	Array_destroy(&r->tall);
+	for(int i=0; i<LINT_ROW_BUCKETS; ++i) Array_destroy(&r->rows[i]);
+}
+
+static void Clear(LintReport* r) {
+	r->issues.size = 0;
+	r->tall.size = 0;
+	for(int i=0; i<LINT_ROW_BUCKETS; ++i) r->rows[i].size = 0;
+	for(int k=0; k<LINT_KIND_COUNT; ++k) r->counts[k] = 0;
+	r->truncated = false;
+}
+
+static inline void Report(LintReport* r, LintKind kind, int a, int b) {
+	++r->counts[kind];
+	if(Array_size(&r->issues) >= LINT_MAX_ISSUES || Array_push(&r->issues, ((LintIssue){ kind, a, b })) != VEE_OK)
+		r->truncated = true;
+}
+
+//`i` and `j` overlap, unless one of them is a container holding the other
+static void Overlap(LintReport* r, const ArrayWidget* w, int i, int j) {
+	Widget a = Array_at(w, i), b = Array_at(w, j);
+	if(IsContainerWidget(a.type) && ContainerHolds(a, b.bounds)) return;
+	if(IsContainerWidget(b.type) && ContainerHolds(b, a.bounds)) return;
+	Report(r, LINT_OVERLAP, (i < j) ? i : j, (i < j) ? j : i);
+}
+
+//Test `s` against the widgets of `l` in `row` (every row for LINT_ANY_ROW) and drop the ones the
+//sweep is past. A widget kept in several rows is only tested in the first one it shares with
+//`s`, which covers the rows from `r0` on.
+static void Sweep(LintReport* r, const ArrayWidget* w, ArrayLintActive* l, LintActive s, float left, int row, int r0) {
+	for(ArrayIt j=0; j<Array_size(l);) {
+		LintActive e = Array_at(l, j);
+		if(e.right <= left) {
+			Array_at(l, j) = Array_at(l, Array_size(l)-1);
+			Array_pop(l);
+			continue;
+		}
+		++j;
+		if(row != LINT_ANY_ROW && e.row != row) continue;
+		if(e.row != LINT_ANY_ROW) {
+			int first = Row(e.top);
+			if(e.row != ((r0 > first) ? r0 : first)) continue;
+		}
+		if(e.top < s.bottom && s.top < e.bottom) Overlap(r, w, s.index, e.index);
+	}
+}
+
+static int SweepAndPrune(LintReport* r, const ArrayWidget* w, const AlignIndex* a) {
+	const ArrayAlignEntry* byLeft = &a->lines[ALIGN_LEFT];
+	for(ArrayIt k=0; k<Array_size(byLeft); ++k) {
+		//the sweep order jumps around the widget array
+		if(k + LINT_PREFETCH < Array_size(byLeft)) __builtin_prefetch(&Array_at(w, Array_at(byLeft, k + LINT_PREFETCH).index));
+		int i = Array_at(byLeft, k).index;
+		Rectangle b = Normalize(Array_at(w, i).bounds);
+		if(b.width == 0 || b.height == 0) continue;
+		LintActive s = { b.y, b.y + b.height, b.x + b.width, i, LINT_ANY_ROW };
+		int r0 = Row(s.top), r1 = (int)ceilf(s.bottom/LINT_ROW_HEIGHT) - 1;
+		if(r1 < r0) r1 = r0;
+		bool tall = r1 - r0 >= LINT_MAX_ROWS;
+
+		Sweep(r, w, &r->tall, s, b.x, LINT_ANY_ROW, LINT_ANY_ROW);
+		if(tall) {
+			for(int row=0; row<LINT_ROW_BUCKETS; ++row) Sweep(r, w, &r->rows[row], s, b.x, LINT_ANY_ROW, LINT_ANY_ROW);
+			if(Array_push(&r->tall, s) != VEE_OK) return VEE_OUT_OF_MEMORY;
+			continue;
+		}
+		for(int row=r0; row<=r1; ++row) {
+			ArrayLintActive* l = GetBucket(r, row);
+			Sweep(r, w, l, s, b.x, row, r0);
+			s.row = row;
+			if(Array_push(l, s) != VEE_OK) return VEE_OUT_OF_MEMORY;
+			s.row = LINT_ANY_ROW;
+		}
+	}
+	return VEE_OK;
+}
+
+int LintLayout(LintReport* r, const ArrayWidget* w, const AlignIndex* a, Rectangle canvas) {
+	PROFILE_ZONE("LintLayout");
+	Clear(r);
+	if(Array_size(&a->lines[ALIGN_LEFT]) != Array_size(w)) return VEE_BAD_ARG;
+
+	float right = canvas.x + canvas.width, bottom = canvas.y + canvas.height;
+	for(ArrayIt i=0; i<Array_size(w); ++i) {
+		Rectangle b = Array_at(w, i).bounds;
+		if(b.width < 0 || b.height < 0) Report(r, LINT_NEGATIVE, i, -1);
+		if(b.width == 0 || b.height == 0) Report(r, LINT_EMPTY, i, -1);
+		b = Normalize(b);
+		if(b.x >= right || b.y >= bottom || b.x + b.width <= canvas.x || b.y + b.height <= canvas.y)
+			Report(r, LINT_OUTSIDE, i, -1);
+		else if(b.x < canvas.x || b.y < canvas.y || b.x + b.width > right || b.y + b.height > bottom)
+			Report(r, LINT_CLIPPED, i, -1);
+	}
+	if(SweepAndPrune(r, w, a) != VEE_OK) {
+		Clear(r);
+		return VEE_OUT_OF_MEMORY;
+	}
+	return VEE_OK;
+}
+
+Rectangle LintOverlap(Rectangle a, Rectangle b) {
+	a = Normalize(a);
+	b = Normalize(b);
+	float x0 = fmaxf(a.x, b.x), y0 = fmaxf(a.y, b.y);
+	float x1 = fminf(a.x + a.width, b.x + b.width), y1 = fminf(a.y + a.height, b.y + b.height);
+	return (Rectangle){ x0, y0, fmaxf(x1 - x0, 0), fmaxf(y1 - y0, 0) };
+}
+
+
+// -------
+// REPORT
+// -------
+
+static void WriteRect(FILE* f, Rectangle r) {
+	fprintf(f, "[%g, %g, %g, %g]", r.x, r.y, r.width, r.height);
+}
+
+int LintWrite(const LintReport* r, const ArrayWidget* w, Rectangle canvas, FILE* f) {
+	fprintf(f, "{\n\"canvas\": ");
+	WriteRect(f, canvas);
+	fprintf(f, ",\n\"widgets\": %zu,\n\"counts\": {", Array_size(w));
+	for(int k=0; k<LINT_KIND_COUNT; ++k) fprintf(f, "%s\"%s\": %zu", k ? ", " : "", LintKindName[k], r->counts[k]);
+	fprintf(f, "},\n\"truncated\": %s,\n\"issues\": [", r->truncated ? "true" : "false");
+	for(ArrayIt i=0; i<Array_size(&r->issues); ++i) {
+		LintIssue e = Array_at(&r->issues, i);
+		Widget a = Array_at(w, e.a);
+		fprintf(f, "%s\n{\"kind\": \"%s\", ", i ? "," : "", LintKindName[e.kind]);
+		if(e.kind == LINT_OVERLAP) {
+			Widget b = Array_at(w, e.b);
+			fprintf(f, "\"ids\": [%i, %i], \"types\": [\"%s\", \"%s\"], \"area\": ", a.id, b.id, WidgetName[a.type], WidgetName[b.type]);
+			WriteRect(f, LintOverlap(a.bounds, b.bounds));
+		} else {
+			fprintf(f, "\"ids\": [%i], \"types\": [\"%s\"], \"bounds\": ", a.id, WidgetName[a.type]);
+			WriteRect(f, a.bounds);
+		}
+		fprintf(f, "}");
+	}
+	fprintf(f, "\n]\n}\n");
+	return ferror(f) ? VEE_IO_ERROR : VEE_OK;
+}
+
+
+// -------
+// COMMAND LINE
+// -------
+
+static inline double Now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec*1000.0 + t.tv_nsec/1e6;
+}
+
+int RunLint(const char* file, const char* report) {
+	ArrayWidget w = {0};
+	AlignIndex a;
+	LintReport r;
+	AlignIndexCreate(&a, NULL);
+	LintCreate(&r, NULL);
+	Rectangle canvas = { 0, 0, screenWidth, screenHeight };
+
+	int n = ReadUIFile(file, &w, 0, NULL, NULL);
+	double t = Now();
+	int result = (n < 0) ? n : VEE_OK;
+	if(result == VEE_OK) {
+		AlignIndexRebuild(&a, &w);
+		result = LintLayout(&r, &w, &a, canvas);
+	}
+	t = Now() - t;
+
+	if(result == VEE_OK) {
+		FILE* f = (report != NULL) ? fopen(report, "w") : stdout;
+		if(f == NULL || LintWrite(&r, &w, canvas, f) != VEE_OK) result = VEE_IO_ERROR;
+		if(f != NULL && f != stdout && fclose(f) != 0) result = VEE_IO_ERROR;
+	}
+	if(result != VEE_OK) warn("failed to lint `%s` (%i)", file, result);
+	else {
+		fprintf(stderr, "`%s`: %i widgets checked in %.2f ms", file, n, t);
+		for(int k=0; k<LINT_KIND_COUNT; ++k) fprintf(stderr, ", %zu %s", r.counts[k], LintKindName[k]);
+		fprintf(stderr, "\n");
+	}
+	bool clean = result == VEE_OK && LintIssueCount(&r) == 0;
+
+	LintDestroy(&r);
+	AlignIndexDestroy(&a);
+	Array_destroy(&w);
+	return clean ? EXIT_SUCCESS : EXIT_FAILURE;
+}
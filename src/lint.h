@@ -0,0 +1,88 @@
+#ifndef GE_LINT_H
+#define GE_LINT_H
+
+#include "editor.h"
+#include "align.h"
+#include <stdio.h>
+
+//the rows of the canvas the widgets of the sweep are kept in
+#define LINT_ROW_HEIGHT 32
+#define LINT_ROW_BUCKETS 1024 //power of 2
+//widgets covering more rows than this are tested against every widget of the sweep instead
+#define LINT_MAX_ROWS 16
+//issues kept by a report, the counts go on past it
+#define LINT_MAX_ISSUES (1 << 18)
+
+/* LAYOUT LINT
+ * Finds what shouldn't be in an exported layout: widgets that overlap, widgets that are partly
+ * or entirely off the canvas and widgets with no area or a negative size (resized past the
+ * opposite edge). A widget held by a container (see ContainerHolds()) doesn't overlap it.
+ *
+ * The overlaps are found by sweep and prune: the widgets are visited by increasing left edge
+ * (the order of the ALIGN_LEFT lines of an AlignIndex, which the editor keeps sorted anyway)
+ * and the ones the sweep is still inside of are kept in buckets by row, so a widget is only
+ * tested against the widgets that share its x range and one of its rows. A pass is O(n + k)
+ * for n widgets and k overlaps with an index that's up to date. */
+
+typedef enum {
+	LINT_OVERLAP,   //`a` and `b` overlap
+	LINT_CLIPPED,   //`a` is partly off the canvas
+	LINT_OUTSIDE,   //`a` is entirely off the canvas
+	LINT_EMPTY,     //`a` has a width or height of 0
+	LINT_NEGATIVE,  //`a` has a negative width or height
+	LINT_KIND_COUNT
+} LintKind;
+
+extern const char* LintKindName[LINT_KIND_COUNT];
+
+typedef struct {
+	LintKind kind;
+	int a, b; //slots of the widgets, `b` is -1 but for an overlap
+} LintIssue;
+
+typedef Array(LintIssue) ArrayLintIssue;
+
+//a widget the sweep is inside of, in one of the rows it covers
+typedef struct {
+	float top, bottom, right;
+	int index;
+	int row;
+} LintActive;
+
+typedef Array(LintActive) ArrayLintActive;
+
+typedef struct {
+	ArrayLintIssue issues;           //the checks of single widgets by slot, then the overlaps
+	size_t counts[LINT_KIND_COUNT];  //every issue found, even past LINT_MAX_ISSUES
+	bool truncated;                  //some issues weren't kept
+
+	//scratch memory of the sweep
+	ArrayLintActive rows[LINT_ROW_BUCKETS];
+	ArrayLintActive tall;
+} LintReport;
+
+extern void LintCreate(LintReport* r, Allocator* a);
+extern void LintDestroy(LintReport* r);
+
+/** Check the widgets `w` against each other and against `canvas`. `a` has to index exactly the
+ * widgets of `w`. Returns VEE_OK[0] on success, the report is empty otherwise. */
+extern int LintLayout(LintReport* r, const ArrayWidget* w, const AlignIndex* a, Rectangle canvas);
+
+static inline size_t LintIssueCount(const LintReport* r) {
+	size_t n = 0;
+	for(int k=0; k<LINT_KIND_COUNT; ++k) n += r->counts[k];
+	return n;
+}
+
+/** The area widgets `a` and `b` share (both normalized). */
+extern Rectangle LintOverlap(Rectangle a, Rectangle b);
+
+/** Write `r` as JSON to `f`, the widgets are named by their id. Returns VEE_OK[0] on success. */
+extern int LintWrite(const LintReport* r, const ArrayWidget* w, Rectangle canvas, FILE* f);
+
+/** `editor --lint <in.ui> [<report.json>]` checks a layout without opening a window. The
+ * report goes to `report` (stdout when NULL), a summary to stderr. Returns EXIT_SUCCESS when
+ * the layout is clean, EXIT_FAILURE when it has issues or can't be read. */
+extern int RunLint(const char* file, const char* report);
+
+#endif
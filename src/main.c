@@ -1,25 +1,58 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "editor.h"
+#include "bench.h"
+#include "replay.h"
+#include "lint.h"
+#include "batch.h"
+#include "input.h"
+#include "profile.h"
+
+#define TARGET_FPS 60
+//after this many frames where nothing changed the editor only wakes up IDLE_FPS times a second
+//to look at the input, until something changes again
+#define IDLE_AFTER_FRAMES 30
+#define IDLE_FPS 10
 
 int main(int argc, char **argv)
 {
+	if(argc > 1 && strcmp(argv[1], "--bench") == 0) return RunBenchmarks();
+	if(argc > 2 && strcmp(argv[1], "--replay") == 0) return RunReplay(argv[2], (argc > 3) ? argv[3] : "replay.ui");
+	if(argc > 2 && strcmp(argv[1], "--lint") == 0) return RunLint(argv[2], (argc > 3) ? argv[3] : NULL);
+	if(argc > 1 && strcmp(argv[1], "--export") == 0) return RunBatchExport(argc - 2, argv + 2);
+	
 	InitWindow(screenWidth, screenHeight, "GUI Editor");
-	SetTargetFPS(60);
+	SetTargetFPS(TARGET_FPS);
 	
 	InitializeEditor();
+	if(argc > 2 && strcmp(argv[1], "--record") == 0 && RecordEditor(argv[2]) != VEE_OK) 
+		TraceLog(LOG_WARNING, TextFormat("Failed to record the input to `%s`", argv[2]));
 	
+	int idleFrames = 0;
 	while(!WindowShouldClose()) 
 	{
-		UpdateEditor();
+		InputBeginFrame();
+		if(UpdateEditor()) {
+			if(idleFrames >= IDLE_AFTER_FRAMES) SetTargetFPS(TARGET_FPS);
+			idleFrames = 0;
+		}
+		else if(++idleFrames == IDLE_AFTER_FRAMES) SetTargetFPS(IDLE_FPS);
 		
+		//the canvas is drawn from the last frame when nothing changed, see DrawEditor()
 		BeginDrawing();
 			ClearBackground(RAYWHITE);
 			DrawEditor();
 		
-		EndDrawing();
+		{
+			PROFILE_ZONE("EndDrawing");
+			EndDrawing();
+		}
+		InputEndFrame();
+		ProfileFrame();
 	}
 	
+	InputClose();
 	FinalizeEditor();
 	
 	CloseWindow();
@@ -0,0 +1,241 @@
+#include "profile.h"
+#include "textcache.h"
+
+#ifndef GE_NO_PROFILE
+#include <time.h>
+
+typedef struct {
+	uint64_t seq;      //index + 1 once the event is complete, 0 while it's written
+	const char* name;
+	uint64_t start, end;
+	uint32_t thread;
+} ProfileEvent;
+
+static struct {
+	ProfileEvent ring[PROFILE_RING_SIZE];
+	uint64_t head;     //index of the next event, only changed with atomics
+	uint32_t threads;  //last thread id handed out, only changed with atomics
+
+	//main thread only
+	float frames[PROFILE_FRAMES];  //frame times in ms, oldest overwritten first
+	float cpu[PROFILE_FRAMES];     //CPU time of the process during the frame in ms, all threads
+	uint8_t redraw[PROFILE_FRAMES];//ProfileRedrawKind
+	uint64_t frameCount, lastFrame, lastCpu;
+	ProfileRedrawKind nextRedraw;
+	bool overlay;
+} profile;
+
+//1 for the first thread that ends a zone, 2 for the next...
+static __thread uint32_t threadId = 0;
+
+uint64_t ProfileNow() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec*1000000000u + t.tv_nsec;
+}
+
+static void Push(const char* name, uint64_t start, uint64_t end) {
+	if(threadId == 0) threadId = __atomic_add_fetch(&profile.threads, 1, __ATOMIC_RELAXED);
+	uint64_t i = __atomic_fetch_add(&profile.head, 1, __ATOMIC_RELAXED);
+	ProfileEvent* e = &profile.ring[i & (PROFILE_RING_SIZE-1)];
+	//readers skip the slot until `seq` says it's event `i`
+	__atomic_store_n(&e->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	__atomic_store_n(&e->name, name, __ATOMIC_RELAXED);
+	__atomic_store_n(&e->start, start, __ATOMIC_RELAXED);
+	__atomic_store_n(&e->end, end, __ATOMIC_RELAXED);
+	__atomic_store_n(&e->thread, threadId, __ATOMIC_RELAXED);
+	__atomic_store_n(&e->seq, i+1, __ATOMIC_RELEASE);
+}
+
+void ProfileEnd(ProfileZone* z) {
+	Push(z->name, z->start, ProfileNow());
+}
+
+//Copy event `i` to `e`, false if it was overwritten or is still being written
+static bool Read(uint64_t i, ProfileEvent* e) {
+	const ProfileEvent* s = &profile.ring[i & (PROFILE_RING_SIZE-1)];
+	if(__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != i+1) return false;
+	e->name = __atomic_load_n(&s->name, __ATOMIC_RELAXED);
+	e->start = __atomic_load_n(&s->start, __ATOMIC_RELAXED);
+	e->end = __atomic_load_n(&s->end, __ATOMIC_RELAXED);
+	e->thread = __atomic_load_n(&s->thread, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&s->seq, __ATOMIC_RELAXED) == i+1;
+}
+
+//the oldest event still in the ring
+static inline uint64_t Tail(uint64_t head) {
+	return (head > PROFILE_RING_SIZE) ? head - PROFILE_RING_SIZE : 0;
+}
+
+static uint64_t CpuNow() {
+	struct timespec t;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+	return (uint64_t)t.tv_sec*1000000000u + t.tv_nsec;
+}
+
+void ProfileFrame() {
+	uint64_t now = ProfileNow(), cpu = CpuNow();
+	if(profile.lastFrame != 0) {
+		Push("Frame", profile.lastFrame, now);
+		size_t k = profile.frameCount++ % PROFILE_FRAMES;
+		profile.frames[k] = (now - profile.lastFrame)/1e6;
+		profile.cpu[k] = (cpu - profile.lastCpu)/1e6;
+		profile.redraw[k] = profile.nextRedraw;
+	}
+	profile.lastFrame = now;
+	profile.lastCpu = cpu;
+	profile.nextRedraw = PROFILE_REDRAW_CACHED;
+}
+
+void ProfileRedraw(ProfileRedrawKind kind) {
+	profile.nextRedraw = kind;
+}
+
+void ProfileToggleOverlay() {
+	profile.overlay = !profile.overlay;
+}
+
+bool ProfileOverlayVisible() {
+	return profile.overlay;
+}
+
+
+// -------
+// OVERLAY
+// -------
+
+#define OVERLAY_ZONES 24
+
+typedef struct {
+	const char* name;
+	uint64_t total, max;
+	int calls;
+} ZoneStats;
+
+static int CompareFloats(const void* a, const void* b) {
+	float x = *(const float*)a, y = *(const float*)b;
+	return (x > y) - (x < y);
+}
+
+//time every zone took since `since`, summed up per name
+static int CollectZones(ZoneStats* zones, uint64_t since) {
+	int count = 0;
+	uint64_t head = __atomic_load_n(&profile.head, __ATOMIC_ACQUIRE);
+	for(uint64_t i = head; i-- > Tail(head);) {
+		ProfileEvent e;
+		if(!Read(i, &e)) continue;
+		if(e.end < since) break;
+		int z = 0;
+		while(z < count && zones[z].name != e.name) ++z;
+		if(z == count) {
+			if(count == OVERLAY_ZONES) continue;
+			zones[count++] = (ZoneStats){ e.name };
+		}
+		uint64_t t = e.end - e.start;
+		zones[z].total += t;
+		zones[z].max = (t > zones[z].max) ? t : zones[z].max;
+		++zones[z].calls;
+	}
+	return count;
+}
+
+void ProfileDrawOverlay() {
+	if(!profile.overlay) return;
+	const int width = PROFILE_FRAMES + 20, x = screenWidth - width - 10;
+	int y = 20;
+
+	size_t n = (profile.frameCount < PROFILE_FRAMES) ? profile.frameCount : PROFILE_FRAMES;
+	float sorted[PROFILE_FRAMES];
+	memcpy(sorted, profile.frames, n*sizeof(float));
+	qsort(sorted, n, sizeof(float), CompareFloats);
+
+	ZoneStats zones[OVERLAY_ZONES];
+	int count = CollectZones(zones, ProfileNow() - 1000000000u);
+	int frames = 1;
+	for(int z=0; z<count; ++z)
+		if(strcmp(zones[z].name, "Frame") == 0) frames = (zones[z].calls > 0) ? zones[z].calls : 1;
+
+	//the frames of the last second (or as many as there are)
+	float wall = 0, cpu = 0;
+	int redraws[PROFILE_REDRAW_COUNT] = {0};
+	for(size_t k=0; k<n && wall < 1000.0f; ++k) {
+		size_t f = (profile.frameCount - 1 - k) % PROFILE_FRAMES;
+		wall += profile.frames[f];
+		cpu += profile.cpu[f];
+		++redraws[profile.redraw[f]];
+	}
+
+	const int histogram = 60;
+	DrawRectangle(x, y, width, 42 + histogram + 12*(count+3), Fade(BLACK, 0.75f));
+	y += 5;
+	if(n > 0) DrawText(TextFormat("FRAME ms  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f", sorted[n/2], sorted[n*95/100],
+		sorted[n*99/100], sorted[n-1]), x+10, y, 10, RAYWHITE);
+	y += 12;
+	DrawText(TextFormat("CPU %.1f%%  REDRAW %i full  %i partial  %i skipped", (wall > 0) ? 100.0f*cpu/wall : 0.0f,
+		redraws[PROFILE_REDRAW_FULL], redraws[PROFILE_REDRAW_PARTIAL], redraws[PROFILE_REDRAW_CACHED]), x+10, y, 10, RAYWHITE);
+	y += 15;
+
+	//one bar per frame, oldest on the left, the line is a 60 fps frame
+	const float scale = histogram/(2*1000.0f/60.0f);
+	for(size_t k=0; k<n; ++k) {
+		float ms = profile.frames[(profile.frameCount - n + k) % PROFILE_FRAMES];
+		int h = (ms*scale < histogram) ? ms*scale : histogram;
+		DrawRectangle(x+10+k, y+histogram-h, 1, h, (ms > 1000.0f/60.0f) ? RED : GREEN);
+	}
+	DrawRectangle(x+10, y+histogram/2, PROFILE_FRAMES, 1, Fade(RAYWHITE, 0.5f));
+	y += histogram + 5;
+
+	DrawText("ZONE                 ms/frame   max ms  calls", x+10, y, 10, GRAY);
+	for(int z=0; z<count; ++z) {
+		y += 12;
+		DrawText(TextFormat("%-20.20s %8.3f %8.3f %6i", zones[z].name, zones[z].total/1e6/frames, zones[z].max/1e6,
+			zones[z].calls), x+10, y, 10, RAYWHITE);
+	}
+	
+	//since the start
+	TextCacheStats text = TextCacheGetStats();
+	uint64_t lookups = text.hits + text.misses;
+	y += 24;
+	uint64_t splits = text.splitHits + text.splitMisses;
+	DrawText(TextFormat("TEXT CACHE  %.1f%% hits  %llu misses  %llu evictions  SPLIT %.1f%% hits", 
+		(lookups > 0) ? 100.0*text.hits/lookups : 0.0, (unsigned long long)text.misses, (unsigned long long)text.evictions,
+		(splits > 0) ? 100.0*text.splitHits/splits : 0.0), x+10, y, 10, GRAY);
+}
+
+
+// -------
+// CHROME TRACE
+// -------
+
+int ProfileDump(const char* file, int seconds) {
+	FILE* f = fopen(file, "w");
+	if(f == NULL) return VEE_IO_ERROR;
+	uint64_t since = ProfileNow() - (uint64_t)seconds*1000000000u, first = UINT64_MAX;
+	uint64_t head = __atomic_load_n(&profile.head, __ATOMIC_ACQUIRE);
+	uint64_t tail = Tail(head);
+	//the events are written as they end, the viewer sorts them
+	for(uint64_t i = tail; i < head; ++i) {
+		ProfileEvent e;
+		if(Read(i, &e) && e.end >= since && e.start < first) first = e.start;
+	}
+
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool comma = false;
+	for(uint64_t i = tail; i < head; ++i) {
+		ProfileEvent e;
+		if(!Read(i, &e) || e.end < since) continue;
+		fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", comma ? ",\n" : "",
+			e.name, e.thread, (e.start - first)/1e3, (e.end - e.start)/1e3);
+		comma = true;
+	}
+	fprintf(f, "\n]}\n");
+	bool ok = ferror(f) == 0;
+	if(fclose(f) != 0) ok = false;
+	if(ok) TraceLog(LOG_INFO, TextFormat("Profile of the last %i seconds written to `%s`", seconds, file));
+	else TraceLog(LOG_WARNING, TextFormat("Failed to write the profile to `%s`", file));
+	return ok ? VEE_OK : VEE_IO_ERROR;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef GE_PROFILE_H
+#define GE_PROFILE_H
+
+#include "editor.h"
+
+/* PROFILER
+ * PROFILE_ZONE("name") times the rest of the enclosing block. Every zone that ends is
+ * written to a ring buffer shared by all threads (a slot is claimed with one atomic add,
+ * nothing ever waits), so the last PROFILE_RING_SIZE zones are always there to look at.
+ * ProfileFrame() marks the end of a frame and keeps the last PROFILE_FRAMES frame times,
+ * the CPU time the process took during them and how much of the editor they drew again
+ * (ProfileRedraw()).
+ *
+ * The overlay shows the time every zone took over the last second, the frame time
+ * percentiles and a histogram of the recent frames. ProfileDump() writes the zones of
+ * the last seconds as Chrome trace_event JSON (open it in chrome://tracing or Perfetto).
+ *
+ * Define GE_NO_PROFILE to build without it, all of the macros below compile to nothing.
+ * Zone names must be string literals (or live as long as the program). */
+
+#define PROFILE_RING_SIZE (1 << 16) //power of 2
+#define PROFILE_FRAMES 240
+#define PROFILE_DUMP_SECONDS 10
+
+//how much of the editor a frame drew again
+typedef enum {
+	PROFILE_REDRAW_CACHED = 0,  //nothing, the last frame was drawn as it was
+	PROFILE_REDRAW_PARTIAL,     //the part around the widgets that changed
+	PROFILE_REDRAW_FULL,
+	PROFILE_REDRAW_COUNT
+} ProfileRedrawKind;
+
+#ifdef GE_NO_PROFILE
+
+#define PROFILE_ZONE(name)
+#define ProfileFrame() ((void)0)
+#define ProfileRedraw(kind) ((void)0)
+#define ProfileToggleOverlay() ((void)0)
+#define ProfileOverlayVisible() (false)
+#define ProfileDrawOverlay() ((void)0)
+#define ProfileDump(file, seconds) ((void)0)
+
+#else
+
+typedef struct {
+	const char* name;
+	uint64_t start;  //ns
+} ProfileZone;
+
+extern uint64_t ProfileNow();
+extern void ProfileEnd(ProfileZone* z);
+static inline ProfileZone ProfileBegin(const char* name) { return (ProfileZone){ name, ProfileNow() }; }
+
+#define PROFILE_CAT__(a, b) a##b
+#define PROFILE_CAT_(a, b) PROFILE_CAT__(a, b)
+#define PROFILE_ZONE(name) \
+	ProfileZone PROFILE_CAT_(zone__, __LINE__) __attribute__((cleanup(ProfileEnd))) = ProfileBegin(name)
+
+extern void ProfileFrame();
+/** What the current frame drew again, the last call before ProfileFrame() counts. */
+extern void ProfileRedraw(ProfileRedrawKind kind);
+extern void ProfileToggleOverlay();
+extern bool ProfileOverlayVisible();
+extern void ProfileDrawOverlay();
+/** Write the zones of the last `seconds` to `file`. Returns VEE_OK[0] on success. */
+extern int ProfileDump(const char* file, int seconds);
+
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+#include "replay.h"
+#include "editor.h"
+#include "input.h"
+#include "uifile.h"
+#include <time.h>
+
+typedef Array(double) ArrayDouble;
+
+static inline double Now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec*1000.0 + t.tv_nsec/1e6;
+}
+
+static int CompareTimes(const void* a, const void* b) {
+	double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+int RunReplay(const char* trace, const char* out) {
+	ArrayWidget start = {0};
+	ArrayDepthRank depth = {0};
+	ArrayDouble times = {0};
+	StringTable strings;
+	int r = StringTableCreate(&strings, NULL);
+	if(r == VEE_OK) r = InputReplay(trace, &start, &depth, &strings);
+	if(r != VEE_OK) {
+		StringTableDestroy(&strings);
+		warn("failed to read the input trace `%s` (%i)", trace, r);
+		return EXIT_FAILURE;
+	}
+
+	//the editor starts from the layout the recording started from, with no journal to replay
+	char journal[1040];
+	snprintf(journal, sizeof(journal), "%s.journal", out);
+	remove(journal);
+	r = WriteUIFile(out, &start, Array_data(&depth), StringTableData(&strings), StringTableSize(&strings));
+	Array_destroy(&start);
+	Array_destroy(&depth);
+	StringTableDestroy(&strings);
+	if(r != VEE_OK) {
+		warn("failed to write `%s` (%i)", out, r);
+		InputClose();
+		return EXIT_FAILURE;
+	}
+
+	projectFile = out;
+	headless = true;
+	InitializeEditor();
+
+	double total = Now();
+	while(InputBeginFrame()) {
+		double t = Now();
+		UpdateEditor();
+		UpdateEditorHeadless();
+		t = Now() - t;
+		InputEndFrame();
+		Array_push(&times, t);
+	}
+	total = Now() - total;
+
+	SaveProject();
+	FinalizeEditor(); //waits for the journal to write the project
+	InputClose();
+
+	size_t n = Array_size(&times);
+	uint32_t checksum = 0;
+	r = ReadUIFileChecksum(out, &checksum);
+	info("replayed %zu frames of `%s` in %.1f ms", n, trace, total);
+	if(n > 0) {
+		double sum = 0;
+		for(size_t i=0; i<n; ++i) sum += Array_at(&times, i);
+		qsort(Array_data(&times), n, sizeof(double), CompareTimes);
+		info("  frame mean %.4f ms, p50 %.4f ms, p99 %.4f ms, max %.4f ms", sum/n, 
+			Array_at(&times, n/2), Array_at(&times, n*99/100), Array_at(&times, n-1));
+	}
+	Array_destroy(&times);
+	if(r != VEE_OK) {
+		warn("failed to write `%s`", out);
+		return EXIT_FAILURE;
+	}
+	info("  final state in `%s`, checksum %08x", out, checksum);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,13 @@
+#ifndef GE_REPLAY_H
+#define GE_REPLAY_H
+
+/* REPLAY
+ * `editor --record <trace>` runs the editor as usual and writes its input to `trace` (see
+ * input.h). `editor --replay <trace> [<out.ui>]` feeds the trace back to the editor without
+ * opening a window, as fast as it goes, prints the time every frame took and writes the
+ * widgets it ended up with to `out.ui` (default "replay.ui", overwritten together with its
+ * journal). Two replays of the same trace give the same `out.ui` and the same checksum.
+ * Returns EXIT_SUCCESS or EXIT_FAILURE. */
+extern int RunReplay(const char* trace, const char* out);
+
+#endif
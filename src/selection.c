@@ -0,0 +1,111 @@
+#include "selection.h"
+
+//make room for `slot`, new words start out empty
+static int Grow(Selection* s, int slot) {
+	size_t n = Array_size(&s->words), need = (size_t)slot/64 + 1;
+	if(need <= n) return VEE_OK;
+	if(Array_reserve(&s->words, need) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	memset(&Array_at(&s->words, n), 0, (need-n)*sizeof(uint64_t));
+	s->words.size = need;
+	return VEE_OK;
+}
+
+void SelectionCreate(Selection* s) {
+	*s = (Selection){0};
+}
+
+void SelectionDestroy(Selection* s) {
+	Array_destroy(&s->words);
+	s->count = 0;
+}
+
+void SelectionClear(Selection* s) {
+	s->words.size = 0;
+	s->count = 0;
+}
+
+int SelectionCopy(Selection* dst, const Selection* src) {
+	SelectionClear(dst);
+	size_t n = Array_size(&src->words);
+	if(Array_reserve(&dst->words, n) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	if(n > 0) memcpy(Array_data(&dst->words), Array_data(&src->words), n*sizeof(uint64_t));
+	dst->words.size = n;
+	dst->count = src->count;
+	return VEE_OK;
+}
+
+int SelectionAdd(Selection* s, int slot) {
+	if(slot < 0) return VEE_BAD_ARG;
+	if(SelectionHas(s, slot)) return VEE_OK;
+	if(Grow(s, slot) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	Array_at(&s->words, slot/64) |= (uint64_t)1 << (slot%64);
+	++s->count;
+	return VEE_OK;
+}
+
+void SelectionRemove(Selection* s, int slot) {
+	if(!SelectionHas(s, slot)) return;
+	Array_at(&s->words, slot/64) &= ~((uint64_t)1 << (slot%64));
+	--s->count;
+}
+
+//count again after a kernel added bits
+static void Recount(Selection* s) {
+	s->count = 0;
+	for(ArrayIt i=0; i<Array_size(&s->words); ++i) 
+		s->count += __builtin_popcountll(Array_at(&s->words, i));
+}
+
+int SelectionAddRect(Selection* s, const WidgetBounds* b, Rectangle r) {
+	if(BoundsSize(b) == 0) return VEE_OK;
+	if(Grow(s, BoundsSize(b)-1) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	BoundsOverlap(b, r, Array_data(&s->words));
+	Recount(s);
+	return VEE_OK;
+}
+
+int SelectionAddPoint(Selection* s, const WidgetBounds* b, Vector2 p) {
+	if(BoundsSize(b) == 0) return VEE_OK;
+	if(Grow(s, BoundsSize(b)-1) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	BoundsContain(b, p, Array_data(&s->words));
+	Recount(s);
+	return VEE_OK;
+}
+
+int SelectionNext(const Selection* s, int slot) {
+	if(slot < 0) slot = 0;
+	size_t i = (size_t)slot/64;
+	if(i >= Array_size(&s->words)) return -1;
+	uint64_t word = Array_at(&s->words, i) & (~(uint64_t)0 << (slot%64));
+	while(word == 0) {
+		if(++i >= Array_size(&s->words)) return -1;
+		word = Array_at(&s->words, i);
+	}
+	return i*64 + __builtin_ctzll(word);
+}
+
+void SelectionSwapRemove(Selection* s, int slot, int last) {
+	bool moved = SelectionHas(s, last);
+	SelectionRemove(s, slot);
+	SelectionRemove(s, last);
+	if(moved && slot != last) SelectionAdd(s, slot);
+}
+
+int SelectionMoves(const Selection* s, const ArrayWidget* w, ArrayWidgetMove* m) {
+	m->size = 0;
+	if(Array_reserve(m, s->count) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	for(int i = SelectionNext(s, 0); i != -1 && (size_t)i < Array_size(w); i = SelectionNext(s, i+1)) {
+		Rectangle r = Array_at(w, i).bounds;
+		Array_at(m, m->size++) = (WidgetMove){ i, (Vector2){ r.x, r.y } };
+	}
+	return VEE_OK;
+}
+
+void TranslateWidgets(ArrayWidget* w, const WidgetMove* m, size_t n, Vector2 offset) {
+	//the slots are sorted so the writes walk the widget array front to back
+	Widget* p = Array_data(w);
+	for(size_t k=0; k<n; ++k) {
+		p[m[k].index].bounds.x = m[k].from.x + offset.x;
+		p[m[k].index].bounds.y = m[k].from.y + offset.y;
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef GE_SELECTION_H
+#define GE_SELECTION_H
+
+#include "editor.h"
+#include "bounds.h"
+
+/* SELECTION
+ * The selected widgets are kept as a bitset over the slots of the widget array, bit `i % 64`
+ * of word `i / 64` is set when widget `i` is selected. Walking the selection skips 64 unselected
+ * widgets per word and always visits the slots in increasing order. */
+
+typedef Array(uint64_t) ArraySelectionWord;
+
+typedef struct {
+	ArraySelectionWord words;  //only as long as the highest selected slot needs
+	size_t count;              //number of selected widgets
+} Selection;
+
+extern void SelectionCreate(Selection* s);
+extern void SelectionDestroy(Selection* s);
+extern void SelectionClear(Selection* s);
+
+/** Make `dst` a copy of `src`. Returns VEE_OK[0] on success. */
+extern int SelectionCopy(Selection* dst, const Selection* src);
+/** Returns VEE_OK[0] on success. */
+extern int SelectionAdd(Selection* s, int slot);
+extern void SelectionRemove(Selection* s, int slot);
+/** Add every widget whose bounds overlap `r` (box select). Returns VEE_OK[0] on success. */
+extern int SelectionAddRect(Selection* s, const WidgetBounds* b, Rectangle r);
+/** Add every widget that contains `p`. Returns VEE_OK[0] on success. */
+extern int SelectionAddPoint(Selection* s, const WidgetBounds* b, Vector2 p);
+/** Returns the first selected slot from `slot` on or -1. */
+extern int SelectionNext(const Selection* s, int slot);
+
+/** Mirror WidgetSwapRemove(): `slot` is dropped and the selection state of `last` moves to it. */
+extern void SelectionSwapRemove(Selection* s, int slot, int last);
+
+static inline bool SelectionHas(const Selection* s, int slot) {
+	size_t i = (size_t)slot/64;
+	return slot >= 0 && i < Array_size(&s->words) && ((Array_at(&s->words, i) >> (slot%64)) & 1);
+}
+
+
+// -------
+// BATCH TRANSFORMS
+// -------
+// A selection is moved by saving the position every selected widget started from once and
+// setting `from + offset` on every frame, so the widgets end up exactly where an undo or
+// redo of the same move puts them no matter how many frames it took.
+
+typedef struct {
+	uint32_t index;
+	Vector2 from;
+} WidgetMove;
+
+typedef Array(WidgetMove) ArrayWidgetMove;
+
+/** Store the slot and position of every selected widget in `m` (in slot order).
+ * Returns VEE_OK[0] on success. */
+extern int SelectionMoves(const Selection* s, const ArrayWidget* w, ArrayWidgetMove* m);
+/** Put every widget in `m` at its `from` position plus `offset`. */
+extern void TranslateWidgets(ArrayWidget* w, const WidgetMove* m, size_t n, Vector2 offset);
+
+#endif
@@ -0,0 +1,137 @@
+#include "spatial.h"
+#include <math.h>
+
+typedef struct {
+	int x0, y0, x1, y1;
+} CellRange;
+
+static inline CellRange GetCellRange(const SpatialIndex* s, Rectangle r) {
+	//widgets with negative size (resized past the opposite edge) still occupy the cells they cover
+	if(r.width < 0) { r.x += r.width; r.width = -r.width; }
+	if(r.height < 0) { r.y += r.height; r.height = -r.height; }
+
+	return (CellRange) {
+		(int)floorf(r.x/s->cellSize), (int)floorf(r.y/s->cellSize),
+		(int)floorf((r.x+r.width)/s->cellSize), (int)floorf((r.y+r.height)/s->cellSize)
+	};
+}
+
+static inline bool IsLarge(CellRange c) {
+	return (long)(c.x1-c.x0+1)*(c.y1-c.y0+1) > SPATIAL_MAX_CELLS;
+}
+
+static inline ArrayInt* GetBucket(SpatialIndex* s, int cx, int cy) {
+	unsigned int h = ((unsigned int)cx*73856093u) ^ ((unsigned int)cy*19349663u);
+	return &s->buckets[h & (SPATIAL_BUCKET_COUNT-1)];
+}
+
+//remove one occurrence of `index` from `a`, order inside a bucket does not matter
+static inline void RemoveEntry(ArrayInt* a, int index) {
+	for(ArrayIt i=0; i<Array_size(a); ++i) {
+		if(Array_at(a, i) == index) {
+			Array_at(a, i) = Array_at(a, Array_size(a)-1);
+			Array_pop(a);
+			return;
+		}
+	}
+}
+
+//replace one occurrence of `from` with `to`
+static inline void ReplaceEntry(ArrayInt* a, int from, int to) {
+	for(ArrayIt i=0; i<Array_size(a); ++i) {
+		if(Array_at(a, i) == from) {
+			Array_at(a, i) = to;
+			return;
+		}
+	}
+}
+
+static void ReplaceInCells(SpatialIndex* s, Rectangle r, int from, int to) {
+	CellRange c = GetCellRange(s, r);
+	if(IsLarge(c)) {
+		ReplaceEntry(&s->large, from, to);
+		return;
+	}
+	for(int y=c.y0; y<=c.y1; ++y)
+		for(int x=c.x0; x<=c.x1; ++x)
+			ReplaceEntry(GetBucket(s, x, y), from, to);
+}
+
+void SpatialIndexCreate(SpatialIndex* s, int cellSize) {
+	*s = (SpatialIndex){0};
+	s->cellSize = cellSize > 0 ? cellSize : 1;
+}
+
+void SpatialIndexDestroy(SpatialIndex* s) {
+	for(int i=0; i<SPATIAL_BUCKET_COUNT; ++i)
+		Array_destroy(&s->buckets[i]);
+	Array_destroy(&s->large);
+}
+
+void SpatialIndexClear(SpatialIndex* s) {
+	for(int i=0; i<SPATIAL_BUCKET_COUNT; ++i)
+		s->buckets[i].size = 0;
+	s->large.size = 0;
+}
+
+void SpatialIndexRebuild(SpatialIndex* s, const ArrayWidget* w) {
+	SpatialIndexClear(s);
+	for(ArrayIt i=0; i<Array_size(w); ++i)
+		SpatialIndexInsert(s, i, Array_at(w, i).bounds);
+}
+
+void SpatialIndexInsert(SpatialIndex* s, int index, Rectangle r) {
+	CellRange c = GetCellRange(s, r);
+	if(IsLarge(c)) {
+		Array_push(&s->large, index);
+		return;
+	}
+	for(int y=c.y0; y<=c.y1; ++y)
+		for(int x=c.x0; x<=c.x1; ++x)
+			Array_push(GetBucket(s, x, y), index);
+}
+
+void SpatialIndexRemove(SpatialIndex* s, int index, Rectangle r) {
+	CellRange c = GetCellRange(s, r);
+	if(IsLarge(c)) {
+		RemoveEntry(&s->large, index);
+		return;
+	}
+	for(int y=c.y0; y<=c.y1; ++y)
+		for(int x=c.x0; x<=c.x1; ++x)
+			RemoveEntry(GetBucket(s, x, y), index);
+}
+
+void SpatialIndexUpdate(SpatialIndex* s, int index, Rectangle from, Rectangle to) {
+	SpatialIndexRemove(s, index, from);
+	SpatialIndexInsert(s, index, to);
+}
+
+void SpatialIndexRename(SpatialIndex* s, int from, int to, Rectangle r) {
+	ReplaceInCells(s, r, from, to);
+}
+
+int SpatialIndexPick(const SpatialIndex* s, const ArrayWidget* w, const DepthOrder* d, Vector2 point) {
+	int cx = (int)floorf(point.x/s->cellSize), cy = (int)floorf(point.y/s->cellSize);
+	const ArrayInt* b = GetBucket((SpatialIndex*)s, cx, cy);
+
+	int top = -1;
+	uint64_t topKey = 0;
+	for(ArrayIt i=0; i<Array_size(b); ++i) {
+		int index = Array_at(b, i);
+		uint64_t key = DepthKey(d, index);
+		if((top == -1 || key > topKey) && CheckCollisionPointRec(point, Array_at(w, index).bounds)) {
+			top = index;
+			topKey = key;
+		}
+	}
+	for(ArrayIt i=0; i<Array_size(&s->large); ++i) {
+		int index = Array_at(&s->large, i);
+		uint64_t key = DepthKey(d, index);
+		if((top == -1 || key > topKey) && CheckCollisionPointRec(point, Array_at(w, index).bounds)) {
+			top = index;
+			topKey = key;
+		}
+	}
+	return top;
+}
@@ -0,0 +1,41 @@
+#ifndef GE_SPATIAL_H
+#define GE_SPATIAL_H
+
+#include "editor.h"
+#include "depth.h"
+
+//number of hash buckets the grid cells are spread over (must be a power of 2)
+#define SPATIAL_BUCKET_COUNT 4096
+//widgets covering more cells than this are kept in a separate list instead
+#define SPATIAL_MAX_CELLS 64
+
+typedef Array(int) ArrayInt;
+
+/* Uniform grid used to speed up widget hit-testing.
+ * Every widget index is stored once in each cell its bounds touch. Cells are hashed
+ * into a fixed number of buckets so the grid has no fixed extent. A pick keeps the
+ * colliding widget with the highest depth key. */
+typedef struct {
+	int cellSize;
+	ArrayInt buckets[SPATIAL_BUCKET_COUNT];
+	ArrayInt large;
+} SpatialIndex;
+
+extern void SpatialIndexCreate(SpatialIndex* s, int cellSize);
+extern void SpatialIndexDestroy(SpatialIndex* s);
+extern void SpatialIndexClear(SpatialIndex* s);
+/** Drop everything and insert all the widgets from `w` again. */
+extern void SpatialIndexRebuild(SpatialIndex* s, const ArrayWidget* w);
+
+extern void SpatialIndexInsert(SpatialIndex* s, int index, Rectangle r);
+/** `r` must be the same bounds the widget was inserted with. */
+extern void SpatialIndexRemove(SpatialIndex* s, int index, Rectangle r);
+extern void SpatialIndexUpdate(SpatialIndex* s, int index, Rectangle from, Rectangle to);
+
+/** Widget with bounds `r` moved from index `from` to index `to` in the widget array. */
+extern void SpatialIndexRename(SpatialIndex* s, int from, int to, Rectangle r);
+
+/** Returns the index of the topmost widget (according to `d`) containing `point` or -1. */
+extern int SpatialIndexPick(const SpatialIndex* s, const ArrayWidget* w, const DepthOrder* d, Vector2 point);
+
+#endif
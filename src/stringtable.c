@@ -0,0 +1,107 @@
+#include "stringtable.h"
+
+#define STRING_TABLE_MIN_SLOTS 256
+
+static inline uint64_t HashString(const char* s, size_t n) {
+	return fnv64_1a((char*)s, n);
+}
+
+int StringTableCreate(StringTable* t, Allocator* a) {
+	*t = (StringTable){0};
+	t->text.allocator = a;
+	t->slots.allocator = a;
+	if(Array_reserve(&t->text, 64) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	Array_at(&t->text, 0) = '\0';
+	t->text.size = 1;
+	return VEE_OK;
+}
+
+void StringTableDestroy(StringTable* t) {
+	Array_destroy(&t->text);
+	Array_destroy(&t->slots);
+	t->count = 0;
+}
+
+void StringTableClear(StringTable* t) {
+	if(Array_size(&t->text) > 0) t->text.size = 1;
+	if(Array_size(&t->slots) > 0) memset(Array_data(&t->slots), 0, Array_size(&t->slots)*sizeof(StringHandle));
+	t->count = 0;
+}
+
+//Twice the slots, every string goes where its hash puts it in the new size
+static int Grow(StringTable* t) {
+	size_t size = (Array_size(&t->slots) > 0) ? 2*Array_size(&t->slots) : STRING_TABLE_MIN_SLOTS;
+	if(Array_reserve_exact(&t->slots, size) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	t->slots.size = size;
+	memset(Array_data(&t->slots), 0, size*sizeof(StringHandle));
+	const char* text = Array_data(&t->text);
+	for(size_t at = 1; at < Array_size(&t->text); at += strlen(&text[at]) + 1) {
+		size_t j = HashString(&text[at], strlen(&text[at])) & (size-1);
+		while(Array_at(&t->slots, j) != 0) j = (j+1) & (size-1);
+		Array_at(&t->slots, j) = at;
+	}
+	return VEE_OK;
+}
+
+int StringInternN(StringTable* t, const char* s, size_t n, StringHandle* h) {
+	if(n == 0) {
+		*h = 0;
+		return VEE_OK;
+	}
+	//at most half full
+	if(2*(t->count+1) > Array_size(&t->slots) && Grow(t) != VEE_OK) return VEE_OUT_OF_MEMORY;
+
+	size_t mask = Array_size(&t->slots)-1, j = HashString(s, n) & mask;
+	for(; Array_at(&t->slots, j) != 0; j = (j+1) & mask) {
+		const char* other = &Array_at(&t->text, Array_at(&t->slots, j));
+		if(strncmp(other, s, n) == 0 && other[n] == '\0') {
+			*h = Array_at(&t->slots, j);
+			return VEE_OK;
+		}
+	}
+
+	size_t at = Array_size(&t->text);
+	if(at + n + 1 > UINT32_MAX) return VEE_OUT_OF_MEMORY; //the handles are 32 bits
+	if(Array_reserve(&t->text, at + n + 1) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	memcpy(&Array_at(&t->text, at), s, n);
+	Array_at(&t->text, at + n) = '\0';
+	t->text.size += n + 1;
+	Array_at(&t->slots, j) = at;
+	++t->count;
+	*h = at;
+	return VEE_OK;
+}
+
+int StringTableLoad(StringTable* t, const char* strings, size_t size, ArrayStringRemap* map) {
+	if(map != NULL) map->size = 0;
+	if(size == 0) return 0;
+	if(size > UINT32_MAX || strings[size-1] != '\0') return VEE_BAD_FORMAT;
+	//room for all of it, in one go
+	if(Array_reserve(&t->text, Array_size(&t->text) + size) != VEE_OK) return VEE_OUT_OF_MEMORY;
+
+	int count = 0;
+	for(size_t at = 0; at < size; ++count) {
+		size_t n = strlen(&strings[at]);
+		StringHandle h;
+		if(count == INT32_MAX) return VEE_BAD_FORMAT;
+		if(StringInternN(t, &strings[at], n, &h) != VEE_OK) return VEE_OUT_OF_MEMORY;
+		if(map != NULL && Array_push(map, ((StringRemap){ at, h })) != VEE_OK) return VEE_OUT_OF_MEMORY;
+		at += n + 1;
+	}
+	return count;
+}
+
+bool StringRemapFind(const ArrayStringRemap* map, uint32_t offset, StringHandle* h) {
+	size_t lo = 0, hi = Array_size(map);
+	while(lo < hi) {
+		size_t mid = lo + (hi - lo)/2;
+		uint32_t at = Array_at(map, mid).offset;
+		if(at == offset) {
+			*h = Array_at(map, mid).handle;
+			return true;
+		}
+		if(at < offset) lo = mid + 1;
+		else hi = mid;
+	}
+	return false;
+}
@@ -0,0 +1,76 @@
+#ifndef GE_STRINGTABLE_H
+#define GE_STRINGTABLE_H
+
+#include "../external/array.h"
+
+/* STRING TABLE
+ * The texts of the widgets (see WidgetProps in editor.h) are stored once each, one after the
+ * other with their `\0` in a single buffer, and referred to by their offset in it: a 32 bit
+ * StringHandle. Handle 0 is the empty string. A string is found by its fnv64-1a hash in an
+ * open addressing table, so adding a string that is already there gives back its handle and
+ * 100k widgets showing the same few texts cost a few bytes each, not a `malloc` each.
+ *
+ * Strings are never removed, the handles stay valid for the life of the table. The buffer
+ * is written as it is as the string table of a `.ui` file, StringTableLoad() reads it back.
+ * A pointer from StringTableGet() is only good until the next string is added. */
+
+typedef uint32_t StringHandle;
+
+typedef Array(char) ArrayStringText;
+typedef Array(StringHandle) ArrayStringHandle;
+
+typedef struct {
+	ArrayStringText text;    //every string followed by its `\0`, the empty one first
+	ArrayStringHandle slots; //power of 2 size, handle of a string or 0 when empty
+	size_t count;            //strings in `slots` (all but the empty one)
+} StringTable;
+
+/** The memory of the table comes from `a` (NULL for malloc). Returns VEE_OK[0] on success. */
+extern int StringTableCreate(StringTable* t, Allocator* a);
+extern void StringTableDestroy(StringTable* t);
+/** Drop every string but the empty one, the handles handed out before are invalid. */
+extern void StringTableClear(StringTable* t);
+
+/** Store the first `n` bytes of `s` (no `\0` in them) and put its handle in `h`.
+ * Returns VEE_OK[0] on success. */
+extern int StringInternN(StringTable* t, const char* s, size_t n, StringHandle* h);
+static inline int StringIntern(StringTable* t, const char* s, StringHandle* h) {
+	return StringInternN(t, s, strlen(s), h);
+}
+
+//where a string of a loaded table went
+typedef struct {
+	uint32_t offset;     //in the loaded table
+	StringHandle handle; //in the table it was added to
+} StringRemap;
+
+typedef Array(StringRemap) ArrayStringRemap;
+
+/** Add the `size` bytes of NUL terminated strings at `strings` in order (the string table of
+ * a file). `map` (can be NULL) gets where every string went, by increasing offset. When `t`
+ * is empty and `strings` comes from a table the handles are the offsets in `strings`.
+ * Returns the number of strings or a negative VEE_* error code. */
+extern int StringTableLoad(StringTable* t, const char* strings, size_t size, ArrayStringRemap* map);
+/** The handle of the string at `offset` of a table loaded with `map`. Returns false when
+ * no string starts there. */
+extern bool StringRemapFind(const ArrayStringRemap* map, uint32_t offset, StringHandle* h);
+
+/** The size of the buffer, the next string added goes there. */
+static inline size_t StringTableSize(const StringTable* t) {
+	return Array_size(&t->text);
+}
+
+static inline const char* StringTableData(const StringTable* t) {
+	return Array_data(&t->text);
+}
+
+/** True when `h` is where a string starts. */
+static inline bool StringValid(const StringTable* t, StringHandle h) {
+	return h < Array_size(&t->text) && (h == 0 || Array_at(&t->text, h-1) == '\0');
+}
+
+static inline const char* StringTableGet(const StringTable* t, StringHandle h) {
+	return &Array_at(&t->text, h);
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include "style.h"
+#include "textcache.h"
+#include "profile.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+#include "../external/raygui.h"
+
+static struct {
+	char path[1024];
+	char dir[1024];
+	const char* name;       //file name part of `path`
+
+	pthread_t thread;
+	pthread_mutex_t lock;
+	uint8_t* pending;       //guarded by `lock`, file contents not applied yet
+	int pendingSize;        //guarded by `lock`
+	bool quit;              //guarded by `lock`
+	bool running;
+} style = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+
+//The whole file in one read, NULL if it can't be read
+static uint8_t* ReadStyleFile(const char* path, int* size) {
+	PROFILE_ZONE("ReadStyle");
+	FILE* f = fopen(path, "rb");
+	if(f == NULL) return NULL;
+	uint8_t* data = NULL;
+	long n = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+	if(n > 0 && n <= INT32_MAX && fseek(f, 0, SEEK_SET) == 0 && (data = malloc(n)) != NULL) {
+		if(fread(data, 1, n, f) == (size_t)n) *size = n;
+		else {
+			free(data);
+			data = NULL;
+		}
+	}
+	fclose(f);
+	return data;
+}
+
+static bool ShouldQuit() {
+	pthread_mutex_lock(&style.lock);
+	bool quit = style.quit;
+	pthread_mutex_unlock(&style.lock);
+	return quit;
+}
+
+static void Publish() {
+	int size = 0;
+	uint8_t* data = ReadStyleFile(style.path, &size);
+	if(data == NULL) return; //removed or being replaced, there will be another event
+	pthread_mutex_lock(&style.lock);
+	free(style.pending); //never applied, this one is newer
+	style.pending = data;
+	style.pendingSize = size;
+	pthread_mutex_unlock(&style.lock);
+}
+
+#ifdef __linux__
+
+//the directory is watched rather than the file, a rename over the file replaces the inode
+static void* StyleThread(void* arg) {
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(fd < 0 || inotify_add_watch(fd, style.dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		TraceLog(LOG_WARNING, "Failed to watch `%s`, the style won't be reloaded", style.path);
+		if(fd >= 0) close(fd);
+		return NULL;
+	}
+
+	char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	struct pollfd p = { fd, POLLIN, 0 };
+	while(!ShouldQuit()) {
+		if(poll(&p, 1, STYLE_POLL_MS) <= 0) continue;
+		bool changed = false;
+		ssize_t n;
+		while((n = read(fd, buf, sizeof(buf))) > 0) {
+			for(char* at = buf; at < buf + n;) {
+				struct inotify_event* e = (struct inotify_event*)at;
+				if(e->len > 0 && strcmp(e->name, style.name) == 0) changed = true;
+				at += sizeof(struct inotify_event) + e->len;
+			}
+		}
+		if(changed) Publish();
+	}
+	close(fd);
+	return NULL;
+}
+
+#else
+
+static void* StyleThread(void* arg) {
+	struct stat last = {0}, now;
+	stat(style.path, &last);
+	while(!ShouldQuit()) {
+		usleep(STYLE_POLL_MS*1000);
+		if(stat(style.path, &now) != 0) continue;
+		if(now.st_mtime != last.st_mtime || now.st_size != last.st_size) {
+			last = now;
+			Publish();
+		}
+	}
+	return NULL;
+}
+
+#endif
+
+int StyleWatch(const char* path) {
+	StyleClose();
+	if(snprintf(style.path, sizeof(style.path), "%s", path) >= (int)sizeof(style.path)) return VEE_BAD_ARG;
+
+	int size = 0;
+	uint8_t* data = ReadStyleFile(path, &size);
+	if(data == NULL) return VEE_IO_ERROR;
+	bool valid = GuiLoadStyleFromMemory(data, size);
+	free(data);
+	if(!valid) return VEE_BAD_FORMAT;
+	TextCacheClear();
+
+	const char* slash = strrchr(style.path, '/');
+#ifdef _WIN32
+	const char* bslash = strrchr(style.path, '\\');
+	if(bslash != NULL && (slash == NULL || bslash > slash)) slash = bslash;
+#endif
+	if(slash == NULL) {
+		strcpy(style.dir, ".");
+		style.name = style.path;
+	} else {
+		snprintf(style.dir, sizeof(style.dir), "%.*s", (int)(slash - style.path), style.path);
+		if(slash == style.path) strcpy(style.dir, "/");
+		style.name = slash+1;
+	}
+
+	style.quit = false;
+	if(pthread_create(&style.thread, NULL, StyleThread, NULL) != 0) {
+		TraceLog(LOG_WARNING, "Failed to start the style watcher, `%s` won't be reloaded", path);
+		return VEE_OK;
+	}
+	style.running = true;
+	return VEE_OK;
+}
+
+bool StyleUpdate() {
+	if(!style.running) return false;
+	pthread_mutex_lock(&style.lock);
+	uint8_t* data = style.pending;
+	int size = style.pendingSize;
+	style.pending = NULL;
+	pthread_mutex_unlock(&style.lock);
+	if(data == NULL) return false;
+
+	PROFILE_ZONE("ReloadStyle");
+	bool valid = GuiLoadStyleFromMemory(data, size);
+	free(data);
+	if(!valid) return false;
+	//the font could be a new one that got the texture of the old one
+	TextCacheClear();
+	TraceLog(LOG_INFO, "Reloaded style `%s`", style.path);
+	return true;
+}
+
+void StyleClose() {
+	if(!style.running) return;
+	pthread_mutex_lock(&style.lock);
+	style.quit = true;
+	pthread_mutex_unlock(&style.lock);
+	pthread_join(style.thread, NULL);
+	style.running = false;
+
+	free(style.pending);
+	style.pending = NULL;
+}
@@ -0,0 +1,28 @@
+#ifndef GE_STYLE_H
+#define GE_STYLE_H
+
+#include "editor.h"
+
+/* STYLE RELOAD
+ * A raygui style file (.rgs) dropped on the editor is watched by a background thread: every
+ * time it's written again it's read back whole (one read, no parsing on that thread) and
+ * handed to the main thread, which applies it between two frames with StyleUpdate(). The
+ * preview changes as soon as the style editor saves, without restarting.
+ *
+ * The file is watched with inotify on Linux (its directory, so editors that save to a new
+ * file and rename it over the old one are caught too) and by polling its modification time
+ * and size every STYLE_POLL_MS elsewhere. A file that isn't a valid style (or is caught
+ * half written) leaves the current style as it is. */
+
+#define STYLE_POLL_MS 250
+
+/** Load the style at `path` and keep watching it, in place of the file watched before.
+ * Returns VEE_OK[0] on success. */
+extern int StyleWatch(const char* path);
+/** Apply the style file read since the last call, if any. Returns true when the style changed.
+ * Main thread only, the font of the style is loaded here. */
+extern bool StyleUpdate();
+/** Stop watching. The style stays loaded. */
+extern void StyleClose();
+
+#endif
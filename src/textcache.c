@@ -0,0 +1,278 @@
+#include "textcache.h"
+#include "../external/util.h"
+
+typedef struct {
+	uint16_t glyph;  //index in font.chars
+	float x, y;      //from the text position
+} TextGlyph;
+
+typedef struct {
+	uint64_t hash;
+	unsigned int texture;  //the font
+	const CharInfo* chars;
+	float fontSize, spacing;
+	int next;              //next entry of the same bucket, -1 at the end
+	int newer, older;      //recently used list, -1 at the ends
+	int length;            //-1 while the entry is free
+	char text[TEXT_CACHE_MAX_LENGTH+1];
+	int width;             //-1 until measured
+	int glyphCount;        //-1 until laid out
+	TextGlyph glyphs[TEXT_CACHE_MAX_LENGTH];
+} TextEntry;
+
+#define TEXT_CACHE_BUCKETS (TEXT_CACHE_SIZE*2) //power of 2
+
+static struct {
+	TextEntry entries[TEXT_CACHE_SIZE];
+	int buckets[TEXT_CACHE_BUCKETS];  //first entry of every bucket
+	int newest, oldest;
+	int used;
+	bool initialized;
+	TextCacheStats stats;
+
+	//glyph index of every character the layout knows about, for the font in `glyphFont`
+	unsigned int glyphFont;
+	const CharInfo* glyphChars;
+	uint16_t glyphIndex[256+64];
+} cache;
+
+void TextCacheClear() {
+	for(int i=0; i<TEXT_CACHE_BUCKETS; ++i) cache.buckets[i] = -1;
+	for(int i=0; i<TEXT_CACHE_SIZE; ++i) cache.entries[i].length = -1;
+	cache.newest = cache.oldest = -1;
+	cache.used = 0;
+	cache.glyphChars = NULL;
+	cache.initialized = true;
+}
+
+TextCacheStats TextCacheGetStats() {
+	return cache.stats;
+}
+
+static inline uint64_t Hash(Font font, const char* text, size_t length, float fontSize, float spacing) {
+	uint64_t h = fnv64_1a((char*)text, length);
+	h = (h ^ font.texture.id) * FNV64_PRIME;
+	h = (h ^ (uint64_t)(fontSize*64)) * FNV64_PRIME;
+	return (h ^ (uint64_t)(spacing*64)) * FNV64_PRIME;
+}
+
+static void Unlink(int i) {
+	TextEntry* e = &cache.entries[i];
+	if(e->newer != -1) cache.entries[e->newer].older = e->older;
+	else cache.newest = e->older;
+	if(e->older != -1) cache.entries[e->older].newer = e->newer;
+	else cache.oldest = e->newer;
+}
+
+static void PushNewest(int i) {
+	TextEntry* e = &cache.entries[i];
+	e->newer = -1;
+	e->older = cache.newest;
+	if(cache.newest != -1) cache.entries[cache.newest].newer = i;
+	cache.newest = i;
+	if(cache.oldest == -1) cache.oldest = i;
+}
+
+static void RemoveFromBucket(int i) {
+	int* link = &cache.buckets[cache.entries[i].hash & (TEXT_CACHE_BUCKETS-1)];
+	while(*link != i) link = &cache.entries[*link].next;
+	*link = cache.entries[i].next;
+}
+
+//The entry of `text`, added if it isn't there yet. NULL if the text is too long to be cached.
+static TextEntry* Find(Font font, const char* text, float fontSize, float spacing) {
+	if(!cache.initialized) TextCacheClear();
+	size_t length = strnlen(text, TEXT_CACHE_MAX_LENGTH+1);
+	if(length > TEXT_CACHE_MAX_LENGTH) {
+		++cache.stats.misses;
+		return NULL;
+	}
+
+	uint64_t hash = Hash(font, text, length, fontSize, spacing);
+	int* bucket = &cache.buckets[hash & (TEXT_CACHE_BUCKETS-1)];
+	for(int i = *bucket; i != -1; i = cache.entries[i].next) {
+		TextEntry* e = &cache.entries[i];
+		if(e->hash == hash && e->length == (int)length && e->texture == font.texture.id && e->chars == font.chars
+			&& e->fontSize == fontSize && e->spacing == spacing && memcmp(e->text, text, length) == 0) {
+			if(cache.newest != i) {
+				Unlink(i);
+				PushNewest(i);
+			}
+			++cache.stats.hits;
+			return e;
+		}
+	}
+
+	++cache.stats.misses;
+	int i;
+	if(cache.used < TEXT_CACHE_SIZE) i = cache.used++;
+	else {
+		i = cache.oldest;
+		Unlink(i);
+		RemoveFromBucket(i);
+		++cache.stats.evictions;
+	}
+	TextEntry* e = &cache.entries[i];
+	e->hash = hash;
+	e->texture = font.texture.id;
+	e->chars = font.chars;
+	e->fontSize = fontSize;
+	e->spacing = spacing;
+	e->length = length;
+	memcpy(e->text, text, length);
+	e->text[length] = '\0';
+	e->width = -1;
+	e->glyphCount = -1;
+	e->next = *bucket;
+	*bucket = i;
+	PushNewest(i);
+	return e;
+}
+
+int TextCacheWidth(Font font, const char* text, float fontSize, float spacing) {
+	TextEntry* e = Find(font, text, fontSize, spacing);
+	if(e == NULL) return (int)MeasureTextEx(font, text, fontSize, spacing).x;
+	if(e->width == -1) e->width = (int)MeasureTextEx(font, e->text, fontSize, spacing).x;
+	return e->width;
+}
+
+static inline uint16_t GlyphIndex(Font font, int c) {
+	if(cache.glyphFont != font.texture.id || cache.glyphChars != font.chars) {
+		for(int k=0; k<256+64; ++k) cache.glyphIndex[k] = GetGlyphIndex(font, k);
+		cache.glyphFont = font.texture.id;
+		cache.glyphChars = font.chars;
+	}
+	return cache.glyphIndex[c];
+}
+
+//where DrawTextEx() puts every glyph of `e`
+static void Layout(Font font, TextEntry* e) {
+	const float scale = e->fontSize/font.baseSize;
+	int x = 0, y = 0;
+	e->glyphCount = 0;
+	for(int i=0; i<e->length; ++i) {
+		unsigned char c = e->text[i];
+		if(c == '\n') {
+			y += (int)((font.baseSize + font.baseSize/2)*scale);
+			x = 0;
+			continue;
+		}
+		//two byte UTF-8 of the latin-1 characters, the only ones past ASCII raylib's fonts have
+		//(the text always ends with a '\0' that can take the place of the second byte)
+		int code = c;
+		if(c == 0xc2 || c == 0xc3) {
+			c = e->text[++i];
+			code = c + ((code == 0xc3) ? 64 : 0);
+		}
+		uint16_t g = GlyphIndex(font, code);
+		const CharInfo* info = &font.chars[g];
+		if(c != ' ') e->glyphs[e->glyphCount++] = (TextGlyph){ g, x + info->offsetX*scale, y + info->offsetY*scale };
+		if(info->advanceX == 0) x += (int)(info->rec.width*scale + e->spacing);
+		else x += (int)(info->advanceX*scale + e->spacing);
+	}
+}
+
+void TextCacheDraw(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color tint) {
+	TextEntry* e = Find(font, text, fontSize, spacing);
+	if(e == NULL) {
+		DrawTextEx(font, text, position, fontSize, spacing, tint);
+		return;
+	}
+	if(e->glyphCount == -1) Layout(font, e);
+	const float scale = fontSize/font.baseSize;
+	for(int i=0; i<e->glyphCount; ++i) {
+		TextGlyph g = e->glyphs[i];
+		Rectangle src = font.chars[g.glyph].rec;
+		Rectangle dst = { position.x + g.x, position.y + g.y, src.width*scale, src.height*scale };
+		DrawTexturePro(font.texture, src, dst, (Vector2){0, 0}, 0, tint);
+	}
+}
+
+
+// -------
+// SPLIT TEXT
+// -------
+
+typedef Array(char) ArrayChar;
+typedef Array(const char*) ArrayString;
+
+typedef struct {
+	const char* key;      //the text pointer, NULL while the entry is free
+	char delimiter;
+	size_t length;
+	uint32_t used;        //lookup it was last used by, the oldest one of a set is replaced
+	ArrayChar text;       //copy of the text, then another one with every delimiter replaced by '\0'
+	ArrayString elements; //into the second copy
+} TextSplit;
+
+static struct {
+	TextSplit entries[TEXT_SPLIT_SETS*TEXT_SPLIT_WAYS];
+	uint32_t lookups;
+} split;
+
+static inline size_t SplitSet(const char* text) {
+	//pointers are aligned, the high bits of the product are mixed the best
+	return ((uint64_t)(uintptr_t)text * 0x9e3779b97f4a7c15u >> 40) & (TEXT_SPLIT_SETS-1);
+}
+
+static int Split(TextSplit* e, const char* text, size_t length, char delimiter) {
+	e->elements.size = 0;
+	e->text.size = 0;
+	if(Array_reserve(&e->text, 2*(length+1)) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	char* copy = Array_data(&e->text);
+	memcpy(copy, text, length+1);
+	memcpy(copy + length+1, text, length+1);
+	e->text.size = 2*(length+1);
+	copy += length+1;
+	if(Array_push(&e->elements, copy) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	for(size_t i=0; i<length; ++i) {
+		if(copy[i] != delimiter) continue;
+		copy[i] = '\0';
+		if(Array_push(&e->elements, &copy[i+1]) != VEE_OK) return VEE_OUT_OF_MEMORY;
+	}
+	return VEE_OK;
+}
+
+const char** TextCacheSplit(const char* text, char delimiter, int* count) {
+	static const char* empty[1] = { "" };
+	size_t length = strlen(text);
+	TextSplit* set = &split.entries[SplitSet(text)*TEXT_SPLIT_WAYS];
+	++split.lookups;
+
+	//the entry of the pointer if it's there, the least recently used one of the set otherwise
+	TextSplit* e = &set[0];
+	for(int w=0; w<TEXT_SPLIT_WAYS; ++w) {
+		if(set[w].key == text) {
+			e = &set[w];
+			break;
+		}
+		if(set[w].key == NULL || (e->key != NULL && split.lookups - set[w].used > split.lookups - e->used)) e = &set[w];
+	}
+	e->used = split.lookups;
+	//the text behind a pointer can change (labels edited in place, TextFormat() buffers)
+	if(e->key == text && e->delimiter == delimiter && e->length == length && memcmp(Array_data(&e->text), text, length) == 0) {
+		++cache.stats.splitHits;
+		*count = Array_size(&e->elements);
+		return Array_data(&e->elements);
+	}
+
+	++cache.stats.splitMisses;
+	if(Split(e, text, length, delimiter) != VEE_OK) {
+		e->key = NULL;
+		*count = 1;
+		return empty;
+	}
+	e->key = text;
+	e->delimiter = delimiter;
+	e->length = length;
+	*count = Array_size(&e->elements);
+	return Array_data(&e->elements);
+}
+
+void TextCacheDestroy() {
+	for(size_t i=0; i<TEXT_SPLIT_SETS*TEXT_SPLIT_WAYS; ++i) {
+		Array_destroy(&split.entries[i].text);
+		Array_destroy(&split.entries[i].elements);
+		split.entries[i].key = NULL;
+	}
+}
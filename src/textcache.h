@@ -0,0 +1,47 @@
+#ifndef GE_TEXTCACHE_H
+#define GE_TEXTCACHE_H
+
+#include "editor.h"
+
+/* TEXT CACHE
+ * raygui measures and draws every label again every frame, and raylib looks up every glyph
+ * of it in the font on the way. The cache keeps the width and the laid out glyphs (where
+ * each glyph goes relative to the text position) of the last TEXT_CACHE_SIZE strings it saw,
+ * keyed by the text, the font, the size and the spacing. Drawing a cached string is one
+ * textured quad per glyph and nothing else. The least recently used string is dropped to
+ * make room for a new one.
+ *
+ * raygui's GuiTextWidth() and GuiDrawText() go through here when raygui is built with
+ * RAYGUI_TEXT_CACHE defined. Strings longer than TEXT_CACHE_MAX_LENGTH are measured and
+ * drawn by raylib directly. The layout is the same as the one of raylib's DrawTextEx().
+ *
+ * The element lists of ToggleGroup, ComboBox and DropdownBox ("one;two;three") are split
+ * once and kept apart from that, keyed by the text pointer. The text is compared with the
+ * copy kept with the split, so a label that changes in place is split again. A pointer goes in one of the TEXT_SPLIT_WAYS
+ * entries of its set, the least recently used one is replaced. */
+
+#define TEXT_CACHE_SIZE 512
+#define TEXT_CACHE_MAX_LENGTH 63
+#define TEXT_SPLIT_SETS 2048 //power of 2
+#define TEXT_SPLIT_WAYS 4
+
+typedef struct {
+	uint64_t hits, misses, evictions;
+	uint64_t splitHits, splitMisses;
+} TextCacheStats;
+
+/** Same as (int)MeasureTextEx().x */
+extern int TextCacheWidth(Font font, const char* text, float fontSize, float spacing);
+/** Same as DrawTextEx() */
+extern void TextCacheDraw(Font font, const char* text, Vector2 position, float fontSize, float spacing, Color tint);
+/** The `delimiter` separated elements of `text` (at least one), each one its own string. `count`
+ * gets the number of elements. The array stays valid until `text` is split again after it changed
+ * or another text takes its place in the cache, use it right away. */
+extern const char** TextCacheSplit(const char* text, char delimiter, int* count);
+extern TextCacheStats TextCacheGetStats();
+/** Forget every string, needed when a font is unloaded and another one could get its texture.
+ * The split texts are kept (their memory is released by TextCacheDestroy()). */
+extern void TextCacheClear();
+extern void TextCacheDestroy();
+
+#endif
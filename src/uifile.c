@@ -0,0 +1,280 @@
+#include "uifile.h"
+#include <math.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define UIF_USE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define UIF_LEGACY_HEADER_SIZE 7
+#define UIF_LEGACY_RECORD_SIZE 20
+
+// -------
+// WRITING
+// -------
+
+int WriteUIFile(const char* file, const ArrayWidget* w, const uint32_t* depth, const char* strings, size_t stringsSize) {
+	size_t count = Array_size(w);
+	if(file == NULL || count > UINT32_MAX || stringsSize > UINT32_MAX) return VEE_BAD_ARG;
+
+	//encode everything in memory first so the file gets written in one go
+	size_t payload = count*UIF_RECORD_SIZE + stringsSize;
+	uint8_t* buf = calloc(UIF_HEADER_SIZE + payload, 1);
+	if(buf == NULL) return VEE_OUT_OF_MEMORY;
+
+	uint8_t* p = buf + UIF_HEADER_SIZE;
+	for(ArrayIt i=0; i<count; ++i, p += UIF_RECORD_SIZE) {
+		Widget wi = Array_at(w, i);
+		put_u16le(p, wi.type);
+		put_u16le(p+2, wi.props.set);
+		put_u32le(p+4, wi.id);
+		put_u32le(p+8, (depth != NULL) ? depth[i] : i);
+		put_f32le(p+12, wi.bounds.x);
+		put_f32le(p+16, wi.bounds.y);
+		put_f32le(p+20, wi.bounds.width);
+		put_f32le(p+24, wi.bounds.height);
+		PutWidgetProps(p+28, wi.props);
+	}
+	if(stringsSize != 0) memcpy(p, strings, stringsSize);
+
+	memcpy(buf, UIF_MAGIC, 4);
+	put_u16le(buf+4, UIF_VERSION);
+	put_u16le(buf+6, 0);
+	put_u32le(buf+8, count);
+	put_u32le(buf+12, UIF_RECORD_SIZE);
+	put_u32le(buf+16, stringsSize);
+	put_u32le(buf+20, fnv32_1a((char*)buf + UIF_HEADER_SIZE, payload));
+
+	int r = VEE_IO_ERROR;
+	FILE* f = fopen(file, "wb");
+	if(f != NULL) {
+		size_t written = fwrite(buf, 1, UIF_HEADER_SIZE + payload, f);
+		if(fclose(f) == 0 && written == UIF_HEADER_SIZE + payload) r = VEE_OK;
+	}
+	free(buf);
+	return r;
+}
+
+
+// -------
+// READING
+// -------
+
+typedef struct {
+	const uint8_t* data;
+	size_t size;
+	bool mapped;
+} MappedFile;
+
+static int MapFile(const char* file, MappedFile* m) {
+	*m = (MappedFile){0};
+#ifdef UIF_USE_MMAP
+	int fd = open(file, O_RDONLY);
+	if(fd < 0) return VEE_IO_ERROR;
+	struct stat st;
+	if(fstat(fd, &st) != 0) {
+		close(fd);
+		return VEE_IO_ERROR;
+	}
+	if(st.st_size == 0) {
+		close(fd);
+		return VEE_BAD_FORMAT;
+	}
+	void* data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd); //the mapping keeps the file alive
+	if(data == MAP_FAILED) return VEE_IO_ERROR;
+	madvise(data, st.st_size, MADV_SEQUENTIAL);
+
+	m->data = data;
+	m->size = st.st_size;
+	m->mapped = true;
+	return VEE_OK;
+#else
+	//no mmap, read the whole file with a single call instead
+	FILE* f = fopen(file, "rb");
+	if(f == NULL) return VEE_IO_ERROR;
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if(size <= 0) { fclose(f); return VEE_BAD_FORMAT; }
+
+	uint8_t* data = malloc(size);
+	if(data == NULL) { fclose(f); return VEE_OUT_OF_MEMORY; }
+	if(fread(data, 1, size, f) != (size_t)size) {
+		free(data); fclose(f);
+		return VEE_IO_ERROR;
+	}
+	fclose(f);
+
+	m->data = data;
+	m->size = size;
+	return VEE_OK;
+#endif
+}
+
+static void UnmapFile(MappedFile* m) {
+#ifdef UIF_USE_MMAP
+	if(m->mapped) munmap((void*)m->data, m->size);
+#else
+	free((void*)m->data);
+#endif
+	*m = (MappedFile){0};
+}
+
+bool WidgetPropsValid(WidgetProps props, const StringTable* t) {
+	if(props.set & ~PROP_ALL) return false;
+	if((props.set & PROP_RANGE) && (!isfinite(props.min) || !isfinite(props.max))) return false;
+	if((props.set & PROP_VALUE) && !isfinite(props.value)) return false;
+	if(t == NULL) return true;
+	return (!(props.set & PROP_TEXT) || StringValid(t, props.text)) && (!(props.set & PROP_ITEMS) || StringValid(t, props.items));
+}
+
+typedef enum {
+	LAYOUT_LEGACY = 0,  //u32 type, bounds
+	LAYOUT_V1,          //u16 type, u16 flags, bounds
+	LAYOUT_V2,          //u16 type, u16 flags, u32 id, u32 depth, bounds
+	LAYOUT_V3,          //same as V2 with the property flags and the properties after it
+} RecordLayout;
+
+//The properties of record `rec` with their strings moved to where `map` put them.
+//The fields of the properties that aren't set are cleared.
+static bool DecodeProps(const uint8_t* rec, const ArrayStringRemap* map, bool strings, WidgetProps* props) {
+	uint16_t set = get_u16le(rec+2);
+	WidgetProps p = GetWidgetProps(rec + UIF_V2_RECORD_SIZE, set);
+	if(!WidgetPropsValid(p, NULL)) return false;
+	//without a table to add them to the strings are dropped
+	if(!strings) p.set &= ~(PROP_TEXT | PROP_ITEMS);
+	if(!(p.set & PROP_TEXT)) p.text = 0;
+	else if(p.text != 0 && !StringRemapFind(map, p.text, &p.text)) return false;
+	if(!(p.set & PROP_ITEMS)) p.items = 0;
+	else if(p.items != 0 && !StringRemapFind(map, p.items, &p.items)) return false;
+	if(!(p.set & PROP_RANGE)) p.min = p.max = 0;
+	if(!(p.set & PROP_VALUE)) p.value = 0;
+	if(!(p.set & PROP_COLOR)) p.color = (Color){0};
+	*props = p;
+	return true;
+}
+
+//Make room for `count` widgets at `p` and decode the records straight into the array.
+//Undoes the insert if a record turns out to be invalid.
+static int DecodeRecords(const uint8_t* rec, size_t recordSize, size_t count, ArrayWidget* w, ArrayIt p,
+	ArrayDepthRank* depth, RecordLayout layout, const ArrayStringRemap* map, bool strings)
+{
+	if(count == 0) return 0;
+	if(count > INT32_MAX) return VEE_BAD_FORMAT;
+	//the depth ranks must be a permutation of 0..count-1
+	const bool ranked = layout >= LAYOUT_V2;
+	uint8_t* seen = ranked ? calloc((count+7)/8, 1) : NULL;
+	if(ranked && seen == NULL) return VEE_OUT_OF_MEMORY;
+	if(depth != NULL) depth->size = 0;
+
+	//the size is known up front, no need to round it up
+	int r = Array_reserve_exact(w, Array_size(w) + count);
+	if(r == VEE_OK && depth != NULL) r = Array_reserve_exact(depth, count);
+	if(r == VEE_OK) r = array_insert__((Array*)w, p, sizeof(Widget), count);
+	if(r != VEE_OK) {
+		free(seen);
+		return r;
+	}
+
+	const size_t at = ranked ? 12 : 4;
+	Widget* out = &Array_at(w, p);
+	for(size_t i=0; i<count; ++i, rec += recordSize) {
+		uint32_t type = (layout == LAYOUT_LEGACY) ? get_u32le(rec) : get_u16le(rec);
+		uint32_t id = ranked ? get_u32le(rec+4) : i;
+		uint32_t rank = ranked ? get_u32le(rec+8) : i;
+		Rectangle b = { get_f32le(rec+at), get_f32le(rec+at+4), get_f32le(rec+at+8), get_f32le(rec+at+12) };
+		WidgetProps props = {0};
+		bool badRank = false, badProps = layout == LAYOUT_V3 && !DecodeProps(rec, map, strings, &props);
+		if(ranked) {
+			badRank = rank >= count || (seen[rank/8] & (1 << rank%8));
+			if(!badRank) seen[rank/8] |= 1 << rank%8;
+		}
+		if(type >= WIDGET_COUNT || id > INT32_MAX || badRank || badProps ||
+			!isfinite(b.x) || !isfinite(b.y) || !isfinite(b.width) || !isfinite(b.height)) 
+		{
+			Array_remove(w, p, count);
+			free(seen);
+			if(depth != NULL) depth->size = 0;
+			return VEE_BAD_FORMAT;
+		}
+		out[i] = (Widget){ type, b, id, props };
+		if(depth != NULL) Array_at(depth, i) = rank;
+	}
+	if(depth != NULL) depth->size = count;
+	free(seen);
+	return count;
+}
+
+int DecodeUIFile(const uint8_t* data, size_t size, ArrayWidget* w, ArrayIt p, ArrayDepthRank* depth, StringTable* strings) {
+	if(size >= UIF_HEADER_SIZE && memcmp(data, UIF_MAGIC, 4) == 0) {
+		static const size_t recordSizes[] = { [LAYOUT_V1] = UIF_V1_RECORD_SIZE, [LAYOUT_V2] = UIF_V2_RECORD_SIZE, [LAYOUT_V3] = UIF_RECORD_SIZE };
+		uint16_t version = get_u16le(data+4);
+		uint32_t count = get_u32le(data+8);
+		uint32_t recordSize = get_u32le(data+12);
+		uint32_t stringsSize = get_u32le(data+16);
+		uint32_t checksum = get_u32le(data+20);
+		RecordLayout layout = (version >= 3) ? LAYOUT_V3 : (version == 2) ? LAYOUT_V2 : LAYOUT_V1;
+		if(version == 0 || version > UIF_VERSION) return VEE_BAD_FORMAT;
+		//every version was only ever written with its own record size, and the header isn't covered
+		//by the checksum: a flipped version or record size mustn't pass as another layout
+		if(recordSize != recordSizes[layout]) return VEE_BAD_FORMAT;
+		//unused header fields are not covered by the checksum so they must be zero
+		if(get_u16le(data+6) != 0 || get_u32le(data+24) != 0 || get_u32le(data+28) != 0) return VEE_BAD_FORMAT;
+
+		//reject truncated files and files with trailing garbage
+		uint64_t payload = (uint64_t)count*recordSize + stringsSize;
+		if(payload != size - UIF_HEADER_SIZE) return VEE_BAD_FORMAT;
+		if(fnv32_1a((char*)data + UIF_HEADER_SIZE, payload) != checksum) return VEE_BAD_FORMAT;
+		//the string table must end with the terminator of its last string
+		if(stringsSize != 0 && data[size-1] != '\0') return VEE_BAD_FORMAT;
+
+		ArrayStringRemap map = {0};
+		if(strings != NULL && layout == LAYOUT_V3) {
+			int r = StringTableLoad(strings, (const char*)data + size - stringsSize, stringsSize, &map);
+			if(r < 0) {
+				Array_destroy(&map);
+				return r;
+			}
+		}
+		int r = DecodeRecords(data + UIF_HEADER_SIZE, recordSize, count, w, p, depth, layout, &map, strings != NULL);
+		Array_destroy(&map);
+		return r;
+	}
+
+	if(size >= UIF_LEGACY_HEADER_SIZE && memcmp(data, "UIF", 3) == 0) {
+		//old editors dumped the native structs, these were always written on little-endian machines
+		uint32_t count = get_u32le(data+3);
+		if((uint64_t)count*UIF_LEGACY_RECORD_SIZE != size - UIF_LEGACY_HEADER_SIZE) return VEE_BAD_FORMAT;
+		return DecodeRecords(data + UIF_LEGACY_HEADER_SIZE, UIF_LEGACY_RECORD_SIZE, count, w, p, depth, LAYOUT_LEGACY, NULL, false);
+	}
+
+	return VEE_BAD_FORMAT;
+}
+
+int ReadUIFile(const char* file, ArrayWidget* w, ArrayIt p, ArrayDepthRank* depth, StringTable* strings) {
+	if(file == NULL || w == NULL || p > Array_size(w)) return VEE_BAD_ARG;
+
+	MappedFile m;
+	int r = MapFile(file, &m);
+	if(r != VEE_OK) return r;
+
+	r = DecodeUIFile(m.data, m.size, w, p, depth, strings);
+	UnmapFile(&m);
+	return r;
+}
+
+int ReadUIFileChecksum(const char* file, uint32_t* checksum) {
+	if(file == NULL || checksum == NULL) return VEE_BAD_ARG;
+	FILE* f = fopen(file, "rb");
+	if(f == NULL) return VEE_IO_ERROR;
+	uint8_t header[UIF_HEADER_SIZE];
+	size_t n = fread(header, 1, sizeof(header), f);
+	fclose(f);
+	if(n != sizeof(header) || memcmp(header, UIF_MAGIC, 4) != 0) return VEE_BAD_FORMAT;
+	*checksum = get_u32le(header+20);
+	return VEE_OK;
+}
@@ -0,0 +1,86 @@
+#ifndef GE_UIFILE_H
+#define GE_UIFILE_H
+
+#include "editor.h"
+#include "depth.h"
+
+/* BINARY `*.ui` FILE LAYOUT (version 3)
+ * All the fields are little-endian and have a fixed width.
+ *
+ *   offset  size  field
+ *        0     4  magic "UIFB"
+ *        4     2  version
+ *        6     2  flags (unused, 0)
+ *        8     4  widget count
+ *       12     4  widget record size in bytes (the one of the version)
+ *       16     4  string table size in bytes
+ *       20     4  checksum (fnv32-1a over everything after the header)
+ *       24     8  reserved (0)
+ *       32        widget records
+ *                 string table (optional, NUL terminated strings, see stringtable.h)
+ *
+ * A widget record is:
+ *        0     2  type
+ *        2     2  properties that are set (WidgetProp flags)
+ *        4     4  widget id
+ *        8     4  depth rank (0 is drawn first, a permutation of 0..count-1)
+ *       12    16  bounds x, y, width, height as IEEE-754 floats
+ *       28    24  properties, see PutWidgetProps()
+ *
+ * The strings of the properties are offsets in the string table, where a string starts.
+ * A property that isn't set is 0. Version 2 records end at offset 28 and have no properties,
+ * version 1 records also have no id and depth (the bounds are at offset 4), the widgets get
+ * their position in the file as both. Files written by older editors ("UIF" + native int
+ * count + raw `Widget` dumps) are still accepted when loading. */
+
+#define UIF_MAGIC "UIFB"
+#define UIF_VERSION 3
+#define UIF_HEADER_SIZE 32
+#define UIF_RECORD_SIZE 52
+#define UIF_V2_RECORD_SIZE 28
+#define UIF_V1_RECORD_SIZE 20
+#define UIF_PROPS_SIZE 24
+
+/** The properties of a widget but their flags as UIF_PROPS_SIZE bytes: text and items
+ * string handles, min, max and value as floats and the color as r, g, b, a. The `.ui` files,
+ * the journal and the input traces all store them like this. */
+static inline void PutWidgetProps(uint8_t* p, WidgetProps props) {
+	put_u32le(p, props.text);
+	put_u32le(p+4, props.items);
+	put_f32le(p+8, props.min);
+	put_f32le(p+12, props.max);
+	put_f32le(p+16, props.value);
+	p[20] = props.color.r; p[21] = props.color.g; p[22] = props.color.b; p[23] = props.color.a;
+}
+
+static inline WidgetProps GetWidgetProps(const uint8_t* p, uint16_t set) {
+	return (WidgetProps){ get_u32le(p), get_u32le(p+4), get_f32le(p+8), get_f32le(p+12), get_f32le(p+16),
+		{ p[20], p[21], p[22], p[23] }, set };
+}
+
+/** True when only known properties are set, their numbers are finite and their strings are
+ * handles of `t` (not checked when NULL). */
+extern bool WidgetPropsValid(WidgetProps props, const StringTable* t);
+
+/** Writes the widgets from `w` to `file` together with their depth ranks `depth` (NULL if
+ * the array is in draw order) and the string table `strings` of `stringsSize` bytes their
+ * properties refer to (can be NULL/0 when they have no strings). Returns VEE_OK[0] on success. */
+extern int WriteUIFile(const char* file, const ArrayWidget* w, const uint32_t* depth, 
+	const char* strings, size_t stringsSize);
+
+/** Decodes all the widgets from `file` and inserts them into `w` before position `p`. The depth
+ * ranks of the loaded widgets are stored in `depth` if it's not NULL. The strings of the file
+ * are added to `strings` and the properties refer to them there, when `strings` is NULL the
+ * widgets lose their text and items.
+ * On success returns the number of widgets loaded, otherwise a negative VEE_* error code
+ * and `w` is left untouched (`strings` can have the strings of the file). */
+extern int ReadUIFile(const char* file, ArrayWidget* w, ArrayIt p, ArrayDepthRank* depth, StringTable* strings);
+
+/** Same as ReadUIFile() but for the `size` bytes of a file at `data`, already in memory. */
+extern int DecodeUIFile(const uint8_t* data, size_t size, ArrayWidget* w, ArrayIt p, ArrayDepthRank* depth, StringTable* strings);
+
+/** Reads only the header of `file` and stores its checksum in `checksum`. 
+ * Returns VEE_OK[0] on success. */
+extern int ReadUIFileChecksum(const char* file, uint32_t* checksum);
+
+#endif
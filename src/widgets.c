@@ -0,0 +1,171 @@
+#include "widgets.h"
+#include "textcache.h"
+#include "../external/raygui.h"
+
+char* WidgetName[] = {
+	"WindowBox",
+	"GroupBox",
+	"Line",
+	"Panel",
+	"ScrollPanel",
+	"Label",
+	"Button",
+	"LabelButton",
+	"ImageButton",
+	"Toggle",
+	"ToggleGroup",
+	"CheckBox",
+	"ComboBox",
+	"DropdownBox",
+	"Spinner",
+	"ValueBox",
+	"TextBox",
+	"TextBoxMulti",
+	"Slider",
+	"SliderBar",
+	"ProgressBar",
+	"StatusBar",
+	"Dummy",
+	"ListView",
+	"ColorPicker",
+	"MessageBox",
+	//newer/experimental controls in raygui!?
+	"ColorPanel",
+	"ColorBarAlpha",
+	"ColorBarHue",
+	"Grid"
+};
+
+// -------
+// PREVIEW
+// -------
+
+static void PreviewWindowBox(Widget w, const WidgetValues* v) { GuiWindowBox(w.bounds, v->text); }
+static void PreviewGroupBox(Widget w, const WidgetValues* v) { GuiGroupBox(w.bounds, v->text); }
+static void PreviewLine(Widget w, const WidgetValues* v) { GuiLine(w.bounds, 1); }
+static void PreviewPanel(Widget w, const WidgetValues* v) { GuiPanel(w.bounds); }
+static void PreviewScrollPanel(Widget w, const WidgetValues* v) {
+	GuiScrollPanel(w.bounds,(Rectangle){0,0,0,0},(Vector2){0,0});
+}
+static void PreviewLabel(Widget w, const WidgetValues* v) { GuiLabelEx(w.bounds, v->text, 0, 4); }
+static void PreviewButton(Widget w, const WidgetValues* v) { GuiButton(w.bounds, v->text); }
+static void PreviewLabelButton(Widget w, const WidgetValues* v) { GuiLabelButton(w.bounds, v->text); }
+static void PreviewImageButton(Widget w, const WidgetValues* v) {
+	GuiImageButtonEx(w.bounds, texture, (Rectangle){0,0,20,20}, v->text);
+}
+static void PreviewToggle(Widget w, const WidgetValues* v) { GuiToggle(w.bounds, v->text, v->value != 0); }
+static void PreviewToggleGroup(Widget w, const WidgetValues* v) { GuiToggleGroupEx(w.bounds, v->items, v->value, 4, 1); }
+static void PreviewCheckBox(Widget w, const WidgetValues* v) { GuiCheckBox(w.bounds, v->text, v->value != 0); }
+static void PreviewComboBox(Widget w, const WidgetValues* v) { GuiComboBox(w.bounds, v->items, v->value); }
+static void PreviewDropdownBox(Widget w, const WidgetValues* v) {
+	int active = v->value;
+	GuiDropdownBox(w.bounds, v->items, &active, false);
+}
+static void PreviewSpinner(Widget w, const WidgetValues* v) {
+	int value = v->value;
+	GuiSpinner(w.bounds,&value,v->min,v->max,20,true);
+}
+static void PreviewValueBox(Widget w, const WidgetValues* v) {
+	int value = v->value;
+	GuiValueBox(w.bounds,&value,v->min,v->max,true);
+}
+//the controls are locked while the preview is drawn, the text is never changed
+static void PreviewTextBox(Widget w, const WidgetValues* v) { GuiTextBox(w.bounds, (char*)v->text, 32, true); }
+static void PreviewTextBoxMulti(Widget w, const WidgetValues* v) { GuiTextBoxMulti(w.bounds, (char*)v->text, 32, true); }
+static void PreviewSlider(Widget w, const WidgetValues* v) { GuiSliderEx(w.bounds, v->text, v->value, v->min, v->max, true); }
+static void PreviewSliderBar(Widget w, const WidgetValues* v) { GuiSliderBarEx(w.bounds, v->text, v->value, v->min, v->max, true); }
+static void PreviewProgressBar(Widget w, const WidgetValues* v) { GuiProgressBarEx(w.bounds, v->value, v->min, v->max, true); }
+static void PreviewStatusBar(Widget w, const WidgetValues* v) { GuiStatusBar(w.bounds, v->text, 4); }
+static void PreviewDummy(Widget w, const WidgetValues* v) { GuiDummyRec(w.bounds, v->text); }
+static void PreviewListView(Widget w, const WidgetValues* v) {
+	int scroll = 0, active = v->value, count;
+	const char** entries = TextCacheSplit(v->items, ';', &count);
+	GuiListViewEx(w.bounds, entries, NULL, count, &scroll, &active, NULL, true);
+}
+static void PreviewColorPicker(Widget w, const WidgetValues* v) { GuiColorPicker(w.bounds, v->color); }
+static void PreviewMessageBox(Widget w, const WidgetValues* v) { GuiMessageBox(w.bounds, v->text, v->items); }
+//NEWER CONTROLS IN RAYGUI?
+static void PreviewColorPanel(Widget w, const WidgetValues* v) { GuiColorPanel(w.bounds, v->color); }
+static void PreviewColorBarAlpha(Widget w, const WidgetValues* v) { GuiColorBarAlpha(w.bounds, v->value); }
+static void PreviewColorBarHue(Widget w, const WidgetValues* v) { GuiColorBarHue(w.bounds, v->value); }
+static void PreviewGrid(Widget w, const WidgetValues* v) { GuiGrid(w.bounds, 10, 1); }
+
+
+// -------
+// DESCRIPTORS
+// -------
+
+//flat colors of the zoomed out view, one per kind of control
+#define LOD_CONTAINER (Color){ 230, 230, 230, 255 }
+#define LOD_TEXT      (Color){ 180, 180, 180, 255 }
+#define LOD_BUTTON    (Color){ 201, 239, 254, 255 }
+#define LOD_INPUT     (Color){ 210, 210, 210, 255 }
+#define LOD_VALUE     (Color){ 151, 232, 255, 255 }
+
+//defaults of the types that have a value
+#define PERCENT(v) { NULL, 0.f, 100.f, v }
+#define ACTIVE(v)  { NULL, 0.f, 0.f, v }
+
+const WidgetDesc WidgetDescs[WIDGET_COUNT] = {
+	[WIDGET_WindowBox] = { "GuiWindowBox($B, $L)", PreviewWindowBox, LOD_CONTAINER,
+		"GuiWindowBox(b, $L)", NULL, NULL, PROP_TEXT },
+	[WIDGET_GroupBox] = { "GuiGroupBox($B, $L)", PreviewGroupBox, LOD_CONTAINER,
+		"GuiGroupBox(b, $L)", NULL, NULL, PROP_TEXT },
+	[WIDGET_Line] = { "GuiLine($B, 1)", PreviewLine, LOD_TEXT,
+		"GuiLine(b, 1)", NULL, NULL, 0 },
+	[WIDGET_Panel] = { "GuiPanel($B)", PreviewPanel, LOD_CONTAINER,
+		"GuiPanel(b)", NULL, NULL, 0 },
+	[WIDGET_ScrollPanel] = { "static Vector2 scroll$I = { 0, 0 };\nscroll$I = GuiScrollPanel($B, $C, scroll$I)", PreviewScrollPanel, LOD_CONTAINER,
+		"s->scroll = GuiScrollPanel(b, s->content, s->scroll);\ninner.x += s->scroll.x; inner.y += s->scroll.y", "Vector2 scroll; Rectangle content;", "{ { 0, 0 }, { 0, 0, $W, $H } }", 0 },
+	[WIDGET_Label] = { "GuiLabelEx($B, $L, 0, 4)", PreviewLabel, LOD_TEXT,
+		"GuiLabelEx(b, $L, 0, 4)", NULL, NULL, PROP_TEXT },
+	[WIDGET_Button] = { "GuiButton($B, $L)", PreviewButton, LOD_BUTTON,
+		"GuiButton(b, $L)", NULL, NULL, PROP_TEXT },
+	[WIDGET_LabelButton] = { "GuiLabelButton($B, $L)", PreviewLabelButton, LOD_TEXT,
+		"GuiLabelButton(b, $L)", NULL, NULL, PROP_TEXT },
+	[WIDGET_ImageButton] = { "GuiImageButtonEx($B, (Texture){0}, (Rectangle){0,0,20,20}, $L)", PreviewImageButton, LOD_BUTTON,
+		"GuiImageButtonEx(b, (Texture){0}, (Rectangle){0,0,20,20}, $L)", NULL, NULL, PROP_TEXT },
+	[WIDGET_Toggle] = { "GuiToggle($B, $L, $v)", PreviewToggle, LOD_BUTTON,
+		"s->active = GuiToggle(b, $L, s->active)", "bool active;", "{ $v }", PROP_TEXT | PROP_VALUE, ACTIVE(1) },
+	[WIDGET_ToggleGroup] = { "GuiToggleGroupEx($B, $E, $v, 4, 1)", PreviewToggleGroup, LOD_BUTTON,
+		"s->active = GuiToggleGroupEx(b, $E, s->active, 4, 1)", "int active;", "{ $v }", PROP_ITEMS | PROP_VALUE, ACTIVE(1) },
+	[WIDGET_CheckBox] = { "GuiCheckBox($B, $L, $v)", PreviewCheckBox, LOD_BUTTON,
+		"s->checked = GuiCheckBox(b, $L, s->checked)", "bool checked;", "{ $v }", PROP_TEXT | PROP_VALUE, ACTIVE(1) },
+	[WIDGET_ComboBox] = { "GuiComboBox($B, $E, $v)", PreviewComboBox, LOD_BUTTON,
+		"s->active = GuiComboBox(b, $E, s->active)", "int active;", "{ $v }", PROP_ITEMS | PROP_VALUE, ACTIVE(0) },
+	[WIDGET_DropdownBox] = { "GuiDropdownBox($B, $E, &(int){$v}, false)", PreviewDropdownBox, LOD_BUTTON,
+		"if(GuiDropdownBox(b, $E, &s->active, s->edit)) s->edit = !s->edit", "int active; bool edit;", "{ $v, false }", PROP_ITEMS | PROP_VALUE, ACTIVE(0) },
+	[WIDGET_Spinner] = { "GuiSpinner($B,&(int){$v}, $n, $x, 20, true)", PreviewSpinner, LOD_BUTTON,
+		"if(GuiSpinner(b, &s->value, $n, $x, 20, s->edit)) s->edit = !s->edit", "int value; bool edit;", "{ $v, false }", PROP_RANGE | PROP_VALUE, PERCENT(30) },
+	[WIDGET_ValueBox] = { "GuiValueBox($B,&(int){$v}, $n, $x, true)", PreviewValueBox, LOD_INPUT,
+		"if(GuiValueBox(b, &s->value, $n, $x, s->edit)) s->edit = !s->edit", "int value; bool edit;", "{ $v, false }", PROP_RANGE | PROP_VALUE, PERCENT(80) },
+	[WIDGET_TextBox] = { "GuiTextBox($B, (char*)&(char[$S]){$L}, $S, true)", PreviewTextBox, LOD_INPUT,
+		"if(GuiTextBox(b, s->text, $S, s->edit)) s->edit = !s->edit", "char text[$S]; bool edit;", "{ $L, false }", PROP_TEXT },
+	[WIDGET_TextBoxMulti] = { "GuiTextBoxMulti($B, (char*)&(char[$S]){$L}, $S, true)", PreviewTextBoxMulti, LOD_INPUT,
+		"if(GuiTextBoxMulti(b, s->text, $S, s->edit)) s->edit = !s->edit", "char text[$S]; bool edit;", "{ $L, false }", PROP_TEXT },
+	[WIDGET_Slider] = { "GuiSliderEx($B, $L, $V, $N, $X, true)", PreviewSlider, LOD_VALUE,
+		"s->value = GuiSliderEx(b, $L, s->value, $N, $X, true)", "float value;", "{ $V }", PROP_TEXT | PROP_RANGE | PROP_VALUE, PERCENT(70) },
+	[WIDGET_SliderBar] = { "GuiSliderBarEx($B, $L, $V, $N, $X, true)", PreviewSliderBar, LOD_VALUE,
+		"s->value = GuiSliderBarEx(b, $L, s->value, $N, $X, true)", "float value;", "{ $V }", PROP_TEXT | PROP_RANGE | PROP_VALUE, PERCENT(70) },
+	[WIDGET_ProgressBar] = { "GuiProgressBarEx($B, $V, $N, $X, true)", PreviewProgressBar, LOD_VALUE,
+		"GuiProgressBarEx(b, s->value, $N, $X, true)", "float value;", "{ $V }", PROP_RANGE | PROP_VALUE, PERCENT(40) },
+	[WIDGET_StatusBar] = { "GuiStatusBar($B, $L, 4)", PreviewStatusBar, LOD_TEXT,
+		"GuiStatusBar(b, $L, 4)", NULL, NULL, PROP_TEXT },
+	[WIDGET_Dummy] = { "GuiDummyRec($B, $L)", PreviewDummy, LOD_TEXT,
+		"GuiDummyRec(b, $L)", NULL, NULL, PROP_TEXT },
+	[WIDGET_ListView] = { "GuiListViewEx($B, $A, NULL, $#, &(int){0}, &(int){$v}, NULL, true)", PreviewListView, LOD_INPUT,
+		"GuiListViewEx(b, $A, NULL, $#, &s->scroll, &s->active, NULL, true)", "int scroll, active;", "{ 0, $v }", PROP_ITEMS | PROP_VALUE, 
+		{ "ItemA;ItemB", 0.f, 0.f, 0 } },
+	[WIDGET_ColorPicker] = { "GuiColorPicker($B, $K)", PreviewColorPicker, LOD_VALUE,
+		"s->color = GuiColorPicker(b, s->color)", "Color color;", "{ { $k } }", PROP_COLOR, { .color = DARKBLUE } },
+	[WIDGET_MessageBox] = { "GuiMessageBox($B, $L, $E)", PreviewMessageBox, LOD_CONTAINER,
+		"GuiMessageBox(b, $L, $E)", NULL, NULL, PROP_TEXT | PROP_ITEMS, { "Hi, how are you today?" } },
+	[WIDGET_ColorPanel] = { "GuiColorPanel($B, $K)", PreviewColorPanel, LOD_VALUE,
+		"s->color = GuiColorPanel(b, s->color)", "Color color;", "{ { $k } }", PROP_COLOR, { .color = GOLD } },
+	[WIDGET_ColorBarAlpha] = { "GuiColorBarAlpha($B, $V)", PreviewColorBarAlpha, LOD_VALUE,
+		"s->alpha = GuiColorBarAlpha(b, s->alpha)", "float alpha;", "{ $V }", PROP_VALUE, { NULL, 0.f, 1.f, 0.3f } },
+	[WIDGET_ColorBarHue] = { "GuiColorBarHue($B, $V)", PreviewColorBarHue, LOD_VALUE,
+		"s->hue = GuiColorBarHue(b, s->hue)", "float hue;", "{ $V }", PROP_VALUE, { NULL, 0.f, 360.f, 0.2f } },
+	[WIDGET_Grid] = { "GuiGrid($B, 10, 1)", PreviewGrid, LOD_TEXT,
+		"GuiGrid(b, 10, 1)", NULL, NULL, 0 },
+};
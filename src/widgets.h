@@ -0,0 +1,81 @@
+#ifndef GE_WIDGETS_H
+#define GE_WIDGETS_H
+
+#include "editor.h"
+
+/* Everything the editor knows about a widget type. The same table is used to draw
+ * the preview in the editor and to generate the C code on export, both from the properties
+ * of the widget (see WidgetProps in editor.h) and the defaults of its type for the ones that
+ * aren't set.
+ *
+ * `code` is the exported call, these are substituted when generating:
+ *   $B  the bounds as a `(Rectangle){x,y,width,height}` literal, from the container
+ *       the widget is in (see hierarchy.h)
+ *   $C  a `(Rectangle){0,0,width,height}` literal holding the widget and the widgets inside it
+ *   $W  the width of that rectangle, $H its height
+ *   $I  the widget id
+ *   $L  the text as a string literal
+ *   $E  the items as a string literal ("one;two;three")
+ *   $A  the items as a `(const char*[]){...}` array of string literals, $# the number of items
+ *   $V  the value as a float literal, $v as an int
+ *   $N  the min as a float literal, $n as an int, $X and $x the same for the max
+ *   $K  the color as a `(Color){r,g,b,a}` literal, $k only the `r,g,b,a`
+ *   $S  the size of a text box buffer for the text, at least 32
+ *   $$  a single `$`
+ * A template can have several statements, the last one without the `;`.
+ *
+ * `table` is the same call for the table driven export (CODE_TABLES in codegen.h), it's
+ * written once per type in the dispatch loop. The widget is drawn at `b`, the properties
+ * stand for the columns of its row (`$L` is `layoutText[layoutLabel[i]]` and so on) and `s`
+ * points to its `state` (the members of a struct, NULL when it has none) which starts out
+ * as `stateInit`. `$S` is the same for every widget of the layout there. `stateInit` is expanded for every widget like `code`. A container sets
+ * `inner` to where the widgets inside it are placed from, it's the top-left corner of `b`
+ * to begin with.
+ *
+ * `props` are the properties the type shows, the others are neither drawn nor exported. */
+
+//the properties of a widget with the defaults of its type for the ones it doesn't set
+typedef struct {
+	const char* text;
+	const char* items;
+	float min, max, value;
+	Color color;
+} WidgetValues;
+
+//the properties of the type when a widget doesn't set them, the text is the label
+//made of the type name and the widget id
+typedef struct {
+	const char* items; //NULL for the text
+	float min, max, value;
+	Color color;
+} WidgetDefaults;
+
+typedef struct {
+	const char* code;
+	void (*draw)(Widget w, const WidgetValues* v);
+	Color lod; //drawn instead when the view is zoomed out too far to read the controls
+	const char* table;
+	const char* state;
+	const char* stateInit;
+	uint16_t props; //WidgetProp flags
+	WidgetDefaults defaults;
+} WidgetDesc;
+
+extern const WidgetDesc WidgetDescs[WIDGET_COUNT];
+
+/** The properties of `w` with its strings from `t`, `label` is the text when it sets none.
+ * The strings are only good until the next one is added to `t`. */
+static inline WidgetValues WidgetValuesOf(Widget w, const StringTable* t, const char* label) {
+	const WidgetDefaults* d = &WidgetDescs[w.type].defaults;
+	const WidgetProps* p = &w.props;
+	WidgetValues v;
+	v.text = (p->set & PROP_TEXT) ? StringTableGet(t, p->text) : label;
+	v.items = (p->set & PROP_ITEMS) ? StringTableGet(t, p->items) : (d->items != NULL) ? d->items : v.text;
+	v.min = (p->set & PROP_RANGE) ? p->min : d->min;
+	v.max = (p->set & PROP_RANGE) ? p->max : d->max;
+	v.value = (p->set & PROP_VALUE) ? p->value : d->value;
+	v.color = (p->set & PROP_COLOR) ? p->color : d->color;
+	return v;
+}
+
+#endif